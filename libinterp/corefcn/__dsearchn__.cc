@@ -27,9 +27,11 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
 #include <cmath>
-
+#include <limits>
 #include <string>
+#include <vector>
 
 #include "defun.h"
 #include "error.h"
@@ -37,6 +39,196 @@
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+// Distance from the point Y to the point YI, both of dimension M.
+
+static inline double
+point_dist (const double *y, const double *yi, octave_idx_type m)
+{
+  double dd = 0.0;
+  for (octave_idx_type k = 0; k < m; k++)
+    {
+      double yd = y[k] - yi[k];
+      dd += yd * yd;
+    }
+  return sqrt (dd);
+}
+
+// A k-d tree over the columns of an N x NX matrix of points.
+//
+// Each node splits its points at the median of the coordinate with the
+// largest spread.  The points of each leaf are copied next to each other
+// so that a leaf is scanned contiguously.  Queries return the same
+// point as a search over all points would, including the lowest index
+// among points at the same distance, so the tree only prunes subtrees
+// that are certainly farther away than the current best point.  Queries
+// do not allocate or modify the tree, so several can run at once.
+
+class kdtree
+{
+public:
+
+  // Largest dimension the tree is used for.  Beyond this, few subtrees
+  // can be pruned and scanning all points is about as fast.
+  static const octave_idx_type max_dim = 16;
+
+  kdtree (const double *x, octave_idx_type n, octave_idx_type nx)
+    : m_n (n), m_idx (nx), m_pts (n * nx), m_nodes ()
+  {
+    for (octave_idx_type j = 0; j < nx; j++)
+      m_idx[j] = j;
+
+    m_nodes.reserve (2 * (nx / leaf_size + 1));
+
+    build (x, 0, nx);
+
+    for (octave_idx_type j = 0; j < nx; j++)
+      std::copy_n (x + m_n * m_idx[j], m_n, m_pts.begin () + m_n * j);
+  }
+
+  OCTAVE_DISABLE_COPY_MOVE (kdtree)
+
+  ~kdtree () = default;
+
+  // Find the point closest to XI.  Return its index and set D to its
+  // distance.
+
+  octave_idx_type nearest (const double *xi, double& d) const
+  {
+    double off[max_dim];
+    std::fill_n (off, m_n, 0.0);
+
+    octave_idx_type j = 0;
+    d = std::numeric_limits<double>::infinity ();
+
+    search (0, xi, off, j, d);
+
+    return j;
+  }
+
+private:
+
+  static const octave_idx_type leaf_size = 8;
+
+  struct node
+  {
+    // Points M_IDX[LO] to M_IDX[HI-1] are below this node.
+    octave_idx_type lo, hi;
+
+    // Children, or -1 for a leaf.
+    octave_idx_type left, right;
+
+    octave_idx_type dim;
+    double split;
+  };
+
+  octave_idx_type build (const double *x, octave_idx_type lo,
+                         octave_idx_type hi)
+  {
+    octave_idx_type k = m_nodes.size ();
+    m_nodes.push_back (node {lo, hi, -1, -1, 0, 0.0});
+
+    if (hi - lo <= leaf_size)
+      return k;
+
+    octave_idx_type dim = 0;
+    double spread = 0.0;
+    for (octave_idx_type i = 0; i < m_n; i++)
+      {
+        double lb = x[m_n * m_idx[lo] + i];
+        double ub = lb;
+        for (octave_idx_type j = lo + 1; j < hi; j++)
+          {
+            double t = x[m_n * m_idx[j] + i];
+            lb = std::min (lb, t);
+            ub = std::max (ub, t);
+          }
+        if (ub - lb > spread)
+          {
+            spread = ub - lb;
+            dim = i;
+          }
+      }
+
+    // All points are equal.
+    if (spread == 0.0)
+      return k;
+
+    octave_idx_type mid = lo + (hi - lo) / 2;
+    octave_idx_type n = m_n;
+    std::nth_element (m_idx.begin () + lo, m_idx.begin () + mid,
+                      m_idx.begin () + hi,
+                      [=] (octave_idx_type a, octave_idx_type b)
+                      { return x[n * a + dim] < x[n * b + dim]; });
+
+    m_nodes[k].dim = dim;
+    m_nodes[k].split = x[m_n * m_idx[mid] + dim];
+
+    octave_idx_type left = build (x, lo, mid);
+    octave_idx_type right = build (x, mid, hi);
+
+    m_nodes[k].left = left;
+    m_nodes[k].right = right;
+
+    return k;
+  }
+
+  // OFF holds the distance from XI to the region of node K along each
+  // coordinate.
+
+  void search (octave_idx_type k, const double *xi, double *off,
+               octave_idx_type& jbest, double& dbest) const
+  {
+    const node& nd = m_nodes[k];
+
+    if (nd.left < 0)
+      {
+        const double *px = m_pts.data () + m_n * nd.lo;
+        for (octave_idx_type i = nd.lo; i < nd.hi; i++, px += m_n)
+          {
+            double d = point_dist (px, xi, m_n);
+            octave_idx_type j = m_idx[i];
+            if (d < dbest || (d == dbest && j < jbest))
+              {
+                dbest = d;
+                jbest = j;
+              }
+          }
+        return;
+      }
+
+    double diff = xi[nd.dim] - nd.split;
+
+    octave_idx_type near = (diff < 0 ? nd.left : nd.right);
+    octave_idx_type far = (diff < 0 ? nd.right : nd.left);
+
+    search (near, xi, off, jbest, dbest);
+
+    double old = off[nd.dim];
+    off[nd.dim] = diff;
+
+    double rd = 0.0;
+    for (octave_idx_type i = 0; i < m_n; i++)
+      rd += off[i] * off[i];
+
+    // Keep a margin for rounding so that points at exactly the best
+    // distance are still visited.
+    if (rd <= dbest * dbest * (1 + 1e-12))
+      search (far, xi, off, jbest, dbest);
+
+    off[nd.dim] = old;
+  }
+
+  octave_idx_type m_n;
+
+  // Index of the points in tree order.
+  std::vector<octave_idx_type> m_idx;
+
+  // Coordinates of the points in tree order.
+  std::vector<double> m_pts;
+
+  std::vector<node> m_nodes;
+};
+
 DEFUN (__dsearchn__, args, ,
        doc: /* -*- texinfo -*-
 @deftypefn {} {[@var{idx}, @var{d}] =} dsearch (@var{x}, @var{xi})
@@ -61,27 +253,51 @@ Undocumented internal function.
   ColumnVector dist (nxi);
   double *pdist = dist.fortran_vec ();
 
-#define DIST(dd, y, yi, m)                      \
-  dd = 0.0;                                     \
-  for (octave_idx_type k = 0; k < m; k++)       \
-    {                                           \
-      double yd = y[k] - yi[k];                 \
-      dd += yd * yd;                            \
-    }                                           \
-  dd = sqrt (dd)
-
+  const double *px = x.data ();
   const double *pxi = xi.data ();
+
+  // Use a tree if there are enough points and queries to pay for
+  // building it.  Points that are not finite have no place in the tree
+  // and may tie with everything, so leave them to the full search.
+  bool use_tree = (n <= kdtree::max_dim && nx >= 64 && nxi >= 16
+                   && ! x.any_element_is_inf_or_nan ()
+                   && ! xi.any_element_is_inf_or_nan ());
+
+  if (use_tree)
+    {
+      // The tree is built anew for each call; it is not kept for later
+      // searches of the same points.
+      kdtree tree (px, n, nx);
+
+      // Queries are answered in blocks, checking for interrupts between
+      // them, and the queries of a block are spread across threads.
+      static const octave_idx_type block = 4096;
+
+      for (octave_idx_type i0 = 0; i0 < nxi; i0 += block)
+        {
+          octave_idx_type i1 = std::min (i0 + block, nxi);
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp parallel for
+#endif
+          for (octave_idx_type i = i0; i < i1; i++)
+            pidx[i] = tree.nearest (pxi + n*i, pdist[i]) + 1;
+
+          octave_quit ();
+        }
+
+      return ovl (idx, dist);
+    }
+
   for (octave_idx_type i = 0; i < nxi; i++)
     {
-      double d0;
-      const double *px = x.data ();
-      DIST(d0, px, pxi, n);
+      const double *py = px;
+      double d0 = point_dist (py, pxi, n);
       *pidx = 1.;
       for (octave_idx_type j = 1; j < nx; j++)
         {
-          px += n;
-          double d;
-          DIST (d, px, pxi, n);
+          py += n;
+          double d = point_dist (py, pxi, n);
           if (d < d0)
             {
               d0 = d;
@@ -99,8 +315,26 @@ Undocumented internal function.
 }
 
 /*
-## No test needed for internal helper function.
-%!assert (1)
+## The tree must find the same points as the search over all points
+%!test
+%! x = rand (500, 3);
+%! xi = rand (200, 3);
+%! xi(1:10,:) = x(1:10,:);
+%! [idx, d] = __dsearchn__ (x, xi);
+%! [dmin, imin] = min (sqrt (sum ((permute (x, [3, 2, 1])
+%!                                 - xi) .^ 2, 2)), [], 3);
+%! assert (idx, imin);
+%! assert (d, dmin, 1e-14);
+%! assert (d(1:10), zeros (10, 1));
+
+## Ties go to the lowest index
+%!test
+%! [gx, gy] = meshgrid (0:9);
+%! x = [gx(:), gy(:); gx(:), gy(:)];
+%! xi = [gx(:) + 0.5, gy(:)];
+%! [idx, d] = __dsearchn__ (x, xi);
+%! assert (idx, (1:100)');
+%! assert (d, 0.5 * ones (100, 1));
 */
 
 OCTAVE_END_NAMESPACE(octave)
@@ -27,7 +27,13 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <vector>
+
 #include "lo-ieee.h"
+#include "lo-mappers.h"
 #include "dNDArray.h"
 #include "oct-locbuf.h"
 
@@ -49,105 +55,146 @@ isvector (const T& array)
   return dv.ndims () == 2 && (dv(0) == 1 || dv(1) == 1);
 }
 
-// lookup a value in a sorted table (lookup.m)
+// A grid vector of lin_interpn, with the cell lookup used for it.
+
 template <typename T>
-octave_idx_type
-lookup (const T *x, octave_idx_type n, T y)
+class interp_axis
 {
-  octave_idx_type j;
+public:
 
-  if (x[0] < x[n-1])
-    {
-      // increasing x
+  interp_axis (const T *x, octave_idx_type n)
+    : m_x (x), m_n (n), m_sign (n > 1 && x[n-1] < x[0] ? -1 : 1),
+      m_uniform (false), m_x0 (0), m_inv_h (0)
+  {
+    if (m_n < 2)
+      return;
 
-      if (y > x[n-1] || y < x[0])
-        return -1;
+    m_x0 = m_sign * m_x[0];
+    T h = (m_sign * m_x[m_n-1] - m_x0) / (m_n - 1);
 
-#if defined (EXHAUSTIF)
-      for (j = 0; j < n - 1; j++)
-        {
-          if (x[j] <= y && y <= x[j+1])
-            return j;
-        }
-#else
-      octave_idx_type j0 = 0;
-      octave_idx_type j1 = n - 1;
+    if (! (h > 0) || ! math::isfinite (h))
+      return;
 
-      while (true)
-        {
-          j = (j0+j1)/2;
+    // Accept the grid as uniform if each point is within a small
+    // fraction of the spacing from where it should be.  The cell
+    // found from the spacing is corrected afterwards, so this only
+    // affects the speed and not the result.
 
-          if (y <= x[j+1])
-            {
-              if (x[j] <= y)
-                return j;
+    T tol = h / 64;
 
-              j1 = j;
-            }
+    for (octave_idx_type j = 1; j < m_n - 1; j++)
+      if (std::abs (m_sign * m_x[j] - (m_x0 + j * h)) > tol)
+        return;
 
-          if (x[j] <= y)
-            j0 = j;
-        }
-#endif
-    }
-  else
-    {
-      // decreasing x
-      // previous code with x -> -x and y -> -y
+    m_uniform = true;
+    m_inv_h = 1 / h;
+  }
 
-      if (y > x[0] || y < x[n-1])
-        return -1;
+  // Return the index J of the cell [X(J), X(J+1)] containing Y, or -1
+  // if Y is outside the grid.  Y is in the last cell whose first point
+  // does not lie beyond it.  HINT is the cell of the previous point,
+  // which is checked first so that sorted points are found by walking
+  // along the grid.
 
-#if defined (EXHAUSTIF)
-      for (j = 0; j < n - 1; j++)
-        {
-          if (x[j+1] <= y && y <= x[j])
-            return j;
-        }
-#else
-      octave_idx_type j0 = 0;
-      octave_idx_type j1 = n - 1;
+  octave_idx_type find (T y, octave_idx_type hint) const
+  {
+    T z = m_sign * y;
 
-      while (true)
-        {
-          j = (j0+j1)/2;
+    if (m_n < 2 || ! (z >= xs (0) && z <= xs (m_n-1)))
+      return -1;
 
-          if (y >= x[j+1])
-            {
-              if (x[j] >= y)
-                return j;
+    octave_idx_type j;
 
-              j1 = j;
-            }
+    if (m_uniform)
+      {
+        T t = (z - m_x0) * m_inv_h;
+        j = (t < m_n - 1 ? static_cast<octave_idx_type> (t) : m_n - 2);
+      }
+    else if (hint >= 0 && xs (hint) <= z)
+      {
+        j = hint;
 
-          if (x[j] >= y)
-            j0 = j;
-        }
-#endif
-    }
-}
+        for (int k = 0; k < 8 && j < m_n - 2 && xs (j+1) <= z; k++)
+          j++;
+      }
+    else
+      j = bisect (z, 0);
+
+    while (j > 0 && xs (j) > z)
+      j--;
+
+    if (j < m_n - 2 && xs (j+1) <= z)
+      j = bisect (z, j);
+
+    return j;
+  }
+
+  T operator () (octave_idx_type j) const { return m_x[j]; }
+
+private:
+
+  T xs (octave_idx_type j) const { return m_sign * m_x[j]; }
+
+  // Last J >= J0 with XS(J) <= Z, but at most M_N-2.
+
+  octave_idx_type bisect (T z, octave_idx_type j0) const
+  {
+    octave_idx_type j1 = m_n - 1;
+
+    while (j1 - j0 > 1)
+      {
+        octave_idx_type j = j0 + (j1 - j0) / 2;
 
-// n-dimensional linear interpolation
+        if (xs (j) <= z)
+          j0 = j;
+        else
+          j1 = j;
+      }
+
+    return j0;
+  }
+
+  const T *m_x;
+  octave_idx_type m_n;
+  T m_sign;
+  bool m_uniform;
+  T m_x0;
+  T m_inv_h;
+};
+
+// n-dimensional linear interpolation of the points M0 to M1-1.
 
 template <typename T, typename DT>
-void
-lin_interpn (int n, const octave_idx_type *size, const octave_idx_type *scale,
-             octave_idx_type Ni, DT extrapval, const T **x,
+static void
+lin_interpn (int n, const interp_axis<T> *axes, const octave_idx_type *scale,
+             octave_idx_type m0, octave_idx_type m1, DT extrapval,
              const DT *v, const T **y, DT *vi)
 {
-  bool out = false;
-  int bit;
-
   OCTAVE_LOCAL_BUFFER (T, coef, 2*n);
-  OCTAVE_LOCAL_BUFFER (octave_idx_type, index, n);
+  OCTAVE_LOCAL_BUFFER_INIT (octave_idx_type, index, n, -1);
+
+  // offset in memory of each corner of a cell from its first corner
+  int ncorners = 1 << n;
+  OCTAVE_LOCAL_BUFFER (octave_idx_type, offset, ncorners);
+
+  for (int i = 0; i < ncorners; i++)
+    {
+      offset[i] = 0;
+      for (int j = 0; j < n; j++)
+        if (i >> j & 1)
+          offset[i] += scale[j];
+    }
 
   // loop over all points
-  for (octave_idx_type m = 0; m < Ni; m++)
+  for (octave_idx_type m = m0; m < m1; m++)
     {
+      bool out = false;
+      octave_idx_type l0 = 0;
+
       // loop over all dimensions
       for (int i = 0; i < n; i++)
         {
-          index[i] = lookup (x[i], size[i], y[i][m]);
+          index[i] = axes[i].find (y[i][m], index[i]);
           out = index[i] == -1;
 
           if (out)
@@ -155,8 +202,10 @@ lin_interpn (int n, const octave_idx_type *size, const octave_idx_type *scale,
           else
             {
               octave_idx_type j = index[i];
-              coef[2*i+1] = (y[i][m] - x[i][j])/(x[i][j+1] - x[i][j]);
+              const interp_axis<T>& x = axes[i];
+              coef[2*i+1] = (y[i][m] - x(j))/(x(j+1) - x(j));
               coef[2*i] = 1 - coef[2*i+1];
+              l0 += scale[i] * j;
             }
         }
 
@@ -167,21 +216,15 @@ lin_interpn (int n, const octave_idx_type *size, const octave_idx_type *scale,
           vi[m] = 0;
 
           // loop over all corners of hypercube (1<<n = 2^n)
-          for (int i = 0; i < (1 << n); i++)
+          for (int i = 0; i < ncorners; i++)
             {
               T c = 1;
-              octave_idx_type l = 0;
 
               // loop over all dimensions
               for (int j = 0; j < n; j++)
-                {
-                  // test if the jth bit in i is set
-                  bit = i >> j & 1;
-                  l += scale[j] * (index[j] + bit);
-                  c *= coef[2*j+bit];
-                }
-
-              vi[m] += c * v[l];
+                c *= coef[2*j + (i >> j & 1)];
+
+              vi[m] += c * v[l0 + offset[i]];
             }
         }
     }
@@ -249,7 +292,46 @@ lin_interpn (int n, MT *X, const DMT V, MT *Y, DT extrapval)
       x[i] = X[i].data ();
     }
 
-  lin_interpn (n, size, scale, Ni, extrapval, x, v, y, vi);
+  std::vector<interp_axis<T>> axes;
+  axes.reserve (n);
+
+  for (int i = 0; i < n; i++)
+    axes.push_back (interp_axis<T> (x[i], size[i]));
+
+  octave_idx_type ntasks = 1;
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+  ntasks = std::min (Ni / 16384 + 1, static_cast<octave_idx_type> (1024));
+#endif
+
+  if (ntasks <= 1)
+    lin_interpn (n, axes.data (), scale, 0, Ni, extrapval, v, y, vi);
+  else
+    {
+      std::exception_ptr err;
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp parallel for schedule (dynamic)
+#endif
+      for (octave_idx_type t = 0; t < ntasks; t++)
+        {
+          try
+            {
+              lin_interpn (n, axes.data (), scale, (Ni * t) / ntasks,
+                           (Ni * (t + 1)) / ntasks, extrapval, v, y, vi);
+            }
+          catch (...)
+            {
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp critical (lin_interpn)
+#endif
+              err = std::current_exception ();
+            }
+        }
+
+      if (err)
+        std::rethrow_exception (err);
+    }
 
   retval = Vi;
 
@@ -354,6 +436,29 @@ Undocumented internal function.
 %! vi_imag = __lin_interpn__ (x1, x2, imag (v), XI1, XI2);
 %! assert (real (vi_complex), vi_real);
 %! assert (imag (vi_complex), vi_imag);
+
+## Uniform, non-uniform and decreasing grids
+%!test
+%! x1 = 0:0.1:2;
+%! x2 = [0 1 3 7 8];
+%! v = 2*x1(:) + 3*x2;
+%! [y1, y2] = ndgrid ([0.05, 1.23, 2, 0, -1, NaN, 0.3], [0.5, 7.9, 3, 9]);
+%! vi = __lin_interpn__ (x1, x2, v, y1, y2);
+%! ref = 2*y1 + 3*y2;
+%! ref(! (y1 >= 0 & y1 <= 2 & y2 >= 0 & y2 <= 8)) = NA;
+%! assert (vi, ref, 1e-13);
+%! assert (__lin_interpn__ (fliplr (x1), x2, flipud (v), y1, y2), vi, 1e-13);
+%! assert (__lin_interpn__ (x1, fliplr (x2), fliplr (v), y1, y2), vi, 1e-13);
+
+## Sorted and unsorted points
+%!test
+%! x = ((0:20).^2 / 200)';
+%! v = sin (x);
+%! y = linspace (0, 2, 1001)';
+%! vi = __lin_interpn__ (x, v, y);
+%! assert (vi, interp1 (x, v, y), 4*eps);
+%! p = randperm (numel (y));
+%! assert (__lin_interpn__ (x, v, y(p)), vi(p));
 */
 
 OCTAVE_END_NAMESPACE(octave)
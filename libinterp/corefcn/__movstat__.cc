@@ -0,0 +1,594 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "dNDArray.h"
+#include "fNDArray.h"
+#include "lo-ieee.h"
+#include "lo-mappers.h"
+
+#include "defun.h"
+#include "error.h"
+#include "ovl.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Moving window statistics computed in a single pass over the data.
+//
+// The window for output I covers the elements I-NB, ..., I+NA of the
+// column.  Since both ends of the window only move forward, each
+// statistic is updated by adding the elements that enter the window
+// and removing those that leave it.  Elements outside of the column
+// are given by the endpoint rule, except for "shrink", which leaves
+// them out of the window.
+
+enum movstat_endpoints
+{
+  movstat_shrink,
+  movstat_discard,
+  movstat_fill,
+  movstat_same,
+  movstat_periodic
+};
+
+// Sum of finite values with Neumaier's compensated summation, which
+// limits the error accumulated over many additions and removals.
+
+class movstat_kahan_sum
+{
+public:
+
+  void add (double v)
+  {
+    double t = m_sum + v;
+
+    if (std::abs (m_sum) >= std::abs (v))
+      m_comp += (m_sum - t) + v;
+    else
+      m_comp += (v - t) + m_sum;
+
+    m_sum = t;
+  }
+
+  double value () const { return m_sum + m_comp; }
+
+  void reset ()
+  {
+    m_sum = 0;
+    m_comp = 0;
+  }
+
+private:
+
+  double m_sum = 0;
+  double m_comp = 0;
+};
+
+// Sum or mean, counting NaN and infinite elements separately so that
+// they can be removed again.
+
+class movstat_sum
+{
+public:
+
+  static const bool inexact = true;
+
+  movstat_sum (bool mean) : m_mean (mean) { }
+
+  void add (octave_idx_type, double v)
+  {
+    m_n++;
+
+    if (math::isnan (v))
+      m_nnan++;
+    else if (math::isinf (v))
+      (v > 0 ? m_npinf : m_nninf)++;
+    else
+      m_sum.add (v);
+  }
+
+  void remove (octave_idx_type, double v)
+  {
+    m_n--;
+
+    if (math::isnan (v))
+      m_nnan--;
+    else if (math::isinf (v))
+      (v > 0 ? m_npinf : m_nninf)--;
+    else
+      m_sum.add (-v);
+  }
+
+  double value () const
+  {
+    double sum;
+
+    if (m_nnan > 0 || (m_npinf > 0 && m_nninf > 0))
+      sum = numeric_limits<double>::NaN ();
+    else if (m_npinf > 0)
+      sum = numeric_limits<double>::Inf ();
+    else if (m_nninf > 0)
+      sum = -numeric_limits<double>::Inf ();
+    else
+      sum = m_sum.value ();
+
+    return m_mean ? sum / m_n : sum;
+  }
+
+private:
+
+  bool m_mean;
+
+  octave_idx_type m_n = 0;
+  octave_idx_type m_nnan = 0;
+  octave_idx_type m_npinf = 0;
+  octave_idx_type m_nninf = 0;
+
+  movstat_kahan_sum m_sum;
+};
+
+// Variance or standard deviation, from the sums of the deviations of
+// the elements from a shift and of their squares.  The shift is the
+// first element that entered the window, which avoids most of the
+// cancellation for data with a large mean and makes the result exact
+// for windows of equal elements.  The result is NaN if any element in
+// the window is not finite.
+
+class movstat_var
+{
+public:
+
+  static const bool inexact = true;
+
+  movstat_var (int opt, bool std) : m_opt (opt), m_std (std) { }
+
+  void add (octave_idx_type, double v)
+  {
+    if (! math::isfinite (v))
+      m_nonfinite++;
+    else
+      {
+        if (m_n == 0)
+          m_shift = v;
+
+        m_n++;
+
+        double d = v - m_shift;
+        m_sum.add (d);
+        m_sumsq.add (d * d);
+      }
+  }
+
+  void remove (octave_idx_type, double v)
+  {
+    if (! math::isfinite (v))
+      m_nonfinite--;
+    else if (--m_n == 0)
+      {
+        m_sum.reset ();
+        m_sumsq.reset ();
+      }
+    else
+      {
+        double d = v - m_shift;
+        m_sum.add (-d);
+        m_sumsq.add (-(d * d));
+      }
+  }
+
+  double value () const
+  {
+    if (m_nonfinite > 0)
+      return numeric_limits<double>::NaN ();
+
+    if (m_n == 1)
+      return 0;
+
+    double sum = m_sum.value ();
+    double m2 = std::max (m_sumsq.value () - sum * sum / m_n, 0.0);
+
+    double var = m2 / (m_opt == 0 ? m_n - 1 : m_n);
+
+    return m_std ? std::sqrt (var) : var;
+  }
+
+private:
+
+  int m_opt;
+  bool m_std;
+
+  octave_idx_type m_n = 0;
+  octave_idx_type m_nonfinite = 0;
+
+  double m_shift = 0;
+
+  movstat_kahan_sum m_sum;
+  movstat_kahan_sum m_sumsq;
+};
+
+// Minimum or maximum, ignoring NaN values like min and max do.  The
+// deque holds the elements of the window that may still become the
+// extremum, ordered by position and by value.
+
+template <typename T>
+class movstat_minmax
+{
+public:
+
+  static const bool inexact = false;
+
+  movstat_minmax (bool max) : m_max (max) { }
+
+  void add (octave_idx_type k, T v)
+  {
+    if (math::isnan (v))
+      return;
+
+    while (! m_deque.empty ()
+           && (m_max ? m_deque.back ().second <= v
+                     : m_deque.back ().second >= v))
+      m_deque.pop_back ();
+
+    m_deque.emplace_back (k, v);
+  }
+
+  void remove (octave_idx_type k, T)
+  {
+    if (! m_deque.empty () && m_deque.front ().first == k)
+      m_deque.pop_front ();
+  }
+
+  T value () const
+  {
+    return (m_deque.empty () ? numeric_limits<T>::NaN ()
+                             : m_deque.front ().second);
+  }
+
+private:
+
+  bool m_max;
+
+  std::deque<std::pair<octave_idx_type, T>> m_deque;
+};
+
+// Median, from the largest element of the lower half and the smallest
+// element of the upper half of the sorted window.  The lower half has
+// the same number of elements as the upper half, or one more.  The
+// result is NaN if any element in the window is NaN.
+
+template <typename T>
+class movstat_median
+{
+public:
+
+  static const bool inexact = false;
+
+  void add (octave_idx_type, T v)
+  {
+    if (math::isnan (v))
+      m_nnan++;
+    else
+      {
+        if (m_lo.empty () || v <= *m_lo.rbegin ())
+          m_lo.insert (v);
+        else
+          m_hi.insert (v);
+
+        balance ();
+      }
+  }
+
+  void remove (octave_idx_type, T v)
+  {
+    if (math::isnan (v))
+      m_nnan--;
+    else
+      {
+        // An element equal to the largest of the lower half may have
+        // been stored in either half, and removing it from the lower
+        // half is equivalent.
+
+        if (v <= *m_lo.rbegin ())
+          m_lo.erase (m_lo.find (v));
+        else
+          m_hi.erase (m_hi.find (v));
+
+        balance ();
+      }
+  }
+
+  T value () const
+  {
+    if (m_nnan > 0 || m_lo.empty ())
+      return numeric_limits<T>::NaN ();
+
+    T m = *m_lo.rbegin ();
+
+    if (m_lo.size () > m_hi.size ())
+      return m;
+
+    return (m + *m_hi.begin ()) / 2;
+  }
+
+private:
+
+  void balance ()
+  {
+    if (m_lo.size () > m_hi.size () + 1)
+      {
+        auto p = std::prev (m_lo.end ());
+        m_hi.insert (*p);
+        m_lo.erase (p);
+      }
+    else if (m_hi.size () > m_lo.size ())
+      {
+        auto p = m_hi.begin ();
+        m_lo.insert (*p);
+        m_hi.erase (p);
+      }
+  }
+
+  octave_idx_type m_nnan = 0;
+
+  std::multiset<T> m_lo;
+  std::multiset<T> m_hi;
+};
+
+// Compute the statistic ACC for each window of the column X with N
+// elements and store the results in Y.  Statistics that are updated
+// with rounding errors are computed again from the elements of the
+// window after every NB+NA+1 outputs, so that the errors don't
+// accumulate along the column.
+
+template <typename T, typename ACC>
+static void
+movstat_column (const ACC& init, const T *x, T *y, octave_idx_type n,
+                octave_idx_type nb, octave_idx_type na,
+                movstat_endpoints endpoints, T fill)
+{
+  // Element K of the column, extended at both ends.
+
+  auto elem = [=] (octave_idx_type k) -> T
+  {
+    if (k >= 0 && k < n)
+      return x[k];
+
+    switch (endpoints)
+      {
+      case movstat_same:
+        return k < 0 ? x[0] : x[n-1];
+
+      case movstat_periodic:
+        k %= n;
+        return x[k < 0 ? k + n : k];
+
+      default:
+        return fill;
+      }
+  };
+
+  octave_idx_type first = 0;
+  octave_idx_type last = n;
+
+  if (endpoints == movstat_discard)
+    {
+      first = nb;
+      last = n - na;
+    }
+
+  // Range of the elements that may be in a window.
+
+  octave_idx_type kmin = first - nb;
+  octave_idx_type kmax = last - 1 + na;
+
+  if (endpoints == movstat_shrink)
+    {
+      kmin = 0;
+      kmax = n - 1;
+    }
+
+  octave_idx_type wlen = nb + na + 1;
+
+  ACC acc = init;
+
+  octave_idx_type lo = kmin;
+  octave_idx_type hi = kmin;
+
+  for (octave_idx_type i = first; i < last; i++)
+    {
+      if (ACC::inexact && i > first && (i - first) % wlen == 0)
+        {
+          acc = init;
+          lo = hi = std::max (kmin, i - nb);
+        }
+
+      for (; hi <= std::min (kmax, i + na); hi++)
+        acc.add (hi, elem (hi));
+
+      for (; lo < i - nb; lo++)
+        acc.remove (lo, elem (lo));
+
+      *y++ = acc.value ();
+    }
+}
+
+template <typename NDA>
+static NDA
+movstat (const std::string& op, const NDA& x, octave_idx_type nb,
+         octave_idx_type na, movstat_endpoints endpoints,
+         typename NDA::element_type fill)
+{
+  typedef typename NDA::element_type T;
+
+  octave_idx_type n = x.rows ();
+  octave_idx_type ncols = x.columns ();
+
+  octave_idx_type nout = n;
+
+  if (endpoints == movstat_discard)
+    nout = std::max (n - nb - na, static_cast<octave_idx_type> (0));
+
+  NDA retval (dim_vector (nout, ncols));
+
+  const T *px = x.data ();
+  T *py = retval.fortran_vec ();
+
+  for (octave_idx_type j = 0; j < ncols; j++)
+    {
+      const T *xj = px + j*n;
+      T *yj = py + j*nout;
+
+      if (op == "sum" || op == "mean")
+        movstat_column (movstat_sum (op == "mean"), xj, yj, n, nb, na,
+                        endpoints, fill);
+      else if (op == "var" || op == "std")
+        movstat_column (movstat_var (0, op == "std"), xj, yj, n, nb, na,
+                        endpoints, fill);
+      else if (op == "var1" || op == "std1")
+        movstat_column (movstat_var (1, op == "std1"), xj, yj, n, nb, na,
+                        endpoints, fill);
+      else if (op == "min" || op == "max")
+        movstat_column (movstat_minmax<T> (op == "max"), xj, yj, n, nb, na,
+                        endpoints, fill);
+      else
+        movstat_column (movstat_median<T> (), xj, yj, n, nb, na,
+                        endpoints, fill);
+
+      octave_quit ();
+    }
+
+  return retval;
+}
+
+DEFUN (__movstat__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{y} =} __movstat__ (@var{op}, @var{x}, @var{nb}, @var{na}, @var{endpoints})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 5)
+    print_usage ();
+
+  std::string op = args(0).xstring_value ("__movstat__: OP must be a string");
+
+  static const char *ops[] = { "sum", "mean", "var", "var1", "std", "std1",
+                               "min", "max", "median" };
+
+  if (std::find (std::begin (ops), std::end (ops), op) == std::end (ops))
+    error ("__movstat__: unknown OP '%s'", op.c_str ());
+
+  octave_value x = args(1);
+
+  if (! x.isfloat () || x.iscomplex () || x.issparse () || x.ndims () != 2)
+    error ("__movstat__: X must be a real floating point matrix");
+
+  octave_idx_type nb = args(2).idx_type_value ();
+  octave_idx_type na = args(3).idx_type_value ();
+
+  if (nb < 0 || na < 0)
+    error ("__movstat__: NB and NA must be non-negative");
+
+  movstat_endpoints endpoints = movstat_fill;
+  double fill = 0;
+
+  if (args(4).is_string ())
+    {
+      std::string name = args(4).string_value ();
+
+      if (name == "shrink")
+        endpoints = movstat_shrink;
+      else if (name == "discard")
+        endpoints = movstat_discard;
+      else if (name == "same")
+        endpoints = movstat_same;
+      else if (name == "periodic")
+        endpoints = movstat_periodic;
+      else
+        error ("__movstat__: unknown ENDPOINTS '%s'", name.c_str ());
+    }
+  else
+    fill = args(4).xdouble_value ("__movstat__: ENDPOINTS must be a string "
+                                  "or a numeric scalar");
+
+  if (x.is_single_type ())
+    return ovl (movstat (op, x.float_array_value (), nb, na, endpoints,
+                         static_cast<float> (fill)));
+  else
+    return ovl (movstat (op, x.array_value (), nb, na, endpoints, fill));
+}
+
+/*
+%!test
+%! x = (1:10).';
+%! assert (__movstat__ ("sum", x, 1, 1, "shrink"), [(3:3:27).'; 19]);
+%! assert (__movstat__ ("mean", x, 1, 1, "shrink"), [1.5; (2:9).'; 9.5]);
+%! assert (__movstat__ ("var", x, 1, 1, "shrink"), [0.5; ones(8,1); 0.5]);
+%! assert (__movstat__ ("min", x, 1, 1, "shrink"), [1; (1:9).']);
+%! assert (__movstat__ ("max", x, 1, 1, "shrink"), [(2:10).'; 10]);
+%! assert (__movstat__ ("median", x, 1, 1, "shrink"), [1.5; (2:9).'; 9.5]);
+
+## Endpoint rules
+%!test
+%! x = [4; 1; 3; 2];
+%! assert (__movstat__ ("sum", x, 1, 1, "discard"), [8; 6]);
+%! assert (__movstat__ ("sum", x, 1, 1, "same"), [9; 8; 6; 7]);
+%! assert (__movstat__ ("sum", x, 1, 1, "periodic"), [7; 8; 6; 9]);
+%! assert (__movstat__ ("sum", x, 1, 1, 10), [15; 8; 6; 15]);
+%! assert (__movstat__ ("max", x, 1, 1, NaN), [4; 4; 3; 3]);
+%! assert (__movstat__ ("sum", x, 1, 1, NaN), [NaN; 8; 6; NaN]);
+%! assert (__movstat__ ("median", x, 3, 3, "discard"), zeros (0, 1));
+
+## NaN and Inf leave the window again
+%!test
+%! x = [1; NaN; 2; Inf; 3; 4; 5];
+%! assert (__movstat__ ("sum", x, 1, 0, "shrink"), [1; NaN; NaN; Inf; Inf; 7; 9]);
+%! assert (__movstat__ ("var1", x, 0, 1, "shrink"),
+%!         [NaN; NaN; NaN; NaN; 0.25; 0.25; 0]);
+%! assert (__movstat__ ("min", x, 1, 0, "shrink"), [1; 1; 2; 2; 3; 3; 4]);
+%! assert (__movstat__ ("median", x, 0, 2, "shrink"),
+%!         [NaN; NaN; 3; 4; 4; 4.5; 5]);
+
+%!test
+%! x = single (magic (6));
+%! y = __movstat__ ("std", x, 2, 1, "shrink");
+%! assert (class (y), "single");
+%! assert (y(3,:), std (x(1:4,:)), -4*eps ("single"));
+
+%!error <unknown OP> __movstat__ ("prod", 1, 1, 1, "shrink")
+%!error <real floating point> __movstat__ ("sum", int8 (1), 1, 1, "shrink")
+*/
+
+OCTAVE_END_NAMESPACE(octave)
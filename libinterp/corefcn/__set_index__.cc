@@ -0,0 +1,639 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "dNDArray.h"
+#include "lo-mappers.h"
+#include "oct-inttypes.h"
+
+#include "Cell.h"
+#include "defun.h"
+#include "error.h"
+#include "errwarn.h"
+#include "ov.h"
+#include "ovl.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Index the elements of arrays for the set functions by their values.
+//
+// Elements are compared with == as by the functions that sort the
+// arrays, so NaN values are never equal to another element and 0 is
+// equal to -0.  Sorted arrays are processed in a single pass over
+// neighboring elements, other arrays with a hash table.
+
+static inline std::size_t
+set_hash_mix (uint64_t h)
+{
+  // Finalizer of MurmurHash3.
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+
+  return h;
+}
+
+static inline std::size_t
+set_hash (double v)
+{
+  // 0 and -0 are equal.
+  if (v == 0)
+    v = 0;
+
+  uint64_t bits;
+  std::memcpy (&bits, &v, sizeof (bits));
+
+  return set_hash_mix (bits);
+}
+
+static inline std::size_t
+set_hash (float v)
+{
+  if (v == 0)
+    v = 0;
+
+  uint32_t bits;
+  std::memcpy (&bits, &v, sizeof (bits));
+
+  return set_hash_mix (bits);
+}
+
+template <typename T>
+static inline std::size_t
+set_hash (const octave_int<T>& v)
+{
+  return set_hash_mix (static_cast<uint64_t> (v.value ()));
+}
+
+static inline std::size_t
+set_hash (char v)
+{
+  return set_hash_mix (static_cast<unsigned char> (v));
+}
+
+static inline std::size_t
+set_hash (bool v)
+{
+  return set_hash_mix (v);
+}
+
+static inline std::size_t
+set_hash (const std::string& v)
+{
+  return std::hash<std::string> () (v);
+}
+
+template <typename T>
+static inline bool
+set_isnan (const T&)
+{
+  return false;
+}
+
+static inline bool
+set_isnan (double v)
+{
+  return math::isnan (v);
+}
+
+static inline bool
+set_isnan (float v)
+{
+  return math::isnan (v);
+}
+
+// Hash table of the positions of distinct keys in an array, with open
+// addressing and linear probing.
+
+template <typename T>
+class set_hash_index
+{
+public:
+
+  set_hash_index (const T *keys, octave_idx_type n)
+    : m_keys (keys), m_mask (0), m_slots ()
+  {
+    std::size_t nslots = 16;
+
+    while (nslots < 2 * static_cast<std::size_t> (n))
+      nslots *= 2;
+
+    m_mask = nslots - 1;
+    m_slots.resize (nslots, -1);
+  }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (set_hash_index)
+
+  ~set_hash_index () = default;
+
+  // Insert element K, unless an element with an equal key is already
+  // in the table.  Return the position of that element, or K.
+
+  octave_idx_type insert (octave_idx_type k)
+  {
+    const T& key = m_keys[k];
+
+    for (std::size_t i = set_hash (key) & m_mask; ; i = (i + 1) & m_mask)
+      {
+        octave_idx_type p = m_slots[i];
+
+        if (p < 0)
+          {
+            m_slots[i] = k;
+            return k;
+          }
+
+        if (m_keys[p] == key)
+          return p;
+      }
+  }
+
+  // Return the position of the element equal to KEY, or -1.
+
+  octave_idx_type find (const T& key) const
+  {
+    for (std::size_t i = set_hash (key) & m_mask; ; i = (i + 1) & m_mask)
+      {
+        octave_idx_type p = m_slots[i];
+
+        if (p < 0 || m_keys[p] == key)
+          return p;
+      }
+  }
+
+private:
+
+  const T *m_keys;
+
+  std::size_t m_mask;
+
+  std::vector<octave_idx_type> m_slots;
+};
+
+// True if X is sorted in ascending order and has no NaN values, except
+// for a single element.
+
+template <typename T>
+static bool
+set_is_sorted (const T *x, octave_idx_type n)
+{
+  for (octave_idx_type k = 1; k < n; k++)
+    {
+      if (! (x[k-1] <= x[k]))
+        return false;
+    }
+
+  return true;
+}
+
+// Return the positions of the first (or last) occurrences of the
+// distinct elements of X, in the order of their first occurrence, and
+// the number of the distinct element for each element of X.
+
+template <typename T>
+static octave_value_list
+unique_index (const T *x, octave_idx_type n, bool last)
+{
+  std::vector<octave_idx_type> first_pos;
+  std::vector<octave_idx_type> last_pos;
+
+  NDArray j (dim_vector (n, 1));
+  double *pj = j.fortran_vec ();
+
+  if (set_is_sorted (x, n))
+    {
+      for (octave_idx_type k = 0; k < n; k++)
+        {
+          if (k == 0 || ! (x[k-1] == x[k]))
+            {
+              first_pos.push_back (k);
+              last_pos.push_back (k);
+            }
+          else
+            last_pos.back () = k;
+
+          pj[k] = first_pos.size ();
+        }
+    }
+  else
+    {
+      set_hash_index<T> index (x, n);
+
+      // Number of the distinct element at each position in the table.
+      std::vector<octave_idx_type> group (n);
+
+      for (octave_idx_type k = 0; k < n; k++)
+        {
+          octave_idx_type p = (set_isnan (x[k]) ? k : index.insert (k));
+
+          if (p == k)
+            {
+              group[k] = first_pos.size ();
+              first_pos.push_back (k);
+              last_pos.push_back (k);
+            }
+          else
+            {
+              group[k] = group[p];
+              last_pos[group[k]] = k;
+            }
+
+          pj[k] = group[k] + 1;
+        }
+    }
+
+  const std::vector<octave_idx_type>& pos = (last ? last_pos : first_pos);
+
+  octave_idx_type nu = pos.size ();
+
+  NDArray i (dim_vector (nu, 1));
+  double *pi = i.fortran_vec ();
+
+  for (octave_idx_type k = 0; k < nu; k++)
+    pi[k] = pos[k] + 1;
+
+  return ovl (i, j);
+}
+
+// Return the position in S of the first (or last) element equal to
+// each element of A, or 0 if there is none.
+
+template <typename T>
+static NDArray
+ismember_index (const T *a, octave_idx_type na, const T *s,
+                octave_idx_type ns, bool first, const dim_vector& dv)
+{
+  NDArray retval (dv, 0.0);
+  double *loc = retval.fortran_vec ();
+
+  if (set_is_sorted (a, na) && set_is_sorted (s, ns))
+    {
+      // Merge the sorted arrays.  P is the start and Q the end of the
+      // run of equal elements of S that was found last.
+
+      octave_idx_type p = 0;
+      octave_idx_type q = -1;
+
+      for (octave_idx_type k = 0; k < na; k++)
+        {
+          while (p < ns && s[p] < a[k])
+            p++;
+
+          if (p == ns || ! (s[p] == a[k]))
+            continue;
+
+          if (first)
+            loc[k] = p + 1;
+          else
+            {
+              if (q < p)
+                for (q = p; q + 1 < ns && s[q+1] == s[p]; q++)
+                  ; // Find end of run.
+
+              loc[k] = q + 1;
+            }
+        }
+    }
+  else
+    {
+      set_hash_index<T> index (s, ns);
+
+      std::vector<octave_idx_type> last_pos;
+
+      if (! first)
+        last_pos.resize (ns);
+
+      for (octave_idx_type k = 0; k < ns; k++)
+        {
+          if (set_isnan (s[k]))
+            continue;
+
+          octave_idx_type p = index.insert (k);
+
+          if (! first)
+            last_pos[p] = k;
+        }
+
+      for (octave_idx_type k = 0; k < na; k++)
+        {
+          if (set_isnan (a[k]))
+            continue;
+
+          octave_idx_type p = index.find (a[k]);
+
+          if (p >= 0)
+            loc[k] = (first ? p : last_pos[p]) + 1;
+        }
+    }
+
+  return retval;
+}
+
+// Keys for the elements of a cell array of strings.  Strings are equal
+// if they have the same dimensions and characters, as for strcmp.
+
+static Array<std::string>
+set_string_keys (const Cell& c)
+{
+  octave_idx_type n = c.numel ();
+
+  Array<std::string> retval (dim_vector (n, 1));
+
+  for (octave_idx_type k = 0; k < n; k++)
+    {
+      charNDArray str = c(k).char_array_value ();
+      dim_vector dv = str.dims ();
+
+      std::string key (str.data (), str.numel ());
+
+      if (dv.ndims () == 2 && dv(0) == 1)
+        key.insert (0, 1, 'r');
+      else
+        key.insert (0, 'a' + dv.str () + ':');
+
+      retval(k) = key;
+    }
+
+  return retval;
+}
+
+static bool
+get_first_last_option (const octave_value_list& args, int nargin,
+                       const char *who, const char *dflt)
+{
+  std::string opt = dflt;
+
+  if (args.length () == nargin)
+    opt = args(nargin-1).xstring_value ("%s: OPTION must be a string", who);
+
+  if (opt != "first" && opt != "last")
+    error (R"(%s: OPTION must be "first" or "last")", who);
+
+  return opt == "first";
+}
+
+DEFUN (__unique_index__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {[@var{i}, @var{j}] =} __unique_index__ (@var{x})
+@deftypefnx {} {[@var{i}, @var{j}] =} __unique_index__ (@var{x}, "last")
+Undocumented internal function.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 1 || nargin > 2)
+    print_usage ();
+
+  bool last = ! get_first_last_option (args, 2, "__unique_index__", "first");
+
+  octave_value x = args(0);
+
+  if (x.iscellstr ())
+    {
+      Array<std::string> keys = set_string_keys (x.cell_value ());
+
+      return unique_index (keys.data (), keys.numel (), last);
+    }
+
+  if (x.iscomplex () || x.issparse ())
+    err_wrong_type_arg ("__unique_index__", x);
+
+  switch (x.builtin_type ())
+    {
+    case btyp_double:
+      {
+        NDArray a = x.array_value ();
+        return unique_index (a.data (), a.numel (), last);
+      }
+
+    case btyp_float:
+      {
+        FloatNDArray a = x.float_array_value ();
+        return unique_index (a.data (), a.numel (), last);
+      }
+
+    case btyp_char:
+      {
+        charNDArray a = x.char_array_value ();
+        return unique_index (a.data (), a.numel (), last);
+      }
+
+    case btyp_bool:
+      {
+        boolNDArray a = x.bool_array_value ();
+        return unique_index (a.data (), a.numel (), last);
+      }
+
+#define MAKE_INT_BRANCH(X)                                      \
+      case btyp_ ## X:                                          \
+        {                                                       \
+          X ## NDArray a = x.X ## _array_value ();              \
+          return unique_index (a.data (), a.numel (), last);    \
+        }
+
+      MAKE_INT_BRANCH (int8);
+      MAKE_INT_BRANCH (int16);
+      MAKE_INT_BRANCH (int32);
+      MAKE_INT_BRANCH (int64);
+      MAKE_INT_BRANCH (uint8);
+      MAKE_INT_BRANCH (uint16);
+      MAKE_INT_BRANCH (uint32);
+      MAKE_INT_BRANCH (uint64);
+
+#undef MAKE_INT_BRANCH
+
+    default:
+      err_wrong_type_arg ("__unique_index__", x);
+    }
+}
+
+/*
+%!test
+%! [i, j] = __unique_index__ ([4, 4, 2, NaN, 2, -0, 3, 0, NaN, 1]);
+%! assert (i, [1; 3; 4; 6; 7; 9; 10]);
+%! assert (j, [1; 1; 2; 3; 2; 4; 5; 4; 6; 7]);
+%! i = __unique_index__ ([4, 4, 2, NaN, 2, -0, 3, 0, NaN, 1], "last");
+%! assert (i, [2; 5; 4; 8; 7; 9; 10]);
+
+%!test
+%! [i, j] = __unique_index__ (int64 ([1, 1, 2, 5, 5, 5]));
+%! assert (i, [1; 3; 4]);
+%! assert (j, [1; 1; 2; 3; 3; 3]);
+%! assert (__unique_index__ (int64 ([1, 1, 2, 5, 5, 5]), "last"), [2; 3; 6]);
+
+%!test
+%! [i, j] = __unique_index__ ({"b", "a", "b", "", char (zeros (1,0)), ""});
+%! assert (i, [1; 2; 4; 5]);
+%! assert (j, [1; 2; 1; 3; 4; 3]);
+
+%!test
+%! x = randi (100, 1000, 1);
+%! [i, j] = __unique_index__ (x);
+%! assert (x(i)(j), x);
+%! assert (numel (i), numel (unique (x)));
+*/
+
+DEFUN (__ismember_index__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{loc} =} __ismember_index__ (@var{a}, @var{s})
+@deftypefnx {} {@var{loc} =} __ismember_index__ (@var{a}, @var{s}, "first")
+Undocumented internal function.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 2 || nargin > 3)
+    print_usage ();
+
+  bool first = get_first_last_option (args, 3, "__ismember_index__", "last");
+
+  octave_value a = args(0);
+  octave_value s = args(1);
+
+  dim_vector dv = a.dims ();
+
+  if (a.iscellstr () && s.iscellstr ())
+    {
+      Array<std::string> akeys = set_string_keys (a.cell_value ());
+      Array<std::string> skeys = set_string_keys (s.cell_value ());
+
+      return ovl (ismember_index (akeys.data (), akeys.numel (),
+                                  skeys.data (), skeys.numel (), first, dv));
+    }
+
+  if (a.iscell () || s.iscell () || a.iscomplex () || s.iscomplex ()
+      || a.issparse () || s.issparse ())
+    error ("__ismember_index__: A and S must be real full arrays or cell "
+           "arrays of strings");
+
+  builtin_type_t btyp = a.builtin_type ();
+
+  // Elements of different classes are compared as double values.
+
+  if (s.builtin_type () != btyp)
+    {
+      if (a.is_int64_type () || a.is_uint64_type ()
+          || s.is_int64_type () || s.is_uint64_type ())
+        error ("__ismember_index__: A and S must have the same class for "
+               "64-bit integers");
+
+      btyp = btyp_double;
+    }
+
+  switch (btyp)
+    {
+    case btyp_double:
+      {
+        NDArray aa = a.array_value ();
+        NDArray sa = s.array_value ();
+        return ovl (ismember_index (aa.data (), aa.numel (), sa.data (),
+                                    sa.numel (), first, dv));
+      }
+
+    case btyp_float:
+      {
+        FloatNDArray aa = a.float_array_value ();
+        FloatNDArray sa = s.float_array_value ();
+        return ovl (ismember_index (aa.data (), aa.numel (), sa.data (),
+                                    sa.numel (), first, dv));
+      }
+
+    case btyp_char:
+      {
+        charNDArray aa = a.char_array_value ();
+        charNDArray sa = s.char_array_value ();
+        return ovl (ismember_index (aa.data (), aa.numel (), sa.data (),
+                                    sa.numel (), first, dv));
+      }
+
+    case btyp_bool:
+      {
+        boolNDArray aa = a.bool_array_value ();
+        boolNDArray sa = s.bool_array_value ();
+        return ovl (ismember_index (aa.data (), aa.numel (), sa.data (),
+                                    sa.numel (), first, dv));
+      }
+
+#define MAKE_INT_BRANCH(X)                                              \
+      case btyp_ ## X:                                                  \
+        {                                                               \
+          X ## NDArray aa = a.X ## _array_value ();                     \
+          X ## NDArray sa = s.X ## _array_value ();                     \
+          return ovl (ismember_index (aa.data (), aa.numel (), sa.data (), \
+                                      sa.numel (), first, dv));         \
+        }
+
+      MAKE_INT_BRANCH (int8);
+      MAKE_INT_BRANCH (int16);
+      MAKE_INT_BRANCH (int32);
+      MAKE_INT_BRANCH (int64);
+      MAKE_INT_BRANCH (uint8);
+      MAKE_INT_BRANCH (uint16);
+      MAKE_INT_BRANCH (uint32);
+      MAKE_INT_BRANCH (uint64);
+
+#undef MAKE_INT_BRANCH
+
+    default:
+      err_wrong_type_arg ("__ismember_index__", a);
+    }
+}
+
+/*
+## Unsorted and sorted inputs
+%!test
+%! s = [5, 1, 3, 1, NaN, -0];
+%! a = [1, 2; 3, NaN; 0, 5];
+%! assert (__ismember_index__ (a, s), [4, 0; 3, 0; 6, 1]);
+%! assert (__ismember_index__ (a, s, "first"), [2, 0; 3, 0; 6, 1]);
+%! assert (__ismember_index__ ([0; 1; 1; 3; 4], [-0, 1, 1, 1, 3]),
+%!         [1; 4; 4; 5; 0]);
+%! assert (__ismember_index__ ([0; 1; 1; 3; 4], [-0, 1, 1, 1, 3], "first"),
+%!         [1; 2; 2; 5; 0]);
+
+%!test
+%! assert (__ismember_index__ (int8 ([3, 4]), [4, 3, 3]), [3, 1]);
+%! assert (__ismember_index__ ("abc", "cab"), [2, 3, 1]);
+%! assert (__ismember_index__ ({"x", "y"; "", "z"}, {"z", "", "x"}),
+%!         [3, 0; 2, 1]);
+%! assert (__ismember_index__ ([], [1, 2]), []);
+%! assert (__ismember_index__ ([1, 2], []), [0, 0]);
+
+%!error <same class> __ismember_index__ (int64 (1), 1)
+%!error <OPTION must be> __ismember_index__ (1, 1, "middle")
+*/
+
+OCTAVE_END_NAMESPACE(octave)
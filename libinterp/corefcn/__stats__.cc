@@ -0,0 +1,491 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <vector>
+
+#if defined (HAVE_OMP_H)
+#  include <omp.h>
+#endif
+
+#include "dNDArray.h"
+#include "fNDArray.h"
+#include "lo-ieee.h"
+#include "lo-mappers.h"
+
+#include "defun.h"
+#include "error.h"
+#include "ovl.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Statistics along one dimension of an N-D array.
+//
+// The array is viewed as L x N x U, where N is the length of the
+// dimension DIM and L is the product of the dimensions before it.
+// Element K of column (I, J) is found at I + L*K + L*N*J.  The columns
+// are independent, so they are distributed over the available threads.
+// Nothing inside the parallel regions may throw, so all memory is
+// allocated before entering them.
+
+static void
+stats_layout (const dim_vector& dv, int dim, octave_idx_type& l,
+              octave_idx_type& n, octave_idx_type& u)
+{
+  l = 1;
+  n = 1;
+  u = 1;
+
+  for (int i = 0; i < dv.ndims (); i++)
+    {
+      if (i < dim)
+        l *= dv(i);
+      else if (i == dim)
+        n = dv(i);
+      else
+        u *= dv(i);
+    }
+}
+
+static int
+stats_dim (const octave_value& arg, const char *who)
+{
+  int dim = arg.xint_value ("%s: DIM must be a valid dimension", who);
+
+  if (dim < 1)
+    error ("%s: DIM must be a valid dimension", who);
+
+  return dim - 1;
+}
+
+static int
+stats_num_threads (octave_idx_type ncols)
+{
+  int nthreads = 1;
+
+#if defined (HAVE_OMP_H)
+  nthreads = omp_get_max_threads ();
+#endif
+
+  if (nthreads > ncols)
+    nthreads = std::max (ncols, static_cast<octave_idx_type> (1));
+
+  return nthreads;
+}
+
+// Median of the N elements of X spaced STRIDE apart.  BUF must have
+// room for N elements.  The middle elements are found by selection
+// rather than by sorting the column.  The average of the two middle
+// elements is computed the same way as in median.m so that infinite
+// values give the same result.
+
+template <typename T>
+static T
+median_column (T *buf, const T *x, octave_idx_type stride,
+               octave_idx_type n, bool omitnan, bool isvector)
+{
+  octave_idx_type cnt = 0;
+
+  for (octave_idx_type k = 0; k < n; k++)
+    {
+      T v = x[k*stride];
+
+      if (math::isnan (v))
+        {
+          if (! omitnan)
+            return numeric_limits<T>::NaN ();
+        }
+      else
+        buf[cnt++] = v;
+    }
+
+  if (cnt == 0)
+    return numeric_limits<T>::NaN ();
+
+  octave_idx_type h = (cnt - 1) / 2;
+
+  std::nth_element (buf, buf + h, buf + cnt);
+
+  T a = buf[h];
+
+  if (cnt % 2)
+    return a;
+
+  T b = *std::min_element (buf + h + 1, buf + cnt);
+
+  // Like median.m, avoid overflow for vectors.
+  if (isvector)
+    return a + (b - a) / 2;
+  else
+    return (a + b) / 2;
+}
+
+template <typename NDA>
+static NDA
+median_kernel (const NDA& x, int dim, bool omitnan)
+{
+  typedef typename NDA::element_type T;
+
+  dim_vector dv = x.dims ();
+
+  octave_idx_type l, n, u;
+  stats_layout (dv, dim, l, n, u);
+
+  dim_vector rdv = dv;
+  if (dim < rdv.ndims ())
+    rdv(dim) = 1;
+
+  NDA retval (rdv);
+
+  octave_idx_type ncols = l * u;
+
+  if (ncols == 0)
+    return retval;
+
+  // An array with only one non-singleton dimension, such as 1x1xN, is
+  // treated as a vector.
+  int nns = 0;
+  for (int i = 0; i < dv.ndims (); i++)
+    if (dv(i) != 1)
+      nns++;
+
+  bool isvector = (nns <= 1);
+
+  int nthreads = stats_num_threads (ncols);
+
+  std::vector<T> buf (static_cast<std::size_t> (nthreads) * n);
+
+  const T *px = x.data ();
+  T *pr = retval.fortran_vec ();
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp parallel for
+#endif
+  for (int t = 0; t < nthreads; t++)
+    {
+      T *tbuf = buf.data () + static_cast<std::size_t> (t) * n;
+
+      octave_idx_type c0 = (ncols * t) / nthreads;
+      octave_idx_type c1 = (ncols * (t + 1)) / nthreads;
+
+      for (octave_idx_type c = c0; c < c1; c++)
+        {
+          octave_idx_type i = c % l;
+          octave_idx_type j = c / l;
+
+          pr[c] = median_column (tbuf, px + i + l*n*j, l, n, omitnan,
+                                 isvector);
+        }
+    }
+
+  return retval;
+}
+
+// Mean and variance of each column.  The elements along DIM are
+// processed in blocks that fit in cache.  Each block is summed twice,
+// once for its mean and once for the squared deviations from that
+// mean, and the blocks are combined with the pairwise update of Chan,
+// Golub, and LeVeque.  Columns no longer than a block are computed with
+// the two-pass formula used by var.m, while longer ones stay accurate
+// without a second pass over the whole column.  The mean returned is
+// the plain sum divided by the count, which keeps infinite values
+// intact.  Sums are always accumulated in double precision, so results
+// for single precision data may differ from var.m in the last bits.
+
+static const octave_idx_type var_chunk = 64;
+static const octave_idx_type var_block = 4096;
+
+template <typename T>
+static void
+var_columns (const T *x, octave_idx_type l, octave_idx_type n,
+             octave_idx_type i0, octave_idx_type i1, double w,
+             bool omitnan, T *pv, T *pm)
+{
+  double cnt[var_chunk], sum[var_chunk], mean[var_chunk], m2[var_chunk];
+  double bcnt[var_chunk], bmean[var_chunk], bm2[var_chunk];
+
+  octave_idx_type nc = i1 - i0;
+  octave_idx_type blen = std::max (var_block / nc,
+                                   static_cast<octave_idx_type> (1));
+
+  std::fill_n (cnt, nc, 0.0);
+  std::fill_n (sum, nc, 0.0);
+  std::fill_n (mean, nc, 0.0);
+  std::fill_n (m2, nc, 0.0);
+
+  for (octave_idx_type k0 = 0; k0 < n; k0 += blen)
+    {
+      octave_idx_type k1 = std::min (n, k0 + blen);
+
+      std::fill_n (bcnt, nc, 0.0);
+      std::fill_n (bmean, nc, 0.0);
+      std::fill_n (bm2, nc, 0.0);
+
+      for (octave_idx_type k = k0; k < k1; k++)
+        {
+          const T *xk = x + i0 + l*k;
+
+          for (octave_idx_type i = 0; i < nc; i++)
+            {
+              double v = xk[i];
+
+              if (omitnan && math::isnan (v))
+                continue;
+
+              bmean[i] += v;
+              bcnt[i]++;
+            }
+        }
+
+      for (octave_idx_type i = 0; i < nc; i++)
+        {
+          sum[i] += bmean[i];
+          bmean[i] /= bcnt[i];
+        }
+
+      for (octave_idx_type k = k0; k < k1; k++)
+        {
+          const T *xk = x + i0 + l*k;
+
+          for (octave_idx_type i = 0; i < nc; i++)
+            {
+              double v = xk[i];
+
+              if (omitnan && math::isnan (v))
+                continue;
+
+              double d = v - bmean[i];
+              bm2[i] += d * d;
+            }
+        }
+
+      for (octave_idx_type i = 0; i < nc; i++)
+        {
+          if (bcnt[i] == 0)
+            continue;
+
+          if (cnt[i] == 0)
+            {
+              cnt[i] = bcnt[i];
+              mean[i] = bmean[i];
+              m2[i] = bm2[i];
+            }
+          else
+            {
+              double na = cnt[i];
+              double nb = bcnt[i];
+              double nab = na + nb;
+              double delta = bmean[i] - mean[i];
+
+              mean[i] += delta * (nb / nab);
+              m2[i] += bm2[i] + delta * delta * (na * nb / nab);
+              cnt[i] = nab;
+            }
+        }
+    }
+
+  for (octave_idx_type i = 0; i < nc; i++)
+    {
+      if (cnt[i] == 0)
+        {
+          pm[i] = numeric_limits<T>::NaN ();
+          pv[i] = numeric_limits<T>::NaN ();
+        }
+      else
+        {
+          pm[i] = sum[i] / cnt[i];
+          pv[i] = (cnt[i] == 1 ? 0 : m2[i] / (cnt[i] - 1 + w));
+        }
+    }
+}
+
+template <typename NDA>
+static octave_value_list
+var_kernel (const NDA& x, double w, int dim, bool omitnan)
+{
+  typedef typename NDA::element_type T;
+
+  dim_vector dv = x.dims ();
+
+  octave_idx_type l, n, u;
+  stats_layout (dv, dim, l, n, u);
+
+  dim_vector rdv = dv;
+  if (dim < rdv.ndims ())
+    rdv(dim) = 1;
+
+  NDA v (rdv);
+  NDA m (rdv);
+
+  octave_idx_type nchunks = (l + var_chunk - 1) / var_chunk;
+  octave_idx_type ntasks = nchunks * u;
+
+  const T *px = x.data ();
+  T *pv = v.fortran_vec ();
+  T *pm = m.fortran_vec ();
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp parallel for schedule (dynamic)
+#endif
+  for (octave_idx_type t = 0; t < ntasks; t++)
+    {
+      octave_idx_type j = t / nchunks;
+      octave_idx_type i0 = (t % nchunks) * var_chunk;
+      octave_idx_type i1 = std::min (l, i0 + var_chunk);
+
+      var_columns (px + l*n*j, l, n, i0, i1, w, omitnan,
+                   pv + l*j + i0, pm + l*j + i0);
+    }
+
+  return ovl (v, m);
+}
+
+static void
+check_stats_arg (const octave_value& x, const char *who)
+{
+  if (! x.isfloat () || x.iscomplex () || x.issparse ())
+    error ("%s: X must be a real full floating point array", who);
+}
+
+DEFUN (__median__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{m} =} __median__ (@var{x}, @var{dim}, @var{omitnan})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 3)
+    print_usage ();
+
+  octave_value x = args(0);
+
+  check_stats_arg (x, "__median__");
+
+  int dim = stats_dim (args(1), "__median__");
+  bool omitnan = args(2).bool_value ();
+
+  if (x.is_single_type ())
+    return ovl (median_kernel (x.float_array_value (), dim, omitnan));
+  else
+    return ovl (median_kernel (x.array_value (), dim, omitnan));
+}
+
+/*
+%!assert (__median__ ([3, 1, 2], 2, false), 2)
+%!assert (__median__ ([4, 1, 3, 2], 2, false), 2.5)
+%!assert (__median__ ([1, NaN, 3], 2, false), NaN)
+%!assert (__median__ ([1, NaN, 3], 2, true), 2)
+%!assert (__median__ ([NaN, NaN], 2, true), NaN)
+%!assert (__median__ ([-Inf, Inf], 2, false), NaN)
+%!assert (__median__ ([3, Inf], 2, false), Inf)
+
+%!test
+%! x = magic (4);
+%! assert (__median__ (x, 1, false), [7, 9, 8, 10]);
+%! assert (__median__ (x, 2, false), [8; 9; 8; 9]);
+%! assert (__median__ (x, 3, false), x);
+
+%!test
+%! x = reshape (1:24, 2, 3, 4);
+%! x(1,2,3) = NaN;
+%! m = __median__ (single (x), 3, true);
+%! assert (class (m), "single");
+%! assert (m, single ([10, 9, 14; 11, 13, 15]));
+
+%!test
+%! x = realmax * reshape ([0.6, 0.8], 1, 1, 2);
+%! assert (__median__ (x, 3, false), realmax * 0.7, -2*eps);
+%! y = realmax ("single") * single ([0.6, 0.8]);
+%! assert (__median__ (y, 2, true), realmax ("single") * single (0.7),
+%!         -2*eps ("single"));
+
+%!error <X must be a real full> __median__ (int8 (1), 1, false)
+%!error <DIM must be a valid dimension> __median__ (1, 0, false)
+*/
+
+DEFUN (__var__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{v}, @var{m}] =} __var__ (@var{x}, @var{w}, @var{dim}, @var{omitnan})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 4)
+    print_usage ();
+
+  octave_value x = args(0);
+
+  check_stats_arg (x, "__var__");
+
+  double w = args(1).xdouble_value ("__var__: W must be a scalar");
+  int dim = stats_dim (args(2), "__var__");
+  bool omitnan = args(3).bool_value ();
+
+  if (x.is_single_type ())
+    return var_kernel (x.float_array_value (), w, dim, omitnan);
+  else
+    return var_kernel (x.array_value (), w, dim, omitnan);
+}
+
+/*
+%!test
+%! [v, m] = __var__ ([1, 2, 3, 4], 0, 2, false);
+%! assert (v, 5/3, eps);
+%! assert (m, 2.5);
+
+%!test
+%! x = 3 * magic (3);
+%! assert (__var__ (x, 0, 1, false), [63, 144, 63]);
+%! assert (__var__ (x, 1, 1, false), [42, 96, 42]);
+%! assert (__var__ (x, 0, 2, false), [117; 36; 117]);
+%! assert (__var__ (x, 0, 3, false), zeros (3, 3));
+
+%!test
+%! x = [1, NaN, 3; 4, 5, 6];
+%! assert (__var__ (x, 0, 2, false), [NaN; 1]);
+%! assert (__var__ (x, 0, 2, true), [2; 1]);
+%! [v, m] = __var__ ([NaN, NaN], 0, 2, true);
+%! assert ([v, m], [NaN, NaN]);
+
+## Columns longer than one block
+%!test
+%! x = 1e8 + rand (10000, 3);
+%! [v, m] = __var__ (x, 0, 1, false);
+%! assert (m, mean (x), -1e-14);
+%! assert (v, sumsq (x - mean (x)) / 9999, -1e-10);
+%! y = x.';
+%! assert (__var__ (y, 0, 2, false), v.', -1e-10);
+
+%!test
+%! x = single (reshape (1:24, 2, 3, 4));
+%! [v, m] = __var__ (x, 0, 3, false);
+%! assert (class (v), "single");
+%! assert (v, single (repmat (60, 2, 3)));
+%! assert (m, single ([10, 12, 14; 11, 13, 15]));
+*/
+
+OCTAVE_END_NAMESPACE(octave)
@@ -817,6 +817,36 @@ as the other array.
 
 %!assert (ones (2,2,2) .* ones (1,2), ones (2,2,2));
 
+## Short leading dimensions and broadcasting over several dimensions
+%!test
+%! a = reshape (1:3*500, 3, 500);
+%! b = [10; 20; 30];
+%! assert (a .* b, a .* repmat (b, 1, 500));
+%! assert (b - a, repmat (b, 1, 500) - a);
+%! assert (bsxfun (@atan2, a, b), atan2 (a, repmat (b, 1, 500)));
+%! c = a;
+%! c += b;
+%! assert (c, a + repmat (b, 1, 500));
+
+%!test
+%! a = reshape (1:2*3*4*5, [2, 3, 4, 5]);
+%! b = reshape (1:2*4, [2, 1, 4]);
+%! c = reshape (1:3*5, [1, 3, 1, 5]);
+%! assert (a + b, a + repmat (b, [1, 3, 1, 5]));
+%! assert (b .* c, repmat (b, [1, 3, 1, 5]) .* repmat (c, [2, 1, 4, 1]));
+%! assert (int32 (c) - int32 (b),
+%!         int32 (repmat (c, [2, 1, 4, 1]) - repmat (b, [1, 3, 1, 5])));
+%! d = a;
+%! d ./= c;
+%! assert (d, a ./ repmat (c, [2, 1, 4, 1]));
+
+%!test
+%! a = rand (100, 1, 120);
+%! b = rand (1, 60);
+%! assert (a - b, repmat (a, [1, 60, 1]) - repmat (b, [100, 1, 120]));
+%! assert (single (a) < single (b),
+%!         single (repmat (a, [1, 60, 1])) < single (repmat (b, [100, 1, 120])));
+
 */
 
 OCTAVE_END_NAMESPACE(octave)
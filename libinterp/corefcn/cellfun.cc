@@ -27,6 +27,8 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
+#include <functional>
 #include <string>
 #include <vector>
 #include <list>
@@ -44,6 +46,7 @@
 #include "variables.h"
 #include "unwind-prot.h"
 #include "errwarn.h"
+#include "fork-workers.h"
 #include "utils.h"
 
 #include "ov-bool.h"
@@ -119,6 +122,150 @@ get_output_list (interpreter& interp, octave_idx_type count,
   return tmp;
 }
 
+// Evaluate FCN for the K sets of arguments produced by SET_INPUTS, which
+// stores the arguments for set COUNT in its INPUTLIST argument, using
+// NWORKERS worker processes.  The sets are divided into chunks that are
+// handed out to the workers as they become idle.  Return the output
+// lists that get_output_list would have returned for all sets, in order,
+// or an empty vector if the work can't be distributed.  An error raised
+// for any set is raised again for the first set that failed.
+
+static std::vector<octave_value_list>
+get_output_lists_in_parallel
+  (interpreter& interp, const std::string& who, int nworkers,
+   octave_idx_type k, octave_idx_type nargout, octave_value_list inputlist,
+   const std::function<void (octave_idx_type, octave_value_list&)>& set_inputs,
+   octave_value& fcn, octave_value& error_handler)
+{
+  std::vector<octave_value_list> retval;
+
+  if (nworkers < 2 || k < 2 || ! can_fork_workers (interp))
+    return retval;
+
+  if (nworkers > k)
+    nworkers = k;
+
+  // Several chunks per worker balance uneven costs of the calls, while
+  // chunks that are not too small limit the overhead of handing them
+  // out and of transferring the results.
+
+  octave_idx_type chunk_size = std::max (k / (8 * nworkers),
+                                         static_cast<octave_idx_type> (1));
+
+  octave_idx_type nchunks = (k + chunk_size - 1) / chunk_size;
+
+  worker_task_queue queue (nchunks, nworkers);
+
+  auto work = [&] (int w, std::ostream& os)
+  {
+    octave_idx_type chunk;
+
+    while ((chunk = queue.next (w)) >= 0)
+      {
+        octave_idx_type begin = chunk * chunk_size;
+        octave_idx_type end = std::min (begin + chunk_size, k);
+
+        // The outputs of each call are stored as a cell array with
+        // the values in the first row and flags in the second row that
+        // tell whether the values are defined.
+
+        Cell outputs (1, end - begin);
+
+        for (octave_idx_type count = begin; count < end; count++)
+          {
+            set_inputs (count, inputlist);
+
+            octave_value_list tmp;
+
+            try
+              {
+                tmp = get_output_list (interp, count, nargout, inputlist,
+                                       fcn, error_handler);
+              }
+            catch (const execution_exception& ee)
+              {
+                // Calls after this one are not needed.
+                queue.stop ();
+
+                write_worker_value (os, "error_index",
+                                    static_cast<double> (count));
+                write_worker_value (os, "error_message", ee.message ());
+                write_worker_value (os, "error_identifier",
+                                    ee.identifier ());
+                return;
+              }
+
+            Cell vals (2, tmp.length ());
+
+            for (octave_idx_type j = 0; j < tmp.length (); j++)
+              {
+                vals(0, j) = (tmp(j).is_defined () ? tmp(j) : Matrix ());
+                vals(1, j) = tmp(j).is_defined ();
+              }
+
+            outputs(count - begin) = vals;
+          }
+
+        write_worker_value (os, std::to_string (chunk), outputs);
+      }
+  };
+
+  std::vector<worker_values> results
+    = run_worker_processes (who, nworkers, work);
+
+  const worker_values *failed = nullptr;
+
+  for (const auto& res : results)
+    {
+      auto p = res.find ("error_index");
+
+      if (p != res.end ()
+          && (! failed || p->second.double_value ()
+                          < failed->at ("error_index").double_value ()))
+        failed = &res;
+    }
+
+  if (failed)
+    {
+      std::string msg = failed->at ("error_message").string_value ();
+      std::string id = failed->at ("error_identifier").string_value ();
+
+      if (id.empty ())
+        error ("%s", msg.c_str ());
+      else
+        error_with_id (id.c_str (), "%s", msg.c_str ());
+    }
+
+  retval.resize (k);
+
+  for (const auto& res : results)
+    {
+      for (const auto& nm_val : res)
+        {
+          octave_idx_type begin = std::stoll (nm_val.first) * chunk_size;
+
+          const Cell outputs = nm_val.second.cell_value ();
+
+          for (octave_idx_type i = 0; i < outputs.numel (); i++)
+            {
+              const Cell vals = outputs(i).cell_value ();
+
+              octave_value_list& tmp = retval[begin + i];
+
+              tmp.resize (vals.columns ());
+
+              for (octave_idx_type j = 0; j < vals.columns (); j++)
+                {
+                  if (vals(1, j).bool_value ())
+                    tmp(j) = vals(0, j);
+                }
+            }
+        }
+    }
+
+  return retval;
+}
+
 // Templated function because the user can be stubborn enough to request
 // a cell array as an output even in these cases where the output fits
 // in an ordinary array
@@ -226,7 +373,7 @@ static void
 get_mapper_fun_options (symbol_table& symtab,
                         const octave_value_list& args,
                         int& nargin, bool& uniform_output,
-                        octave_value& error_handler)
+                        octave_value& error_handler, int& nworkers)
 {
   while (nargin > 3 && args(nargin-2).is_string ())
     {
@@ -257,6 +404,13 @@ get_mapper_fun_options (symbol_table& symtab,
           else
             error ("cellfun: invalid value for 'ErrorHandler' function");
         }
+      else if (string::strncmpi (arg, "parallel", compare_len))
+        {
+          nworkers = args(nargin-1).xint_value ("cellfun: 'Parallel' value must be an integer");
+
+          if (nworkers < 0)
+            error ("cellfun: 'Parallel' value must be non-negative");
+        }
       else
         error ("cellfun: unrecognized parameter %s", arg.c_str ());
 
@@ -277,6 +431,7 @@ DEFMETHOD (cellfun, interp, args, nargout,
 @deftypefnx {} {[@var{A1}, @var{A2}, @dots{}] =} cellfun (@dots{})
 @deftypefnx {} {@var{A} =} cellfun (@dots{}, "ErrorHandler", @var{errfcn})
 @deftypefnx {} {@var{A} =} cellfun (@dots{}, "UniformOutput", @var{val})
+@deftypefnx {} {@var{A} =} cellfun (@dots{}, "Parallel", @var{n})
 
 Evaluate the function named "@var{fcn}" on the elements of the cell array
 @var{C}.
@@ -387,6 +542,25 @@ cellfun ("factorial", @{-1,2@}, "ErrorHandler", @@foo)
 @end group
 @end example
 
+Given the parameter @qcode{"Parallel"}, the calls of @var{fcn} are
+distributed over up to @var{n} worker processes, which are created as copies
+of the Octave process.  The elements are divided into chunks that are handed
+out to the workers as they become idle, so that calls of uneven cost are
+balanced.  The results are the same as without the option, provided that
+@var{fcn} has no side effects and does not draw random numbers: changes to
+variables, files, or other state made by @var{fcn} or @var{errfcn} are not
+seen by the calling process.  The outputs of @var{fcn} must be values that
+can be saved with @code{save}.  A value of 0 or 1 for @var{n} (the default)
+calls @var{fcn} sequentially, as do all calls in the GUI, in the debugger, or
+while profiling.
+
+Each worker seeds the generators of @code{rand}, @code{randn},
+@code{rande}, @code{randg}, and @code{randp} with a state derived from the
+state of the calling process and the number of the worker, so the workers
+draw different random numbers.  These are not the numbers that sequential
+calls would draw, and because the chunks are handed out as workers become
+idle, which element receives which numbers may change from run to run.
+
 Use @code{cellfun} intelligently.  The @code{cellfun} function is a useful tool
 for avoiding loops.  It is often used with anonymous function handles; however,
 calling an anonymous function involves an overhead quite comparable to the
@@ -448,8 +622,10 @@ v = cellfun (@@det, C);         # 40% faster
 
   bool uniform_output = true;
   octave_value error_handler;
+  int nworkers = 0;
 
-  get_mapper_fun_options (symtab, args, nargin, uniform_output, error_handler);
+  get_mapper_fun_options (symtab, args, nargin, uniform_output, error_handler,
+                          nworkers);
 
   // The following is an optimization because the symbol table can give a
   // more specific function class, so this can result in fewer polymorphic
@@ -536,6 +712,24 @@ nevermind:
         }
     }
 
+  // With the "Parallel" option, all function calls are made before the
+  // outputs are collected.
+
+  std::vector<octave_value_list> output_lists
+    = get_output_lists_in_parallel
+        (interp, "cellfun", nworkers, k, nargout, inputlist,
+         [&] (octave_idx_type count, octave_value_list& args_k)
+         {
+           for (int j = 0; j < nargin; j++)
+             {
+               if (mask[j])
+                 args_k.xelem (j) = cinputs[j](count);
+             }
+         },
+         fcn, error_handler);
+
+  bool have_output_lists = ! output_lists.empty ();
+
   // Apply functions.
 
   if (uniform_output)
@@ -549,15 +743,20 @@ nevermind:
       int expected_nargout;
       for (octave_idx_type count = 0; count < k; count++)
         {
-          for (int j = 0; j < nargin; j++)
+          if (! have_output_lists)
             {
-              if (mask[j])
-                inputlist.xelem (j) = cinputs[j](count);
+              for (int j = 0; j < nargin; j++)
+                {
+                  if (mask[j])
+                    inputlist.xelem (j) = cinputs[j](count);
+                }
             }
 
           const octave_value_list tmp
-            = get_output_list (interp, count, nargout, inputlist, fcn,
-                               error_handler);
+            = (have_output_lists
+               ? output_lists[count]
+               : get_output_list (interp, count, nargout, inputlist, fcn,
+                                  error_handler));
 
           int tmp_numel = tmp.length ();
           if (count == 0)
@@ -635,15 +834,20 @@ nevermind:
 
       for (octave_idx_type count = 0; count < k; count++)
         {
-          for (int j = 0; j < nargin; j++)
+          if (! have_output_lists)
             {
-              if (mask[j])
-                inputlist.xelem (j) = cinputs[j](count);
+              for (int j = 0; j < nargin; j++)
+                {
+                  if (mask[j])
+                    inputlist.xelem (j) = cinputs[j](count);
+                }
             }
 
           const octave_value_list tmp
-            = get_output_list (interp, count, nargout, inputlist, fcn,
-                               error_handler);
+            = (have_output_lists
+               ? output_lists[count]
+               : get_output_list (interp, count, nargout, inputlist, fcn,
+                                  error_handler));
 
           if (nargout > 0 && tmp.length () < nargout)
             error ("cellfun: function returned fewer than nargout values");
@@ -1044,6 +1248,34 @@ nevermind:
 %!         [1, 2, NaN]);
 %! assert (! isempty (__errmsg));
 %! clear -global __errmsg;
+
+## "Parallel" option
+%!test
+%! c = num2cell (1:50);
+%! assert (cellfun (@(x) x^2, c, "Parallel", 3), (1:50).^2);
+%! [a, b] = cellfun (@(x) deal (x, 1:x), c, "UniformOutput", false,
+%!                   "Parallel", 4);
+%! assert (a, c);
+%! assert (b, cellfun (@(x) 1:x, c, "UniformOutput", false));
+%! assert (cellfun (@factorial, {1, 2, -3}, "ErrorHandler", @(s, x) s.index,
+%!                  "Parallel", 2), [1, 2, 3]);
+
+## Workers must not wait for threads started by the parent
+%!test
+%! x = reshape (1:90000, 300, 300);
+%! y = x .* x(:,1);
+%! c = cellfun (@(k) sum ((x .* x(:,k))(:)), {1, 2}, "Parallel", 2);
+%! assert (c, [sum(y(:)), sum ((x .* x(:,2))(:))]);
+
+## Workers must not draw the same random numbers
+%!test
+%! c = cellfun (@(x) rand (), num2cell (1:8), "Parallel", 2);
+%! assert (numel (unique (c)), 8);
+
+%!error <element 7> cellfun (@(x) error ("element %d", x), num2cell (7:20),
+%!                          "Parallel", 2)
+%!error <'Parallel' value must be non-negative>
+%! cellfun (@sin, {1}, "Parallel", -1)
 */
 
 // Arrayfun was originally a .m file written by Bill Denney and Jaroslav
@@ -1057,6 +1289,7 @@ DEFMETHOD (arrayfun, interp, args, nargout,
 @deftypefnx {} {[@var{B1}, @var{B2}, @dots{}] =} arrayfun (@var{fcn}, @var{A}, @dots{})
 @deftypefnx {} {@var{B} =} arrayfun (@dots{}, "UniformOutput", @var{val})
 @deftypefnx {} {@var{B} =} arrayfun (@dots{}, "ErrorHandler", @var{errfcn})
+@deftypefnx {} {@var{B} =} arrayfun (@dots{}, "Parallel", @var{n})
 
 Execute a function on each element of an array.
 
@@ -1167,6 +1400,18 @@ arrayfun (@@str2num, [1234],
 @end group
 @end example
 
+If the parameter @qcode{"Parallel"} is given, the calls of @var{fcn} are
+distributed over up to @var{n} worker processes.  The restrictions are the
+same as for @code{cellfun}.  For example, the independent evaluations in
+
+@example
+results = arrayfun (@@evaluate_scenario, 1:1000, "Parallel", nproc ());
+@end example
+
+@noindent
+are computed on all available processors.  If @code{evaluate_scenario} draws
+random numbers, each worker draws its own, as described for @code{cellfun}.
+
 @seealso{spfun, cellfun, structfun}
 @end deftypefn */)
 {
@@ -1233,9 +1478,10 @@ arrayfun (@@str2num, [1234],
 
       bool uniform_output = true;
       octave_value error_handler;
+      int nworkers = 0;
 
       get_mapper_fun_options (symtab, args, nargin, uniform_output,
-                              error_handler);
+                              error_handler, nworkers);
 
       octave_value_list inputlist (nargin, octave_value ());
 
@@ -1274,6 +1520,26 @@ arrayfun (@@str2num, [1234],
             }
         }
 
+      // With the "Parallel" option, all function calls are made before
+      // the outputs are collected.
+
+      std::vector<octave_value_list> output_lists
+        = get_output_lists_in_parallel
+            (interp, "arrayfun", nworkers, k, nargout, inputlist,
+             [&] (octave_idx_type count, octave_value_list& args_k)
+             {
+               octave_value_list idx (1, octave_value (count + 1.0));
+
+               for (int j = 0; j < nargin; j++)
+                 {
+                   if (mask[j])
+                     args_k.xelem (j) = inputs[j].index_op (idx);
+                 }
+             },
+             fcn, error_handler);
+
+      bool have_output_lists = ! output_lists.empty ();
+
       // Apply functions.
 
       if (uniform_output)
@@ -1286,17 +1552,22 @@ arrayfun (@@str2num, [1234],
 
           for (octave_idx_type count = 0; count < k; count++)
             {
-              idx_list.front ()(0) = count + 1.0;
-
-              for (int j = 0; j < nargin; j++)
+              if (! have_output_lists)
                 {
-                  if (mask[j])
-                    inputlist.xelem (j) = inputs[j].index_op (idx_list);
+                  idx_list.front ()(0) = count + 1.0;
+
+                  for (int j = 0; j < nargin; j++)
+                    {
+                      if (mask[j])
+                        inputlist.xelem (j) = inputs[j].index_op (idx_list);
+                    }
                 }
 
               const octave_value_list tmp
-                = get_output_list (interp, count, nargout, inputlist, fcn,
-                                   error_handler);
+                = (have_output_lists
+                   ? output_lists[count]
+                   : get_output_list (interp, count, nargout, inputlist,
+                                      fcn, error_handler));
 
               if (nargout > 0 && tmp.length () < nargout)
                 error_with_id ("Octave:invalid-fun-call",
@@ -1378,17 +1649,22 @@ arrayfun (@@str2num, [1234],
 
           for (octave_idx_type count = 0; count < k; count++)
             {
-              idx_list.front ()(0) = count + 1.0;
-
-              for (int j = 0; j < nargin; j++)
+              if (! have_output_lists)
                 {
-                  if (mask[j])
-                    inputlist.xelem (j) = inputs[j].index_op (idx_list);
+                  idx_list.front ()(0) = count + 1.0;
+
+                  for (int j = 0; j < nargin; j++)
+                    {
+                      if (mask[j])
+                        inputlist.xelem (j) = inputs[j].index_op (idx_list);
+                    }
                 }
 
               const octave_value_list tmp
-                = get_output_list (interp, count, nargout, inputlist, fcn,
-                                   error_handler);
+                = (have_output_lists
+                   ? output_lists[count]
+                   : get_output_list (interp, count, nargout, inputlist,
+                                      fcn, error_handler));
 
               if (nargout > 0 && tmp.length () < nargout)
                 error_with_id ("Octave:invalid-fun-call",
@@ -1668,6 +1944,12 @@ arrayfun (@@str2num, [1234],
 %! assert ([(isempty (A(1).message)), (isempty (A(2).message))],
 %!         [false, false]);
 %! assert ([A(1).index, A(2).index], [1, 2]);
+
+%!test
+%! assert (arrayfun (@(x) x + 1, magic (4), "Parallel", 2), magic (4) + 1);
+%! assert (arrayfun (@(x) {x}, 1:10, "Parallel", 20), num2cell (1:10));
+%! r = arrayfun (@(x) randn (), 1:8, "Parallel", 4);
+%! assert (numel (unique (r)), 8);
 */
 
 static void
@@ -65,6 +65,15 @@ The size of the result is @code{max (size (A) - size (B) + 1, 0)}.
 When the third argument is a matrix, return the convolution of the matrix
 @var{m} by the vector @var{v1} in the column direction and by the vector
 @var{v2} in the row direction.
+
+Large convolutions are computed with Fast Fourier Transforms when that is
+cheaper than the direct sum, in blocks if the transforms would need too much
+memory.  The result then differs from the direct sum by roundoff errors that
+are typically of the order of
+@code{eps * norm (@var{A}(:)) * norm (@var{B}(:))}, and at most of the order
+of @code{eps * log2 (@var{n}) * norm (@var{A}(:)) * norm (@var{B}(:), 1)},
+where @var{n} is the number of elements of the result.  Convolutions of
+integer-valued arrays are exact as long as the result is representable.
 @seealso{conv, convn}
 @end deftypefn */)
 {
@@ -300,6 +309,55 @@ When the third argument is a matrix, return the convolution of the matrix
 %! B = conv2 (x, y, "valid");
 %! assert (B, A);   # Yes, this test is for *exact* equivalence.
 
+## Large convolutions are computed with FFTs
+%!test
+%! old_state = rand ("state");
+%! restore_state = onCleanup (@() rand ("state", old_state));
+%! rand ("state", 42);
+%! x = rand (300);
+%! y = rand (31);
+%! C = zeros (330);
+%! for j = 1:31
+%!   C(:,j:j+299) += conv2 (x, y(:,j));
+%! endfor
+%! tol = 1e-12 * norm (x(:)) * norm (y(:));
+%! assert (conv2 (x, y), C, tol);
+%! assert (conv2 (x, y, "same"), C(16:315,16:315), tol);
+%! assert (conv2 (x, y, "valid"), C(31:300,31:300), tol);
+%! assert (conv2 (single (x), single (y)), single (C),
+%!         single (1e-5 * norm (x(:)) * norm (y(:))));
+%! assert (conv2 (x + i*x, y), C + i*C, 2 * tol);
+
+%!test
+%! old_state = rand ("state");
+%! restore_state = onCleanup (@() rand ("state", old_state));
+%! rand ("state", 42);
+%! x = randi (10, 300);
+%! y = randi ([-10, 10], 31);
+%! C = zeros (330);
+%! for j = 1:31
+%!   C(:,j:j+299) += conv2 (x, y(:,j));
+%! endfor
+%! assert (conv2 (x, y), C);
+%! x(1,1) = Inf;
+%! C = conv2 (x, y);
+%! assert (isfinite (C(32:end,32:end)));
+
+## Transforms that would be too large are computed in blocks
+%!test
+%! old_state = rand ("state");
+%! restore_state = onCleanup (@() rand ("state", old_state));
+%! rand ("state", 42);
+%! n = 4.5e6;
+%! m = 1000;
+%! x = rand (n, 1);
+%! s = cumsum ([zeros(m,1); x; zeros(m,1)]);
+%! C = s(m+1:end-1) - s(1:end-m-1);
+%! tol = 1e-12 * norm (x) * sqrt (m);
+%! assert (conv2 (x, ones (m, 1)), C, tol);
+%! assert (conv2 (x, ones (m, 1), "valid"), C(m:n), tol);
+%! assert (conv2 (ones (n, 1), ones (m, 1), "valid"), m * ones (n-m+1, 1));
+
 ## Test input validation
 %!error conv2 ()
 %!error conv2 (1)
@@ -333,6 +391,14 @@ Return only the parts which do not include zero-padded edges.
 The size of the result is @code{max (size (A) - size (B) + 1, 0)}.
 @end table
 
+Large convolutions are computed with Fast Fourier Transforms when that is
+cheaper than the direct sum, in blocks if the transforms would need too much
+memory.  The result then differs from the direct sum by roundoff errors that
+are typically of the order of
+@code{eps * norm (@var{A}(:)) * norm (@var{B}(:))}, and at most of the order
+of @code{eps * log2 (@var{n}) * norm (@var{A}(:)) * norm (@var{B}(:), 1)},
+where @var{n} is the number of elements of the result.  Convolutions of
+integer-valued arrays are exact as long as the result is representable.
 @seealso{conv2, conv}
 @end deftypefn */)
 {
@@ -593,6 +659,21 @@ The size of the result is @code{max (size (A) - size (B) + 1, 0)}.
 %!assert (class (convn (ones (5, "uint8"), b)), "double")
 %!assert (class (convn (d, ones (5, "uint8"))), "single")
 
+%!test
+%! old_state = rand ("state");
+%! restore_state = onCleanup (@() rand ("state", old_state));
+%! rand ("state", 42);
+%! x = rand (40, 40, 40);
+%! y = rand (7, 7, 7);
+%! C = zeros (46, 46, 46);
+%! for k = 1:7
+%!   C(:,:,k:k+39) += convn (x, y(:,:,k));
+%! endfor
+%! tol = 1e-12 * norm (x(:)) * norm (y(:));
+%! assert (convn (x, y), C, tol);
+%! assert (convn (x, y, "same"), C(4:43,4:43,4:43), tol);
+%! assert (convn (x, y, "valid"), C(7:40,7:40,7:40), tol);
+
 %!error convn ()
 %!error convn (1)
 %!error <SHAPE type not valid> convn (1,2, "NOT_A_SHAPE")
@@ -2583,6 +2583,32 @@ returns the original array @var{A}.
   return do_permute (args, true);
 }
 
+/*
+%!test
+%! x = reshape (1:3*300*4*5, [3, 300, 4, 5]);
+%! y = permute (x, [3, 1, 4, 2]);
+%! assert (size (y), [4, 3, 5, 300]);
+%! assert (y(2, 3, 5, 299), x(3, 299, 2, 5));
+%! assert (ipermute (y, [3, 1, 4, 2]), x);
+
+%!test
+%! x = rand (5, 300, 7);
+%! y = permute (x, [2, 3, 1]);
+%! for k = 1:5
+%!   assert (y(:,:,k), squeeze (x(k,:,:)));
+%! endfor
+%! z = permute (single (x), [1, 4, 2, 3]);
+%! assert (size (z), [5, 1, 300, 7]);
+%! assert (z(:), single (x(:)));
+
+%!test
+%! a = rand (300, 70);
+%! b = a.';
+%! assert (size (b), [70, 300]);
+%! assert (b(3, 250), a(250, 3));
+%! assert (b(70, 300), a(300, 70));
+*/
+
 DEFUN (length, args, ,
        doc: /* -*- texinfo -*-
 @deftypefn {} {@var{n} =} length (@var{A})
@@ -7326,6 +7352,31 @@ ordered lists.
 %! [v, i] = sort (a);
 %! assert (i, [1, 4, 2, 5, 3]);
 
+## Large numeric inputs are sorted by key; order and indices must be stable
+%!test
+%! x = [randi(50, 15000, 1) - 25; -Inf; NaN; Inf];
+%! for cls = {"double", "single", "int8", "uint16", "int64"}
+%!   y = cast (x, cls{1});
+%!   for mode = {"ascend", "descend"}
+%!     [s, i] = sort (y, mode{1});
+%!     assert (s, y(i));
+%!     assert (issorted (s(! isnan (s)), mode{1}));
+%!     d = [(s(1:end-1) == s(2:end)); false];
+%!     assert (i(d) < i([false; d(1:end-1)]));
+%!     assert (sort (y, mode{1}), s);
+%!   endfor
+%! endfor
+%!test
+%! x = repmat ([0; -0; 1; -1], 1000, 1);
+%! [s, i] = sort (x);
+%! assert (i, [4:4:4000, sort ([1:4:4000, 2:4:4000]), 3:4:4000]');
+%! assert (1 ./ s(1001:3000), repmat ([Inf; -Inf], 1000, 1));
+%!test
+%! x = rand (400, 500);
+%! [s, i] = sort (x, 2, "descend");
+%! assert (s, x(sub2ind (size (x), repmat ((1:400)', 1, 500), i)));
+%! assert (all (all (diff (s, 1, 2) <= 0)));
+
 %!error sort ()
 %!error sort (1, 2, 3, 4)
 */
@@ -7849,6 +7900,92 @@ Undocumented internal function.
   return do_accumarray_minmax_fcn (args, false);
 }
 
+template <typename NDT>
+static NDT
+do_accumarray_prod (const idx_vector& idx, const NDT& vals,
+                    octave_idx_type n = -1)
+{
+  typedef typename NDT::element_type T;
+  if (n < 0)
+    n = idx.extent (0);
+  else if (idx.extent (n) > n)
+    error ("accumarray: index out of range");
+
+  NDT retval (dim_vector (n, 1), T (1));
+  T *dst = retval.fortran_vec ();
+
+  octave_idx_type len = idx.length (n);
+
+  if (vals.numel () == 1)
+    {
+      T val = vals(0);
+      idx.loop (len, [dst, val] (octave_idx_type i) { dst[i] *= val; });
+    }
+  else if (vals.numel () == len)
+    {
+      const T *src = vals.data ();
+      idx.loop (len, [dst, &src] (octave_idx_type i) { dst[i] *= *src++; });
+    }
+  else
+    error ("accumarray: dimensions mismatch");
+
+  return retval;
+}
+
+DEFUN (__accumarray_prod__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {} __accumarray_prod__ (@var{idx}, @var{vals}, @var{n})
+Undocumented internal function.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 2 || nargin > 3)
+    print_usage ();
+
+  if (! args(0).isnumeric ())
+    error ("__accumarray_prod__: first argument must be numeric");
+
+  octave_value retval;
+
+  try
+    {
+      idx_vector idx = args(0).index_vector ();
+      octave_idx_type n = -1;
+      if (nargin == 3)
+        n = args(2).idx_type_value (true);
+
+      octave_value vals = args(1);
+
+      if (vals.is_single_type ())
+        {
+          if (vals.iscomplex ())
+            retval = do_accumarray_prod (idx,
+                                         vals.float_complex_array_value (),
+                                         n);
+          else
+            retval = do_accumarray_prod (idx, vals.float_array_value (), n);
+        }
+      else if (vals.isfloat () || vals.islogical ())
+        {
+          if (vals.iscomplex ())
+            retval = do_accumarray_prod (idx,
+                                         vals.complex_array_value (),
+                                         n);
+          else
+            retval = do_accumarray_prod (idx, vals.array_value (), n);
+        }
+      else
+        err_wrong_type_arg ("accumarray", vals);
+    }
+  catch (const index_exception& ie)
+    {
+      error ("__accumarray_prod__: invalid index %s", ie.what ());
+    }
+
+  return retval;
+}
+
 template <typename NDT>
 static NDT
 do_accumdim_sum (const idx_vector& idx, const NDT& vals,
@@ -30,14 +30,17 @@
 #  include "config.h"
 #endif
 
+#include <cerrno>
 #include <clocale>
 #include <cmath>
 #include <cctype>
+#include <cstdlib>
 #include <fstream>
 #include <limits>
 
 #include "file-ops.h"
 #include "lo-ieee.h"
+#include "lo-mappers.h"
 #include "lo-sysdep.h"
 
 #include "defun.h"
@@ -169,6 +172,70 @@ parse_range_spec (const octave_value& range_spec,
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+// Convert the field LINE[POS1, POS2) to a double without creating a
+// temporary string and stream.  Only fields consisting of an optionally
+// signed decimal number surrounded by blanks are handled here.  Return
+// false for anything else (complex values, Inf, NaN, NA, text) so that
+// the caller can fall back to the general parser.
+//
+// The caller has set the "C" locale, so strtod is locale-independent
+// and correctly rounded.  Values out of range are kept as strtod
+// returns them, i.e., Inf for overflow and zero or a denormal number
+// for underflow.
+
+static bool
+read_plain_double (const std::string& line, std::size_t pos1,
+                   std::size_t pos2, double& x)
+{
+  if (pos2 == std::string::npos)
+    pos2 = line.length ();
+
+  if (pos1 >= pos2)
+    return false;
+
+  const char *beg = line.data () + pos1;
+  const char *end = line.data () + pos2;
+
+  bool have_digit = false;
+  for (const char *p = beg; p != end; p++)
+    {
+      switch (*p)
+        {
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+          have_digit = true;
+          break;
+
+        case '+': case '-': case '.': case 'e': case 'E':
+        case ' ': case '\t': case '\r':
+          break;
+
+        default:
+          return false;
+        }
+    }
+
+  if (! have_digit)
+    return false;
+
+  char *num_end;
+  double val = std::strtod (beg, &num_end);
+
+  if (num_end == beg)
+    return false;
+
+  const char *p = num_end;
+  while (p != end && (*p == ' ' || *p == '\t' || *p == '\r'))
+    p++;
+
+  if (p != end)
+    return false;
+
+  x = val;
+
+  return true;
+}
+
 DEFMETHOD (dlmread, interp, args, ,
            doc: /* -*- texinfo -*-
 @deftypefn  {} {@var{data} =} dlmread (@var{file})
@@ -449,7 +516,7 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
           octave_quit ();
 
           pos2 = line.find_first_of (sep, pos1);
-          std::string str = line.substr (pos1, pos2 - pos1);
+          std::size_t field_end = pos2;
 
           if (auto_sep_is_wspace && pos2 != std::string::npos)
             {
@@ -462,7 +529,7 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
             }
 
           // Separator followed by EOL doesn't generate extra column
-          if (pos2 == std::string::npos && str.empty ())
+          if (pos2 == std::string::npos && pos1 >= line.length ())
             break;
 
           c = (c > j + 1 ? c : j + 1);
@@ -478,10 +545,23 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
                 rdata.resize (rmax, cmax, empty_value);
             }
 
-          tmp_stream.str (str);
+          // Fast path for plain real numbers.
+          double x;
+          if (read_plain_double (line, pos1, field_end, x))
+            {
+              if (iscmplx)
+                cdata(i, j++) = x;
+              else
+                rdata(i, j++) = x;
+
+              pos1 = pos2 + 1;
+              continue;
+            }
+
+          tmp_stream.str (line.substr (pos1, field_end - pos1));
           tmp_stream.clear ();
 
-          double x = read_value<double> (tmp_stream);
+          x = read_value<double> (tmp_stream);
           if (tmp_stream)
             {
               if (tmp_stream.eof ())
@@ -763,6 +843,38 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
 %!   unlink (file);
 %! end_unwind_protect
 
+## Plain numbers with blanks and CRLF line endings
+%!test
+%! file = tempname ();
+%! unwind_protect
+%!   fid = fopen (file, "wb");
+%!   fwrite (fid, " 0.1, -2.5E+2 ,.5\r\n1e-3,+7.,1\r\n");
+%!   fclose (fid);
+%!
+%!   assert (dlmread (file), [0.1, -250, 0.5; 1e-3, 7, 1]);
+%! unwind_protect_cleanup
+%!   unlink (file);
+%! end_unwind_protect
+
+## Correct rounding of hard cases and of values out of range
+%!test
+%! file = tempname ();
+%! unwind_protect
+%!   fid = fopen (file, "wb");
+%!   fwrite (fid, "9007199254740993,2.2250738585072011e-308\n");
+%!   fwrite (fid, "1.00000000000000011102230246251565404236316680908203125,");
+%!   fwrite (fid, "1.00000000000000011102230246251565404236316680908203126\n");
+%!   fwrite (fid, "0e999,1e-400\n");
+%!   fclose (fid);
+%!
+%!   x = dlmread (file);
+%!   assert (x(1,:), [2^53, realmin - pow2 (-1074)]);
+%!   assert (x(2,:), [1, 1 + eps]);
+%!   assert (x(3,:), [0, 0]);
+%! unwind_protect_cleanup
+%!   unlink (file);
+%! end_unwind_protect
+
 */
 
 OCTAVE_END_NAMESPACE(octave)
@@ -47,17 +47,24 @@
 #include <iomanip>
 #include <string>
 
+#if defined (OCTAVE_HAVE_STD_PMR_POLYMORPHIC_ALLOCATOR)
+#  include <memory_resource>
+#endif
+
 #if defined (HAVE_ZLIB_H)
 #  include <zlib.h>
 #endif
 
 #include "file-ops.h"
 #include "file-stat.h"
+#include "filepos-wrappers.h"
 #include "iconv-wrappers.h"
 #include "lo-ieee.h"
+#include "lo-mappers.h"
 #include "lo-sysdep.h"
 #include "localcharset-wrapper.h"
 #include "mkostemp-wrapper.h"
+#include "mman-wrappers.h"
 #include "oct-env.h"
 #include "oct-locbuf.h"
 #include "unistd-wrappers.h"
@@ -2388,6 +2395,16 @@ as the name of the function when reporting errors.
 
 %!assert <*60711> (textscan('1,.,2', '%f', 'Delimiter', ','), {1});
 
+## Correct rounding of hard cases and of values out of range
+%!test
+%! str = ["9007199254740993 2.2250738585072011e-308 0.1 0.30000000000000004 ", ...
+%!        "1.00000000000000011102230246251565404236316680908203125 ", ...
+%!        "1.00000000000000011102230246251565404236316680908203126 ", ...
+%!        "0e999 1e-400 1e999"];
+%! C = textscan (str, "%f");
+%! assert (C{1}, [2^53; realmin - pow2(-1074); 0.1; 0.1 + 0.2; 1; 1 + eps;
+%!                0; 0; Inf]);
+
 */
 
 // These tests have end-comment sequences, so can't just be in a comment
@@ -2667,6 +2684,211 @@ The optional return value @var{count} contains the number of elements read.
   return ovl (tmp, count);
 }
 
+#if defined (OCTAVE_HAVE_STD_PMR_POLYMORPHIC_ALLOCATOR)
+
+// Memory resource for an Array whose data is a private mapping of a
+// file.  Each mapping has its own resource object, which unmaps the
+// pages and deletes itself when the Array releases its data.  Copies
+// of the Array that need their own data use the default allocator.
+
+class mmap_memory_resource : public std::pmr::memory_resource
+{
+public:
+
+  mmap_memory_resource (void *addr, std::size_t len)
+    : m_addr (addr), m_len (len)
+  { }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (mmap_memory_resource)
+
+  ~mmap_memory_resource () = default;
+
+private:
+
+  void * do_allocate (std::size_t /*bytes*/, std::size_t /*alignment*/)
+  {
+    throw std::bad_alloc ();
+  }
+
+  void do_deallocate (void * /*ptr*/, std::size_t /*bytes*/,
+                      std::size_t /*alignment*/)
+  {
+    octave_munmap_wrapper (m_addr, m_len);
+
+    delete this;
+  }
+
+  bool do_is_equal (const std::pmr::memory_resource& other) const noexcept
+  {
+    return this == &other;
+  }
+
+  void *m_addr;
+
+  std::size_t m_len;
+};
+
+#endif
+
+// Return N elements of type ARRAY_T::element_type stored at byte
+// OFFSET in the file FPTR as a column vector.  If possible, the data of
+// the array is a private mapping of the file, so pages are only read
+// when they are first accessed and no copy is made.  Otherwise, the
+// data are read into a new array.
+
+template <typename ARRAY_T>
+static octave_value
+map_file_data (FILE *fptr, off_t offset, octave_idx_type n)
+{
+  typedef typename ARRAY_T::element_type elt_type;
+
+  dim_vector dv (n, 1);
+
+  std::size_t nbytes = static_cast<std::size_t> (n) * sizeof (elt_type);
+
+#if defined (OCTAVE_HAVE_STD_PMR_POLYMORPHIC_ALLOCATOR)
+
+  std::size_t page_size = octave_page_size_wrapper ();
+  off_t map_offset = offset - offset % page_size;
+  std::size_t delta = offset - map_offset;
+
+  if (n > 0 && delta % alignof (elt_type) == 0)
+    {
+      void *addr = octave_mmap_private_wrapper (fileno (fptr), map_offset,
+                                                delta + nbytes);
+
+      if (addr)
+        {
+          elt_type *data
+            = reinterpret_cast<elt_type *> (static_cast<char *> (addr)
+                                            + delta);
+
+          return ARRAY_T (Array<elt_type> (data, dv,
+                                           new mmap_memory_resource
+                                             (addr, delta + nbytes)));
+        }
+    }
+
+#endif
+
+  ARRAY_T retval (dv);
+
+  if (n > 0
+      && (octave_fseeko_wrapper (fptr, offset, SEEK_SET) != 0
+          || std::fread (retval.fortran_vec (), 1, nbytes, fptr) != nbytes))
+    error ("__memmap__: unable to read %" OCTAVE_IDX_TYPE_FORMAT
+           " elements at offset %ld", n, static_cast<long> (offset));
+
+  return retval;
+}
+
+DEFUN (__memmap__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{data} =} __memmap__ (@var{file}, @var{class}, @var{offset}, @var{count})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 4)
+    print_usage ();
+
+  std::string fname = args(0).xstring_value ("__memmap__: FILE must be a string");
+  std::string cls = args(1).xstring_value ("__memmap__: CLASS must be a string");
+  double offset = args(2).xdouble_value ("__memmap__: OFFSET must be a number");
+  double count = args(3).xdouble_value ("__memmap__: COUNT must be a number");
+
+  if (offset < 0 || math::x_nint (offset) != offset)
+    error ("__memmap__: OFFSET must be a nonnegative integer");
+
+  if (count < 0 || (! math::isinf (count) && math::x_nint (count) != count))
+    error ("__memmap__: COUNT must be a nonnegative integer or Inf");
+
+  std::size_t elt_size;
+
+  if (cls == "int8" || cls == "uint8")
+    elt_size = 1;
+  else if (cls == "int16" || cls == "uint16")
+    elt_size = 2;
+  else if (cls == "int32" || cls == "uint32" || cls == "single")
+    elt_size = 4;
+  else if (cls == "int64" || cls == "uint64" || cls == "double")
+    elt_size = 8;
+  else
+    error ("__memmap__: invalid CLASS '%s'", cls.c_str ());
+
+  std::string tname = sys::file_ops::tilde_expand (fname);
+
+  sys::file_stat fs (tname);
+
+  if (! fs)
+    error ("__memmap__: unable to open file '%s'", fname.c_str ());
+
+  off_t file_size = fs.size ();
+
+  if (offset > file_size)
+    error ("__memmap__: OFFSET is beyond the end of file '%s'",
+           fname.c_str ());
+
+  double avail = std::floor ((file_size - offset) / elt_size);
+
+  if (math::isinf (count))
+    count = avail;
+  else if (count > avail)
+    error ("__memmap__: file '%s' is too short for %g elements of class %s",
+           fname.c_str (), count, cls.c_str ());
+
+  FILE *fptr = sys::fopen (tname, "rb");
+
+  if (! fptr)
+    error ("__memmap__: unable to open file '%s'", fname.c_str ());
+
+  unwind_action act ([fptr] () { std::fclose (fptr); });
+
+  off_t off = static_cast<off_t> (offset);
+  octave_idx_type n = static_cast<octave_idx_type> (count);
+
+  if (cls == "int8")
+    return ovl (map_file_data<int8NDArray> (fptr, off, n));
+  else if (cls == "uint8")
+    return ovl (map_file_data<uint8NDArray> (fptr, off, n));
+  else if (cls == "int16")
+    return ovl (map_file_data<int16NDArray> (fptr, off, n));
+  else if (cls == "uint16")
+    return ovl (map_file_data<uint16NDArray> (fptr, off, n));
+  else if (cls == "int32")
+    return ovl (map_file_data<int32NDArray> (fptr, off, n));
+  else if (cls == "uint32")
+    return ovl (map_file_data<uint32NDArray> (fptr, off, n));
+  else if (cls == "int64")
+    return ovl (map_file_data<int64NDArray> (fptr, off, n));
+  else if (cls == "uint64")
+    return ovl (map_file_data<uint64NDArray> (fptr, off, n));
+  else if (cls == "single")
+    return ovl (map_file_data<FloatNDArray> (fptr, off, n));
+  else
+    return ovl (map_file_data<NDArray> (fptr, off, n));
+}
+
+/*
+%!test
+%! f = tempname ();
+%! unwind_protect
+%!   fid = fopen (f, "wb");
+%!   fwrite (fid, uint8 (1:3));
+%!   fwrite (fid, [pi; -1; 2^60], "double");
+%!   fclose (fid);
+%!   x = __memmap__ (f, "double", 3, Inf);
+%!   assert (x, [pi; -1; 2^60]);
+%!   x(2) = 5;
+%!   assert (__memmap__ (f, "double", 3, 3), [pi; -1; 2^60]);
+%!   assert (__memmap__ (f, "uint8", 0, 2), uint8 ([1; 2]));
+%!   assert (size (__memmap__ (f, "int16", 27, Inf)), [0, 1]);
+%!   fail ('__memmap__ (f, "double", 3, 4)', "too short");
+%!   fail ('__memmap__ (f, "char", 0, 1)', "invalid CLASS");
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+*/
+
 static int
 do_fwrite (stream& os, const octave_value& data,
            const octave_value& prec_arg, const octave_value& skip_arg,
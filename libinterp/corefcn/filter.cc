@@ -35,6 +35,11 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <vector>
+
 #include "quit.h"
 
 #include "defun.h"
@@ -43,6 +48,243 @@
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+// Number of channels that are filtered together.  Their states are
+// interleaved so that the loops over the channels of a block do not
+// depend on each other and can be vectorized.
+static const int FILTER_BLOCK = 8;
+
+// Filter the NB channels whose first samples are at PX + X_OFFSET[k]
+// and whose states start at PSI + k*SI_LEN.  NB is either 1 or
+// FILTER_BLOCK; a partial block is filtered one channel at a time.
+// Each channel performs exactly the same operations as when it is
+// filtered alone.
+
+template <typename T, bool HAS_A, int NB>
+static void
+filter_channels (const T *pa, const T *pb, octave_idx_type si_len,
+                 const T *px, T *py, T *psi, const octave_idx_type *x_offset,
+                 octave_idx_type x_len, octave_idx_type x_stride,
+                 bool interruptible)
+{
+  std::vector<T> st (si_len * NB);
+  T xv[NB];
+  T yv[NB];
+
+  for (int k = 0; k < NB; k++)
+    for (octave_idx_type j = 0; j < si_len; j++)
+      st[j*NB + k] = psi[k*si_len + j];
+
+  T *s = st.data ();
+  T *slast = s + (si_len - 1) * NB;
+
+  for (octave_idx_type i = 0, idx = 0; i < x_len; i++, idx += x_stride)
+    {
+      for (int k = 0; k < NB; k++)
+        {
+          xv[k] = px[x_offset[k] + idx];
+          yv[k] = s[k] + pb[0] * xv[k];
+        }
+
+      for (octave_idx_type j = 0; j < si_len - 1; j++)
+        {
+          T *sj = s + j*NB;
+          const T *sj1 = sj + NB;
+          T aj = (HAS_A ? pa[j+1] : T ());
+          T bj = pb[j+1];
+
+          for (int k = 0; k < NB; k++)
+            sj[k] = (HAS_A ? sj1[k] - aj * yv[k] + bj * xv[k]
+                     : sj1[k] + bj * xv[k]);
+        }
+
+      for (int k = 0; k < NB; k++)
+        {
+          slast[k] = (HAS_A ? pb[si_len] * xv[k] - pa[si_len] * yv[k]
+                      : pb[si_len] * xv[k]);
+          py[x_offset[k] + idx] = yv[k];
+        }
+
+      if (interruptible)
+        octave_quit ();
+    }
+
+  for (int k = 0; k < NB; k++)
+    for (octave_idx_type j = 0; j < si_len; j++)
+      psi[k*si_len + j] = st[j*NB + k];
+}
+
+// Apply a filter to the samples I0 to I1-1 of the channels NUM0 to
+// NUM1-1 of X.  The states in PSI are those after sample I0-1 and are
+// replaced by those after sample I1-1.
+
+template <typename T, bool HAS_A>
+static void
+filter_channel_range (const T *pa, const T *pb, octave_idx_type si_len,
+                      const T *px, T *py, T *psi,
+                      octave_idx_type x_len, octave_idx_type x_stride,
+                      octave_idx_type num0, octave_idx_type num1,
+                      octave_idx_type i0, octave_idx_type i1,
+                      bool interruptible)
+{
+  octave_idx_type x_offset[FILTER_BLOCK];
+
+  for (octave_idx_type num = num0; num < num1; )
+    {
+      octave_idx_type nb = std::min (num1 - num,
+                                     static_cast<octave_idx_type> (FILTER_BLOCK));
+
+      for (octave_idx_type k = 0; k < nb; k++)
+        {
+          octave_idx_type n = num + k;
+          x_offset[k] = ((x_stride == 1) ? n * x_len
+                         : n + (n / x_stride) * x_stride * (x_len - 1));
+        }
+
+      if (nb == FILTER_BLOCK)
+        filter_channels<T, HAS_A, FILTER_BLOCK>
+          (pa, pb, si_len, px + i0*x_stride, py + i0*x_stride,
+           psi + num*si_len, x_offset, i1 - i0, x_stride, interruptible);
+      else
+        for (octave_idx_type k = 0; k < nb; k++)
+          filter_channels<T, HAS_A, 1>
+            (pa, pb, si_len, px + i0*x_stride, py + i0*x_stride,
+             psi + (num+k)*si_len, x_offset + k, i1 - i0, x_stride,
+             interruptible);
+
+      num += nb;
+    }
+}
+
+// Operations in a range of channels that is worth a thread of its own,
+// and in a round of ranges between checks for interrupts.
+static const double FILTER_TASK_WORK = 262144;
+static const double FILTER_ROUND_WORK = 67108864;
+
+// Call FCN (NUM0, NUM1, I0, I1, INTERRUPTIBLE) to filter the samples I0
+// to I1-1 of the channels NUM0 to NUM1-1, for all X_NUM channels of
+// length X_LEN.  Channels are taken in groups of GRAIN, and filtering
+// one sample of a channel costs about COST operations.
+//
+// Large problems are split into rounds, each of which covers a segment
+// of the samples of a group of channels.  The channels of a round are
+// divided into ranges that are filtered in parallel, and interrupts are
+// checked between rounds.  FCN carries the state of each channel from
+// one segment to the next, so every channel performs the same
+// operations as when it is filtered in a single pass.
+
+static void
+filter_in_rounds (octave_idx_type x_num, octave_idx_type x_len,
+                  octave_idx_type grain, double cost,
+                  const std::function<void (octave_idx_type, octave_idx_type,
+                                            octave_idx_type, octave_idx_type,
+                                            bool)>& fcn)
+{
+  octave_idx_type nunits = (x_num + grain - 1) / grain;
+  double unit_work = cost * grain;
+  double work = unit_work * nunits * x_len;
+
+  bool par = false;
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+  par = (nunits > 1 && work >= 2 * FILTER_TASK_WORK);
+#endif
+
+  if (! par)
+    {
+      fcn (0, x_num, 0, x_len, true);
+      return;
+    }
+
+  // Length of the segments of samples and number of units of channels
+  // in a round.
+  octave_idx_type seg = x_len;
+  octave_idx_type grp = nunits;
+
+  if (work > FILTER_ROUND_WORK)
+    {
+      double len = FILTER_ROUND_WORK / (unit_work * nunits);
+      seg = std::min (x_len, static_cast<octave_idx_type>
+                               (std::max (len, 1024.0)));
+
+      double units = FILTER_ROUND_WORK / (unit_work * seg);
+      grp = std::min (nunits, static_cast<octave_idx_type>
+                                (std::max (units, 1.0)));
+    }
+
+  for (octave_idx_type g0 = 0; g0 < nunits; g0 += grp)
+    {
+      octave_idx_type g1 = std::min (g0 + grp, nunits);
+      octave_idx_type ng = g1 - g0;
+
+      for (octave_idx_type i0 = 0; i0 < x_len; i0 += seg)
+        {
+          octave_idx_type i1 = std::min (i0 + seg, x_len);
+
+          double round_work = unit_work * ng * (i1 - i0);
+          octave_idx_type ntasks
+            = std::min (ng, static_cast<octave_idx_type>
+                              (std::min (round_work / FILTER_TASK_WORK,
+                                         1024.0)));
+          ntasks = std::max (ntasks, static_cast<octave_idx_type> (1));
+
+          std::exception_ptr err;
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp parallel for schedule (dynamic)
+#endif
+          for (octave_idx_type t = 0; t < ntasks; t++)
+            {
+              try
+                {
+                  octave_idx_type u0 = g0 + (ng * t) / ntasks;
+                  octave_idx_type u1 = g0 + (ng * (t + 1)) / ntasks;
+
+                  fcn (std::min (u0 * grain, x_num),
+                       std::min (u1 * grain, x_num), i0, i1, false);
+                }
+              catch (...)
+                {
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp critical (filter_in_rounds)
+#endif
+                  err = std::current_exception ();
+                }
+            }
+
+          if (err)
+            std::rethrow_exception (err);
+
+          octave_quit ();
+        }
+    }
+}
+
+// Apply a filter to all X_NUM channels of X.  Many channels, or long
+// ones, are split into ranges filtered in parallel.
+
+template <typename T>
+static void
+filter_all_channels (const T *pa, const T *pb, bool has_a,
+                     octave_idx_type si_len, const T *px, T *py, T *psi,
+                     octave_idx_type x_len, octave_idx_type x_stride,
+                     octave_idx_type x_num)
+{
+  void (*fcn) (const T *, const T *, octave_idx_type, const T *, T *, T *,
+               octave_idx_type, octave_idx_type, octave_idx_type,
+               octave_idx_type, octave_idx_type, octave_idx_type, bool)
+    = (has_a ? filter_channel_range<T, true>
+       : filter_channel_range<T, false>);
+
+  filter_in_rounds (x_num, x_len, FILTER_BLOCK, si_len + 1,
+                    [=] (octave_idx_type num0, octave_idx_type num1,
+                         octave_idx_type i0, octave_idx_type i1,
+                         bool interruptible)
+                    {
+                      fcn (pa, pb, si_len, px, py, psi, x_len, x_stride,
+                           num0, num1, i0, i1, interruptible);
+                    });
+}
+
 template <typename T>
 MArray<T>
 filter (MArray<T>& b, MArray<T>& a, MArray<T>& x, MArray<T>& si,
@@ -115,122 +357,13 @@ filter (MArray<T>& b, MArray<T>& a, MArray<T>& x, MArray<T>& si,
     x_stride *= x_dims(i);
 
   octave_idx_type x_num = x_dims.numel () / x_len;
-  // For deconv and fftfilt, x_num seems to always be 1.
-  // For directly calling filter, it can be more than 1.
-
-  for (octave_idx_type num = 0; num < x_num; num++)
-    {
-      octave_idx_type x_offset = (x_stride == 1) ? num * x_len
-                                 : num + (num / x_stride) * x_stride * (x_len - 1);
-
-      octave_idx_type si_offset = num * si_len;
-
-      // Try to achieve a balance between speed and interruptibility.
-      //
-      // One extreme is to not check for interruptions at all, which gives
-      // good speed but the user cannot use Ctrl-C for the whole duration.
-      // The other end is to check frequently from inside an inner loop,
-      // which slows down performance by 5X or 6X.
-      //
-      // Putting any sort of check in an inner loop seems to prevent the
-      // compiler from optimizing the loop, so we cannot say "check for
-      // interruptions every M iterations" using an if-statement.
-      //
-      // This is a compromise approach to split the total numer of loop
-      // executions into num_outer and num_inner, to provide periodic checks
-      // for interruptions without writing a conditional inside a tight loop.
-      //
-      // To make it more interruptible and run more slowly, reduce num_inner.
-      // To speed it up but make it less interruptible, increase it.
-      // May need to increase it slowly over time as computers get faster.
-      // The aim is to not lose Ctrl-C ability for longer than about 2 seconds.
-      //
-      // In December 2021, num_inner = 100000 is acceptable.
-
-      octave_idx_type num_execs = si_len-1; // 0 to num_execs-1
-      octave_idx_type num_inner = 100000;
-      octave_idx_type num_outer = num_execs / num_inner;
-
-      // The following if-else block depends on a_len and si_len,
-      // both of which are loop invariants in this 0 <= num < x_num loop.
-      // But x_num is so small in practice that using the if-else inside
-      // the loop has more benefits than duplicating the outer for-loop,
-      // even though the checks are on loop invariants.
-
-      // We cannot have a_len <= 1 AND si_len <= 0 because that case already
-      // returned above. This means exactly one of the following blocks
-      // inside the if-conditional will be obeyed: it is not possible for the
-      // if-block and the else-block to *both* skip. Therefore any code that
-      // is common to both branches can be pulled out here without affecting
-      // correctness or speed.
-
-      T *py = y.fortran_vec ();
-      T *psi = si.fortran_vec ();
-      const T *pb = b.data ();
-      const T *px = x.data ();
-      psi += si_offset;
-
-      if (a_len > 1)
-        {
-          const T *pa = a.data ();
-
-          // Usually the last element to be written will be si_len-1
-          // but if si_len is 0, then we need the 0th element to be written.
-          // Pulling this check out of the for-loop makes it run faster.
-          octave_idx_type iidx = (si_len > 0) ? si_len-1 : 0;
-
-          for (octave_idx_type i = 0, idx = x_offset;
-               i < x_len;
-               i++, idx += x_stride)
-            {
-              py[idx] = psi[0] + pb[0] * px[idx];
-
-              // Outer and inner loops for interruption management
-              for (octave_idx_type u = 0; u <= num_outer; u++)
-                {
-                  octave_idx_type lo = u * num_inner;
-                  octave_idx_type hi = (lo + num_inner < num_execs-1)
-                                       ? lo + num_inner : num_execs-1;
-
-                  // Inner loop, no interruption
-                  for (octave_idx_type j = lo; j <= hi; j++)
-                    psi[j] = psi[j+1] - pa[j+1] * py[idx] + pb[j+1] * px[idx];
-
-                  octave_quit();  // Check for interruptions
-                }
-
-              psi[iidx] = pb[si_len] * px[idx] - pa[si_len] * py[idx];
-            }
-        }
-      else // a_len <= 1 ==> si_len MUST be > 0
-        {
-          // This else-block is almost the same as the above if-block,
-          // except for the absence of variable pa.
 
-          for (octave_idx_type i = 0, idx = x_offset;
-               i < x_len;
-               i++, idx += x_stride)
-            {
-              py[idx] = psi[0] + pb[0] * px[idx];
-
-              // Outer and inner loops for interruption management
-              for (octave_idx_type u = 0; u <= num_outer; u++)
-                {
-                  octave_idx_type lo = u * num_inner;
-                  octave_idx_type hi = (lo + num_inner < num_execs-1)
-                                       ? lo + num_inner : num_execs-1;
+  // We cannot have a_len <= 1 AND si_len <= 0 because that case already
+  // returned above, so the state has at least one element.
 
-                  // Inner loop, no interruption
-                  for (octave_idx_type j = lo; j <= hi; j++)
-                    psi[j] = psi[j+1] + pb[j+1] * px[idx];
-
-                  octave_quit();  // Check for interruptions
-                }
-
-              psi[si_len-1] = pb[si_len] * px[idx];
-            }
-        }
-    }
+  filter_all_channels (a.data (), b.data (), a_len > 1, si_len,
+                       x.data (), y.fortran_vec (), si.fortran_vec (),
+                       x_len, x_stride, x_num);
 
   return y;
 }
@@ -260,6 +393,115 @@ filter (MArray<T>& b, MArray<T>& a, MArray<T>& x, int dim = -1)
   return filter (b, a, x, si, dim);
 }
 
+// Apply the cascade of second-order sections whose coefficients are
+// the rows [b0 b1 b2 a0 a1 a2] of the L-by-6 matrix SOS to the samples
+// I0 to I1-1 of the columns NUM0 to NUM1-1 of X.  The state of section
+// S of channel N is ZI(:,S,N) and is replaced by the state after sample
+// I1-1.  Each section runs over the samples with its state held in
+// local variables, and performs the same operations as filter does for
+// the corresponding coefficient vectors.
+
+template <typename T>
+static void
+sosfilt_channels (const T *sos, octave_idx_type nsec, const T *px, T *py,
+                  T *pz, octave_idx_type x_len, octave_idx_type num0,
+                  octave_idx_type num1, octave_idx_type i0,
+                  octave_idx_type i1, bool interruptible)
+{
+  for (octave_idx_type num = num0; num < num1; num++)
+    {
+      const T *xc = px + num * x_len;
+      T *yc = py + num * x_len;
+      T *zc = pz + num * 2 * nsec;
+
+      std::copy (xc + i0, xc + i1, yc + i0);
+
+      for (octave_idx_type s = 0; s < nsec; s++)
+        {
+          T b0 = sos[s];
+          T b1 = sos[s + nsec];
+          T b2 = sos[s + 2*nsec];
+          T a1 = sos[s + 4*nsec];
+          T a2 = sos[s + 5*nsec];
+
+          T z0 = zc[2*s];
+          T z1 = zc[2*s+1];
+
+          for (octave_idx_type i = i0; i < i1; i++)
+            {
+              T xi = yc[i];
+              T yi = z0 + b0 * xi;
+              z0 = z1 - a1 * yi + b1 * xi;
+              z1 = b2 * xi - a2 * yi;
+              yc[i] = yi;
+            }
+
+          zc[2*s] = z0;
+          zc[2*s+1] = z1;
+
+          if (interruptible)
+            octave_quit ();
+        }
+    }
+}
+
+template <typename T>
+static MArray<T>
+sosfilt (MArray<T> sos, const MArray<T>& x, MArray<T>& zi)
+{
+  if (sos.ndims () != 2 || sos.columns () != 6)
+    error ("__sosfilt__: SOS must be an L-by-6 matrix");
+
+  octave_idx_type nsec = sos.rows ();
+
+  for (octave_idx_type s = 0; s < nsec; s++)
+    {
+      T norm = sos(s, 3);
+
+      if (norm == static_cast<T> (0.0))
+        error ("__sosfilt__: the leading denominator coefficient of each section must be nonzero");
+
+      if (norm != static_cast<T> (1.0))
+        {
+          for (octave_idx_type k = 0; k < 6; k++)
+            sos(s, k) /= norm;
+        }
+    }
+
+  dim_vector x_dims = x.dims ();
+  octave_idx_type x_len = (x.isvector () ? x.numel () : x_dims(0));
+  octave_idx_type x_num = (x_len == 0 ? 0 : x.numel () / x_len);
+
+  if (zi.isempty ())
+    zi = MArray<T> (dim_vector (2, nsec, x_num), T (0.0));
+  else if (zi.numel () != 2 * nsec * x_num)
+    error ("__sosfilt__: ZI must have 2*L elements for each column of X");
+
+  MArray<T> y (x_dims);
+
+  if (x.isempty () || nsec == 0)
+    {
+      y = x;
+      return y;
+    }
+
+  const T *psos = sos.data ();
+  const T *px = x.data ();
+  T *py = y.fortran_vec ();
+  T *pz = zi.fortran_vec ();
+
+  filter_in_rounds (x_num, x_len, 1, nsec,
+                    [=] (octave_idx_type num0, octave_idx_type num1,
+                         octave_idx_type i0, octave_idx_type i1,
+                         bool interruptible)
+                    {
+                      sosfilt_channels (psos, nsec, px, py, pz, x_len,
+                                        num0, num1, i0, i1, interruptible);
+                    });
+
+  return y;
+}
+
 DEFUN (filter, args, ,
        doc: /* -*- texinfo -*-
 @deftypefn  {} {@var{y} =} filter (@var{b}, @var{a}, @var{x})
@@ -571,6 +813,63 @@ template MArray<FloatComplex>
 filter (MArray<FloatComplex>&, MArray<FloatComplex>&, MArray<FloatComplex>&,
         int dim);
 
+template <typename NDA>
+static octave_value_list
+do_sosfilt (const octave_value_list& args)
+{
+  NDA sos = octave_value_extract<NDA> (args(0));
+  NDA x = octave_value_extract<NDA> (args(1));
+  NDA zi;
+
+  if (args.length () > 2)
+    zi = octave_value_extract<NDA> (args(2));
+
+  NDA y = sosfilt<typename NDA::element_type> (sos, x, zi);
+
+  return ovl (y, zi);
+}
+
+DEFUN (__sosfilt__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{y} =} __sosfilt__ (@var{sos}, @var{x})
+@deftypefnx {} {[@var{y}, @var{zf}] =} __sosfilt__ (@var{sos}, @var{x}, @var{zi})
+Undocumented internal function.
+@end deftypefn */)
+{
+  // Filter the columns of X, or X itself if it is a vector, through
+  // the cascade of second-order sections given by the rows of SOS.
+  // The state of each section is a pair of values, and ZI and ZF hold
+  // 2*L of them for each column.
+
+  int nargin = args.length ();
+
+  if (nargin < 2 || nargin > 3)
+    print_usage ();
+
+  bool isfloat = (args(0).is_single_type ()
+                  || args(1).is_single_type ()
+                  || (nargin > 2 && args(2).is_single_type ()));
+
+  bool iscomplex = (args(0).iscomplex ()
+                    || args(1).iscomplex ()
+                    || (nargin > 2 && args(2).iscomplex ()));
+
+  if (iscomplex)
+    {
+      if (isfloat)
+        return do_sosfilt<FloatComplexNDArray> (args);
+      else
+        return do_sosfilt<ComplexNDArray> (args);
+    }
+  else
+    {
+      if (isfloat)
+        return do_sosfilt<FloatNDArray> (args);
+      else
+        return do_sosfilt<NDArray> (args);
+    }
+}
+
 /*
 %!shared a, b, x, r
 %!test
@@ -648,6 +947,45 @@ filter (MArray<FloatComplex>&, MArray<FloatComplex>&, MArray<FloatComplex>&,
 %! y0 = reshape (y0, size (x));
 %! y = filter ([1 1 1], 1, x, [], 3);
 %! assert (y, y0);
+
+## Channels are filtered in blocks
+%!test
+%! b = [1 2 3];
+%! a = [1 -0.5 0.2];
+%! x = rand (50, 21);
+%! si = rand (2, 21);
+%! [y, sf] = filter (b, a, x, si);
+%! [y2, sf2] = filter (b, a, x.', si, 2);
+%! assert (y2, y.');
+%! assert (sf2, sf);
+%! for k = 1:21
+%!   [yk, sk] = filter (b, a, x(:,k), si(:,k));
+%!   assert (y(:,k), yk);
+%!   assert (sf(:,k), sk);
+%! endfor
+%! y = filter (b, 1, single (x) + i);
+%! for k = 1:21
+%!   assert (y(:,k), filter (b, 1, single (x(:,k)) + i));
+%! endfor
+
+## Second-order sections
+%!shared sos, x, y
+%! sos = [1 2 1 1 -0.5 0.25; 0.5 0 -0.5 2 0.3 0.1];
+%! x = rand (100, 3);
+%! y = filter (sos(1,1:3), sos(1,4:6), x);
+%! y = filter (sos(2,1:3), sos(2,4:6), y);
+%!assert (__sosfilt__ (sos, x), y)
+%!assert (__sosfilt__ (sos, x(:,1).'), y(:,1).')
+%!assert (__sosfilt__ (sos, x + i*x), y + i*y)
+%!assert (__sosfilt__ (single (sos), x), single (y), 1e-5)
+%!test
+%! [y1, zf] = __sosfilt__ (sos, x(1:40,:));
+%! assert (size (zf), [2, 2, 3]);
+%! y2 = __sosfilt__ (sos, x(41:end,:), zf);
+%! assert ([y1; y2], y);
+%!error <SOS must be an L-by-6 matrix> __sosfilt__ (ones (2, 5), x)
+%!error <must be nonzero> __sosfilt__ ([1 1 1 0 1 1], x)
+%!error <ZI must have> __sosfilt__ (sos, x, zeros (2, 2))
 */
 
 OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,455 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+
+#if defined (HAVE_OMP_H)
+#  include <omp.h>
+#endif
+
+#if defined (HAVE_PTHREAD_H)
+#  include <pthread.h>
+#endif
+
+#include "file-ops.h"
+#include "lo-sysdep.h"
+#include "mach-info.h"
+#include "mkostemp-wrapper.h"
+#include "mman-wrappers.h"
+#include "oct-env.h"
+#include "oct-locbuf.h"
+#include "oct-rand.h"
+#include "oct-syscalls.h"
+#include "quit.h"
+#include "unistd-wrappers.h"
+
+#include "error.h"
+#include "fork-workers.h"
+#include "interpreter.h"
+#include "ls-oct-binary.h"
+#include "octave.h"
+#include "pager.h"
+#include "profiler.h"
+#include "pt-eval.h"
+#include "unwind-prot.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+worker_task_queue::worker_task_queue (octave_idx_type ntasks, int nworkers)
+  : m_ntasks (ntasks), m_nworkers (nworkers), m_shared_next (nullptr),
+    m_local_last (-1)
+{
+  typedef std::atomic<octave_idx_type> counter_type;
+
+  void *addr = octave_mmap_shared_anonymous_wrapper (sizeof (counter_type));
+
+  if (addr)
+    {
+      m_shared_next = new (addr) counter_type (0);
+
+      // A counter that needs a lock would not be shared correctly.
+
+      if (! m_shared_next->is_lock_free ())
+        {
+          octave_munmap_wrapper (addr, sizeof (counter_type));
+          m_shared_next = nullptr;
+        }
+    }
+}
+
+worker_task_queue::~worker_task_queue ()
+{
+  if (m_shared_next)
+    octave_munmap_wrapper (m_shared_next,
+                           sizeof (std::atomic<octave_idx_type>));
+}
+
+octave_idx_type
+worker_task_queue::next (int w)
+{
+  octave_idx_type task;
+
+  if (m_shared_next)
+    task = m_shared_next->fetch_add (1);
+  else
+    {
+      task = (m_local_last < 0 ? w : m_local_last + m_nworkers);
+
+      m_local_last = task;
+    }
+
+  return task < m_ntasks ? task : -1;
+}
+
+void
+worker_task_queue::stop ()
+{
+  if (m_shared_next)
+    m_shared_next->store (m_ntasks);
+  else
+    m_local_last = m_ntasks;
+}
+
+bool
+can_fork_workers (interpreter& interp)
+{
+  tree_evaluator& tw = interp.get_evaluator ();
+
+  return (octave_have_fork () && ! application::is_gui_running ()
+          && ! tw.echo_state () && ! tw.debug_mode ()
+          && ! tw.get_profiler ().enabled ()
+          && ! interp.get_error_system ().debug_on_error ()
+          && ! interp.get_output_system ().page_screen_output ());
+}
+
+// Once the OpenMP runtime has started its thread pool, a parallel
+// region in a forked copy of the process waits for threads that don't
+// exist in the copy.  Limit every forked process to a single thread
+// before it can run any parallel region.  This also covers processes
+// forked by other means, which have the same problem.
+
+static void
+limit_forked_threads ()
+{
+#if defined (OCTAVE_ENABLE_OPENMP) && defined (HAVE_OMP_H)
+  omp_set_dynamic (0);
+  omp_set_num_threads (1);
+#endif
+}
+
+static bool
+install_fork_handler ()
+{
+#if defined (OCTAVE_ENABLE_OPENMP) && defined (HAVE_PTHREAD_H)
+  return pthread_atfork (nullptr, nullptr, limit_forked_threads) == 0;
+#else
+  return false;
+#endif
+}
+
+// Names of the values in the results of a worker that report its
+// status.
+
+static const char *status_record = ".status";
+static const char *message_record = ".message";
+static const char *identifier_record = ".identifier";
+
+void
+write_worker_value (std::ostream& os, const std::string& name,
+                    const octave_value& val)
+{
+  if (! save_binary_data (os, val, name, "", false, false) || ! os)
+    error ("unable to transfer value of '%s' from worker process",
+           name.c_str ());
+}
+
+static void
+write_worker_error (const std::string& file, const std::string& msg,
+                    const std::string& id)
+{
+  // This is called in the worker process, which must not throw an
+  // exception back into the code of the parent process.
+
+  try
+    {
+      std::ofstream os = sys::ofstream (file, std::ios::out | std::ios::binary
+                                              | std::ios::trunc);
+
+      save_binary_data (os, octave_value (msg), message_record, "", false,
+                        false);
+      save_binary_data (os, octave_value (id), identifier_record, "", false,
+                        false);
+      save_binary_data (os, octave_value (1.0), status_record, "", false,
+                        false);
+    }
+  catch (...)
+    {
+      // The parent reports a missing status record.
+    }
+}
+
+static worker_values
+read_worker_values (const std::string& file)
+{
+  worker_values retval;
+
+  std::ifstream is = sys::ifstream (file, std::ios::in | std::ios::binary);
+
+  if (! is)
+    return retval;
+
+  mach_info::float_format flt_fmt = mach_info::native_float_format ();
+
+  for (;;)
+    {
+      bool global = false;
+      octave_value tc;
+      std::string doc;
+
+      std::string name = read_binary_data (is, false, flt_fmt, file,
+                                           global, tc, doc);
+
+      if (name.empty () || tc.is_undefined ())
+        break;
+
+      retval[name] = tc;
+    }
+
+  return retval;
+}
+
+// Create an empty file for the results of a worker and return its
+// name.  The file is created exclusively, so no other process can
+// replace it before the worker writes to it.
+
+static std::string
+make_worker_file (const std::string& who)
+{
+  std::string tmpl
+    = sys::file_ops::concat (sys::env::get_temp_directory (),
+                             "oct-worker-XXXXXX");
+
+  OCTAVE_LOCAL_BUFFER (char, tmp, tmpl.size () + 1);
+  tmpl.copy (tmp, tmpl.size ());
+  tmp[tmpl.size ()] = '\0';
+
+  int fd = octave_mkostemp_wrapper (tmp);
+
+  if (fd < 0)
+    error ("%s: unable to create temporary file for worker process: %s",
+           who.c_str (), std::strerror (errno));
+
+  octave_close_wrapper (fd);
+
+  return std::string (tmp);
+}
+
+// Give each random number generator a new state derived from its
+// current state and STREAM.  Workers are forked with a copy of the
+// state of the parent, so without this they would all draw the same
+// numbers.  Mixing in the previous state keeps the results reproducible
+// after setting the state with rand ("state", ...) and friends.
+
+static void
+reseed_generators (int stream)
+{
+  static const char *dists[]
+    = { "uniform", "normal", "exponential", "poisson", "gamma" };
+
+  std::string current = rand::distribution ();
+
+  for (const char *d : dists)
+    {
+      rand::distribution (d);
+
+      uint32NDArray s = rand::state ();
+      octave_idx_type n = s.numel ();
+
+      s.resize (dim_vector (n + 1, 1));
+      s(n) = stream;
+
+      // A state of unexpected length is hashed into a new one.
+      rand::state (s);
+    }
+
+  rand::distribution (current);
+}
+
+// Call WORK (W, OS) with OS writing to FILE.  This function never
+// returns.
+
+OCTAVE_NORETURN static void
+run_worker (const std::string& who, int w,
+            const std::function<void (int, std::ostream&)>& work,
+            const std::string& file)
+{
+  // The fork handler may not be installed.
+  limit_forked_threads ();
+
+  try
+    {
+      reseed_generators (w + 1);
+
+      std::ofstream os = sys::ofstream (file, std::ios::out
+                                              | std::ios::binary);
+
+      work (w, os);
+
+      write_worker_value (os, status_record, octave_value (0.0));
+
+      os.close ();
+
+      if (! os)
+        error ("%s: unable to write results of worker process",
+               who.c_str ());
+    }
+  catch (const execution_exception& ee)
+    {
+      write_worker_error (file, ee.message (), ee.identifier ());
+    }
+  catch (const interrupt_exception&)
+    {
+      write_worker_error (file, "interrupted", "Octave:interrupt");
+    }
+  catch (const std::bad_alloc&)
+    {
+      write_worker_error (file, "out of memory or dimension too large "
+                          "for Octave's index type", "Octave:bad-alloc");
+    }
+  catch (...)
+    {
+      write_worker_error (file, who + ": worker process failed", "");
+    }
+
+  try
+    {
+      octave_stdout.flush ();
+      std::cout.flush ();
+      std::cerr.flush ();
+    }
+  catch (...)
+    {
+    }
+
+  // Exit without running destructors or atexit handlers, which belong
+  // to the parent process.
+  std::_Exit (0);
+}
+
+std::vector<worker_values>
+run_worker_processes (const std::string& who, int nworkers,
+                      const std::function<void (int, std::ostream&)>& work)
+{
+  static const bool fork_handler_installed = install_fork_handler ();
+
+  octave_unused_parameter (fork_handler_installed);
+
+  std::vector<std::string> files (nworkers);
+  std::vector<pid_t> pids (nworkers, -1);
+
+  unwind_action cleanup_files
+    ([&files] ()
+     {
+       for (const auto& file : files)
+         {
+           if (! file.empty ())
+             sys::unlink (file);
+         }
+     });
+
+  for (int w = 0; w < nworkers; w++)
+    files[w] = make_worker_file (who);
+
+  // Output that is still buffered would otherwise be written again by
+  // each worker.
+
+  octave_stdout.flush ();
+  std::cout.flush ();
+  std::cerr.flush ();
+
+  std::string fork_msg;
+
+  for (int w = 0; w < nworkers; w++)
+    {
+      pid_t pid = sys::fork (fork_msg);
+
+      if (pid == 0)
+        run_worker (who, w, work, files[w]);
+
+      if (pid < 0)
+        break;
+
+      pids[w] = pid;
+    }
+
+  // Later calls must not hand the same streams to their workers again.
+
+  reseed_generators (0);
+
+  for (int w = 0; w < nworkers; w++)
+    {
+      if (pids[w] > 0)
+        {
+          int status = 0;
+
+          while (sys::waitpid (pids[w], &status, 0) < 0 && errno == EINTR)
+            ; // Retry.
+        }
+    }
+
+  octave_quit ();
+
+  for (int w = 0; w < nworkers; w++)
+    {
+      if (pids[w] < 0)
+        error ("%s: unable to start worker process: %s", who.c_str (),
+               fork_msg.c_str ());
+    }
+
+  std::vector<worker_values> retval (nworkers);
+
+  for (int w = 0; w < nworkers; w++)
+    {
+      try
+        {
+          retval[w] = read_worker_values (files[w]);
+        }
+      catch (const execution_exception&)
+        {
+          retval[w].clear ();
+        }
+
+      auto p = retval[w].find (status_record);
+
+      if (p == retval[w].end ())
+        error ("%s: worker process terminated unexpectedly", who.c_str ());
+
+      if (p->second.double_value () != 0)
+        {
+          std::string msg = retval[w][message_record].string_value ();
+          std::string id = retval[w][identifier_record].string_value ();
+
+          if (id.empty ())
+            error ("%s", msg.c_str ());
+          else
+            error_with_id (id.c_str (), "%s", msg.c_str ());
+        }
+
+      retval[w].erase (status_record);
+    }
+
+  return retval;
+}
+
+OCTAVE_END_NAMESPACE(octave)
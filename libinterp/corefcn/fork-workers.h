@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_fork_workers_h)
+#define octave_fork_workers_h 1
+
+#include "octave-config.h"
+
+#include <atomic>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ov.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+class interpreter;
+
+// Values written by a worker process, by name.
+
+typedef std::map<std::string, octave_value> worker_values;
+
+// Hand out the task numbers 0, 1, ..., NTASKS-1 to the processes
+// started by run_worker_processes.  Each task is given to exactly one
+// worker and the tasks are handed out in increasing order, so that a
+// worker that is done early takes over work from the others.  If no
+// memory can be shared with the workers, worker W is statically given
+// the tasks W, W+NWORKERS, W+2*NWORKERS, ... instead.
+
+class OCTINTERP_API worker_task_queue
+{
+public:
+
+  worker_task_queue (octave_idx_type ntasks, int nworkers);
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (worker_task_queue)
+
+  ~worker_task_queue ();
+
+  // Return the next task for worker W, or -1 if there are none left.
+  octave_idx_type next (int w);
+
+  // Don't hand out any more tasks to any worker.
+  void stop ();
+
+private:
+
+  octave_idx_type m_ntasks;
+
+  int m_nworkers;
+
+  // Next task, in memory shared by all workers.
+  std::atomic<octave_idx_type> *m_shared_next;
+
+  // Last task of this process if m_shared_next is null.
+  octave_idx_type m_local_last;
+};
+
+// Return true if the state of INTERP allows running code in copies of
+// this process.  The copies can't interact with the GUI, the debugger,
+// the profiler, or the pager.
+
+extern OCTINTERP_API bool can_fork_workers (interpreter& interp);
+
+// Write VAL named NAME to the results of a worker.  VAL must be a
+// value that can be saved in Octave's binary format.
+
+extern OCTINTERP_API void
+write_worker_value (std::ostream& os, const std::string& name,
+                    const octave_value& val);
+
+// Call WORK (W, OS) in NWORKERS forked copies of this process, for W =
+// 0, ..., NWORKERS-1, and return the values that each of them wrote to
+// OS with write_worker_value.  Any error in a worker is raised again,
+// using WHO in the messages of errors that are not caused by WORK.
+
+extern OCTINTERP_API std::vector<worker_values>
+run_worker_processes (const std::string& who, int nworkers,
+                      const std::function<void (int, std::ostream&)>& work);
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
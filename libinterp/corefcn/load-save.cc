@@ -429,7 +429,7 @@ load_save_system::load_vars (std::istream& stream,
         case MAT5_BINARY:
         case MAT7_BINARY:
           name = read_mat5_binary_element (stream, orig_fname, swap,
-                                           global, tc);
+                                           global, tc, argv, argv_idx, argc);
           break;
 
         default:
@@ -441,6 +441,14 @@ load_save_system::load_vars (std::istream& stream,
         break;
       else
         {
+          // Readers that can skip variables which were not requested
+          // return their name without a value.
+
+          if (! tc.is_defined () && fmt.type () != MAT_ASCII
+              && argv_idx < argc
+              && ! matches_patterns (argv, argv_idx, argc, name))
+            continue;
+
           if (! tc.is_defined ())
             error ("load: unable to load variable '%s'", name.c_str ());
 
@@ -27,6 +27,7 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
 #include <cstring>
 
 #include <iomanip>
@@ -34,6 +35,7 @@
 #include <limits>
 #include <ostream>
 #include <sstream>
+#include <streambuf>
 #include <string>
 #include <vector>
 
@@ -87,6 +89,416 @@
 #define PAD(l) (((l) > 0 && (l) <= 4) ? 4 : (((l)+7)/8)*8)
 #define INT8(l) ((l) == miINT8 || (l) == miUINT8 || (l) == miUTF8)
 
+#if defined (HAVE_ZLIB)
+
+static std::string
+zlib_error_message (int err)
+{
+  switch (err)
+    {
+    case Z_STREAM_END:
+      return "stream end";
+
+    case Z_NEED_DICT:
+      return "need dict";
+
+    case Z_ERRNO:
+      return "errno case";
+
+    case Z_STREAM_ERROR:
+      return "stream error";
+
+    case Z_DATA_ERROR:
+      return "data error";
+
+    case Z_MEM_ERROR:
+      return "mem error";
+
+    case Z_BUF_ERROR:
+      return "buf error";
+
+    case Z_VERSION_ERROR:
+      return "version error";
+
+    default:
+      return "unknown error";
+    }
+}
+
+// Stream buffer that inflates a compressed data element while it is
+// being read.  The compressed data are read from the underlying stream
+// in blocks and large reads are inflated directly into the destination,
+// so neither the compressed nor the uncompressed element has to be held
+// in memory as a whole.  Seeking is only possible forward or within the
+// current buffer, which is all that read_mat5_binary_element needs.
+
+class
+inflate_streambuf : public std::streambuf
+{
+public:
+
+  inflate_streambuf (std::istream& is, std::streamoff compressed_len)
+    : m_is (is), m_remaining (compressed_len), m_zs (),
+      m_in (s_in_size), m_out (s_out_size), m_pos (0), m_done (false),
+      m_err (Z_OK)
+  {
+    m_zs.zalloc = Z_NULL;
+    m_zs.zfree = Z_NULL;
+    m_zs.opaque = Z_NULL;
+    m_zs.next_in = Z_NULL;
+    m_zs.avail_in = 0;
+
+    m_err = inflateInit (&m_zs);
+
+    if (m_err != Z_OK)
+      m_done = true;
+
+    setg (m_out.data (), m_out.data (), m_out.data ());
+  }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (inflate_streambuf)
+
+  ~inflate_streambuf ()
+  {
+    inflateEnd (&m_zs);
+  }
+
+  // Return the zlib error that ended decompression, or Z_OK.
+  int zlib_error () const { return m_err; }
+
+  // Skip any compressed data that have not been used so that the
+  // underlying stream is positioned after the element.  The data are
+  // not inflated.
+  void finish ()
+  {
+    if (m_remaining > 0)
+      {
+        std::streampos pos = m_is.tellg ();
+
+        if (pos != std::streampos (-1))
+          m_is.seekg (pos + m_remaining);
+
+        if (pos == std::streampos (-1) || ! m_is)
+          {
+            m_is.clear ();
+            m_is.ignore (m_remaining);
+          }
+      }
+
+    m_remaining = 0;
+  }
+
+protected:
+
+  int_type underflow ()
+  {
+    if (gptr () < egptr ())
+      return traits_type::to_int_type (*gptr ());
+
+    m_pos += egptr () - eback ();
+
+    std::size_t n = inflate_into (m_out.data (), m_out.size ());
+
+    setg (m_out.data (), m_out.data (), m_out.data () + n);
+
+    return n > 0 ? traits_type::to_int_type (*gptr ()) : traits_type::eof ();
+  }
+
+  std::streamsize xsgetn (char *s, std::streamsize n)
+  {
+    std::streamsize nread = 0;
+
+    while (nread < n)
+      {
+        std::streamsize avail = egptr () - gptr ();
+
+        if (avail > 0)
+          {
+            std::streamsize k = std::min (avail, n - nread);
+            std::memcpy (s + nread, gptr (), k);
+            gbump (static_cast<int> (k));
+            nread += k;
+          }
+        else if (n - nread >= static_cast<std::streamsize> (m_out.size ()))
+          {
+            // Large read: bypass the buffer.
+            m_pos += egptr () - eback ();
+            setg (m_out.data (), m_out.data (), m_out.data ());
+
+            std::size_t k = inflate_into (s + nread, n - nread);
+            if (k == 0)
+              break;
+
+            m_pos += k;
+            nread += k;
+          }
+        else if (traits_type::eq_int_type (underflow (), traits_type::eof ()))
+          break;
+      }
+
+    return nread;
+  }
+
+  pos_type seekoff (off_type off, std::ios_base::seekdir dir,
+                    std::ios_base::openmode which = std::ios_base::in)
+  {
+    if (which & std::ios_base::out)
+      return pos_type (off_type (-1));
+
+    off_type cur = m_pos + (gptr () - eback ());
+
+    if (dir == std::ios_base::beg)
+      return seek_to (off);
+    else if (dir == std::ios_base::cur)
+      return seek_to (cur + off);
+    else
+      return pos_type (off_type (-1));
+  }
+
+  pos_type seekpos (pos_type pos,
+                    std::ios_base::openmode which = std::ios_base::in)
+  {
+    if (which & std::ios_base::out)
+      return pos_type (off_type (-1));
+
+    return seek_to (off_type (pos));
+  }
+
+private:
+
+  pos_type seek_to (off_type target)
+  {
+    if (target < m_pos)
+      return pos_type (off_type (-1));
+
+    for (;;)
+      {
+        off_type end = m_pos + (egptr () - eback ());
+
+        if (target <= end)
+          {
+            setg (eback (), eback () + (target - m_pos), egptr ());
+            return pos_type (target);
+          }
+
+        setg (eback (), egptr (), egptr ());
+
+        if (traits_type::eq_int_type (underflow (), traits_type::eof ()))
+          return pos_type (off_type (-1));
+      }
+  }
+
+  // Inflate up to LEN bytes into DST and return the number of bytes
+  // produced.  Return 0 at the end of the compressed data or on error.
+  std::size_t inflate_into (char *dst, std::size_t len)
+  {
+    if (m_done)
+      return 0;
+
+    uInt out_len = static_cast<uInt>
+      (std::min (len, static_cast<std::size_t>
+                        (std::numeric_limits<uInt>::max ())));
+
+    m_zs.next_out = reinterpret_cast<Bytef *> (dst);
+    m_zs.avail_out = out_len;
+
+    while (m_zs.avail_out > 0)
+      {
+        if (m_zs.avail_in == 0 && m_remaining > 0)
+          {
+            std::streamsize n
+              = std::min (static_cast<std::streamoff> (m_in.size ()),
+                          m_remaining);
+
+            m_is.read (m_in.data (), n);
+            n = m_is.gcount ();
+
+            m_remaining = (n > 0 ? m_remaining - n : 0);
+
+            m_zs.next_in = reinterpret_cast<Bytef *> (m_in.data ());
+            m_zs.avail_in = static_cast<uInt> (n);
+          }
+
+        int err = inflate (&m_zs, Z_NO_FLUSH);
+
+        if (err == Z_STREAM_END)
+          {
+            m_done = true;
+            break;
+          }
+        else if (err == Z_BUF_ERROR)
+          {
+            // No progress is possible.  Some files end the compressed
+            // data without a proper end of stream marker, so this is
+            // only an error if the data that were read are incomplete.
+            m_done = true;
+            break;
+          }
+        else if (err != Z_OK)
+          {
+            m_err = err;
+            m_done = true;
+            break;
+          }
+      }
+
+    return out_len - m_zs.avail_out;
+  }
+
+  static const std::size_t s_in_size = 256 * 1024;
+  static const std::size_t s_out_size = 64 * 1024;
+
+  std::istream& m_is;
+
+  // Number of compressed bytes not yet read from m_is.
+  std::streamoff m_remaining;
+
+  z_stream m_zs;
+
+  std::vector<char> m_in;
+  std::vector<char> m_out;
+
+  // Position in the uncompressed data of the start of the get area.
+  off_type m_pos;
+
+  bool m_done;
+
+  int m_err;
+};
+
+// Size of the blocks that are compressed independently when saving
+// large variables.
+
+static const std::size_t deflate_block_size = 1024 * 1024;
+
+// Compress LEN bytes of SRC into a single zlib stream in DEST by
+// deflating blocks of the input in parallel.  Each block is primed with
+// the last 32 KiB of the preceding block, so the compression ratio is
+// almost that of a serial stream.  All blocks but the last end with a
+// sync flush so that they can simply be concatenated.  The checksum is
+// combined from the checksums of the blocks.  Return false if zlib
+// fails, in which case the caller compresses serially.
+
+static bool
+deflate_blocks (const char *src, std::size_t len, std::string& dest)
+{
+  octave_idx_type nblocks = (len + deflate_block_size - 1) / deflate_block_size;
+
+  // Allocate everything before entering the parallel region.
+  std::vector<std::string> out (nblocks);
+  std::vector<std::size_t> out_len (nblocks, 0);
+  std::vector<uLong> check (nblocks, 0);
+
+  for (octave_idx_type i = 0; i < nblocks; i++)
+    out[i].resize (compressBound (deflate_block_size) + 16);
+
+  bool ok = true;
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp parallel for reduction (&& : ok)
+#endif
+  for (octave_idx_type i = 0; i < nblocks; i++)
+    {
+      std::size_t offset = i * deflate_block_size;
+      std::size_t n = std::min (deflate_block_size, len - offset);
+      const Bytef *in = reinterpret_cast<const Bytef *> (src + offset);
+      bool last = (i == nblocks - 1);
+
+      check[i] = adler32 (adler32 (0, Z_NULL, 0), in, n);
+
+      z_stream zs;
+      zs.zalloc = Z_NULL;
+      zs.zfree = Z_NULL;
+      zs.opaque = Z_NULL;
+
+      if (deflateInit2 (&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS,
+                        8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+          ok = false;
+          continue;
+        }
+
+      if (offset > 0)
+        {
+          std::size_t dict_len = std::min<std::size_t> (offset, 32768);
+          deflateSetDictionary (&zs, in - dict_len, dict_len);
+        }
+
+      zs.next_in = const_cast<Bytef *> (in);
+      zs.avail_in = n;
+      zs.next_out = reinterpret_cast<Bytef *> (&out[i][0]);
+      zs.avail_out = out[i].size ();
+
+      int err = deflate (&zs, last ? Z_FINISH : Z_SYNC_FLUSH);
+
+      if (err != (last ? Z_STREAM_END : Z_OK)
+          || zs.avail_in != 0 || zs.avail_out == 0)
+        ok = false;
+
+      out_len[i] = out[i].size () - zs.avail_out;
+
+      deflateEnd (&zs);
+    }
+
+  if (! ok)
+    return false;
+
+  uLong adler = check[0];
+  std::size_t total = 6;
+
+  for (octave_idx_type i = 0; i < nblocks; i++)
+    {
+      if (i > 0)
+        {
+          std::size_t n = std::min (deflate_block_size,
+                                    len - i * deflate_block_size);
+          adler = adler32_combine (adler, check[i], n);
+        }
+
+      total += out_len[i];
+    }
+
+  dest.clear ();
+  dest.reserve (total);
+
+  // zlib header for the default compression level and a 32 KiB window.
+  dest.push_back ('\x78');
+  dest.push_back ('\x9c');
+
+  for (octave_idx_type i = 0; i < nblocks; i++)
+    dest.append (out[i], 0, out_len[i]);
+
+  for (int shift = 24; shift >= 0; shift -= 8)
+    dest.push_back (static_cast<char> ((adler >> shift) & 0xff));
+
+  return true;
+}
+
+// Compress SRC in zlib format into DEST.  Large buffers are compressed
+// in parallel blocks if OpenMP is available.
+
+static void
+compress_mat5_element (const std::string& src, std::string& dest)
+{
+#if defined (OCTAVE_ENABLE_OPENMP)
+  if (src.length () >= 4 * deflate_block_size
+      && deflate_blocks (src.data (), src.length (), dest))
+    return;
+#endif
+
+  uLongf dest_len = compressBound (src.length ());
+  dest.resize (dest_len);
+
+  if (compress (reinterpret_cast<Bytef *> (&dest[0]), &dest_len,
+                reinterpret_cast<const Bytef *> (src.data ()), src.length ())
+      != Z_OK)
+    error ("save: error compressing data element");
+
+  dest.resize (dest_len);
+}
+
+#endif
+
 
 // The subsystem data block
 static octave_value subsys_ov;
@@ -478,6 +890,22 @@ read_int (std::istream& is, bool swap, int32_t& val)
 std::string
 read_mat5_binary_element (std::istream& is, const std::string& filename,
                           bool swap, bool& global, octave_value& tc)
+{
+  return read_mat5_binary_element (is, filename, swap, global, tc,
+                                   string_vector (), 0, 0);
+}
+
+// If ARGV(ARGV_IDX:ARGC-1) is not empty, only elements whose name
+// matches one of these patterns are decoded.  For other elements, only
+// the header is read, the rest of the element is skipped and TC is left
+// undefined.  This is a seek on the file, and compressed elements are
+// only inflated up to the name, so selecting a few variables from a
+// large file does not require reading or inflating the whole file.
+
+std::string
+read_mat5_binary_element (std::istream& is, const std::string& filename,
+                          bool swap, bool& global, octave_value& tc,
+                          const string_vector& argv, int argv_idx, int argc)
 {
   std::string retval;
 
@@ -518,95 +946,33 @@ read_mat5_binary_element (std::istream& is, const std::string& filename,
   if (type == miCOMPRESSED)
     {
 #if defined (HAVE_ZLIB)
-      // If C++ allowed us direct access to the file descriptor of an
-      // ifstream in a uniform way, the code below could be vastly
-      // simplified, and additional copies of the data in memory
-      // wouldn't be needed.
-
-      OCTAVE_LOCAL_BUFFER (char, inbuf, element_length);
-      is.read (inbuf, element_length);
-
-      // We uncompress the first 8 bytes of the header to get the buffer length
-      // This will fail with an error Z_MEM_ERROR
-      uLongf destLen = 8;
-      uLongf elt_len = element_length;
-      OCTAVE_LOCAL_BUFFER (unsigned int, tmp, 2);
-      if (uncompress2 (reinterpret_cast<Bytef *> (tmp), &destLen,
-                       reinterpret_cast<Bytef *> (inbuf), &elt_len)
-          == Z_MEM_ERROR)
-        error ("load: error probing size of compressed data element");
-
-      // Why should I have to initialize outbuf as I'll just overwrite!!
-      if (swap)
-        swap_bytes<4> (tmp, 2);
+      // Decompress the element while it is parsed instead of reading
+      // and inflating it completely first.
 
-      destLen = tmp[1] + 8;
-      std::string outbuf (destLen, ' ');
+      inflate_streambuf zbuf (is, element_length);
+      std::istream gz_is (&zbuf);
 
-      // FIXME: find a way to avoid casting away const here!
-
-      elt_len = element_length;
-      int err = uncompress2 (reinterpret_cast<Bytef *>
-                             (const_cast<char *> (outbuf.c_str ())),
-                             &destLen, reinterpret_cast<Bytef *> (inbuf),
-                             &elt_len);
-
-      // Ignore buffer error if we have consumed all the input buffer
-      // and uncompressing the data generated as many bytes of output as
-      // we were expecting given the data element size that was stored
-      // in the Matlab data element header.
-      if (err == Z_BUF_ERROR && destLen == tmp[1] + 8
-          && elt_len == static_cast<uLongf> (element_length))
-        err = Z_OK;
-
-      if (err != Z_OK)
+      try
         {
-          std::string msg;
-          switch (err)
-            {
-            case Z_STREAM_END:
-              msg = "stream end";
-              break;
-
-            case Z_NEED_DICT:
-              msg = "need dict";
-              break;
-
-            case Z_ERRNO:
-              msg = "errno case";
-              break;
-
-            case Z_STREAM_ERROR:
-              msg = "stream error";
-              break;
-
-            case Z_DATA_ERROR:
-              msg = "data error";
-              break;
-
-            case Z_MEM_ERROR:
-              msg = "mem error";
-              break;
-
-            case Z_BUF_ERROR:
-              msg = "buf error";
-              break;
-
-            case Z_VERSION_ERROR:
-              msg = "version error";
-              break;
-            }
-
-          error ("load: error uncompressing data element (%s from zlib)",
-                 msg.c_str ());
+          retval = read_mat5_binary_element (gz_is, filename, swap,
+                                             global, tc, argv, argv_idx,
+                                             argc);
         }
-      else
+      catch (const octave::execution_exception&)
         {
-          std::istringstream gz_is (outbuf);
-          retval = read_mat5_binary_element (gz_is, filename,
-                                             swap, global, tc);
+          if (zbuf.zlib_error () != Z_OK)
+            error ("load: error uncompressing data element (%s from zlib)",
+                   zlib_error_message (zbuf.zlib_error ()).c_str ());
+
+          throw;
         }
 
+      if (zbuf.zlib_error () != Z_OK)
+        error ("load: error uncompressing data element (%s from zlib)",
+               zlib_error_message (zbuf.zlib_error ()).c_str ());
+
+      zbuf.finish ();
+
       return retval;
 
 #else
@@ -713,6 +1079,45 @@ read_mat5_binary_element (std::istream& is, const std::string& filename,
     retval = name;
   }
 
+  if (argv_idx < argc && ! retval.empty ())
+    {
+      bool found = false;
+
+      for (int i = argv_idx; i < argc; i++)
+        {
+          glob_match pattern (argv[i]);
+
+          if (pattern.match (retval))
+            {
+              found = true;
+              break;
+            }
+        }
+
+      if (! found)
+        {
+          // The rest of a compressed element is skipped by the caller
+          // on the underlying stream, without inflating it.
+
+          bool compressed = false;
+
+#if defined (HAVE_ZLIB)
+          compressed = (dynamic_cast<inflate_streambuf *> (is.rdbuf ())
+                        != nullptr);
+#endif
+
+          if (! compressed)
+            {
+              is.seekg (pos + static_cast<std::streamoff> (element_length));
+
+              if (is.eof ())
+                is.clear ();
+            }
+
+          return retval;
+        }
+    }
+
   switch (arrayclass)
     {
     case MAT_FILE_CELL_CLASS:
@@ -2390,23 +2795,14 @@ save_mat5_binary_element (std::ostream& os,
 
       if (ret)
         {
-          // destLen must be at least 0.1% larger than source buffer
-          // + 12 bytes.  Reality is it must be larger again than that.
-          std::string buf_str = buf.str ();
-          uLongf srcLen = buf_str.length ();
-          uLongf destLen = compressBound (srcLen);
-          OCTAVE_LOCAL_BUFFER (char, out_buf, destLen);
-
-          if (compress (reinterpret_cast<Bytef *> (out_buf), &destLen,
-                        reinterpret_cast<const Bytef *> (buf_str.c_str ()),
-                        srcLen)
-              != Z_OK)
-            error ("save: error compressing data element");
+          std::string out_buf;
+
+          compress_mat5_element (buf.str (), out_buf);
 
           write_mat5_tag (os, miCOMPRESSED,
-                          static_cast<octave_idx_type> (destLen));
+                          static_cast<octave_idx_type> (out_buf.length ()));
 
-          os.write (out_buf, destLen);
+          os.write (out_buf.data (), out_buf.length ());
         }
 
       return ret;
@@ -32,6 +32,7 @@
 #include <string>
 
 class octave_value;
+class string_vector;
 
 enum mat5_data_type
 {
@@ -62,6 +63,10 @@ read_mat5_binary_file_header (std::istream& is, bool& swap,
 extern OCTINTERP_API std::string
 read_mat5_binary_element (std::istream& is, const std::string& filename,
                           bool swap, bool& global, octave_value& tc);
+extern OCTINTERP_API std::string
+read_mat5_binary_element (std::istream& is, const std::string& filename,
+                          bool swap, bool& global, octave_value& tc,
+                          const string_vector& argv, int argv_idx, int argc);
 extern OCTINTERP_API bool
 save_mat5_binary_element (std::ostream& os,
                           const octave_value& tc, const std::string& name,
@@ -36,6 +36,7 @@
 #include "ovl.h"
 #include "ov-re-sparse.h"
 #include "ov-cx-sparse.h"
+#include "sparse-xdiv.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
@@ -241,7 +242,11 @@ permutation information.
           else
             {
               retval.resize (scale ? 5 : 4);
-              math::sparse_lu<SparseMatrix> fact (m, thresh, scale);
+              MatrixType typ = arg.matrix_type ();
+              math::sparse_lu<SparseMatrix>
+                fact (m, thresh, scale,
+                      sparse_symbolic_analysis (m, typ).get ());
+              arg.matrix_type (typ);
 
               retval(0) = octave_value (fact.L (),
                                         MatrixType (MatrixType::Lower));
@@ -308,7 +313,11 @@ permutation information.
           else
             {
               retval.resize (scale ? 5 : 4);
-              math::sparse_lu<SparseComplexMatrix> fact (m, thresh, scale);
+              MatrixType typ = arg.matrix_type ();
+              math::sparse_lu<SparseComplexMatrix>
+                fact (m, thresh, scale,
+                      sparse_symbolic_analysis (m, typ).get ());
+              arg.matrix_type (typ);
 
               retval(0) = octave_value (fact.L (),
                                         MatrixType (MatrixType::Lower));
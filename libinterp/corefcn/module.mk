@@ -37,6 +37,7 @@ COREFCN_INC = \
   %reldir%/event-queue.h \
   %reldir%/fcn-info.h \
   %reldir%/file-io.h \
+  %reldir%/fork-workers.h \
   %reldir%/ft-text-renderer.h \
   %reldir%/gh-manager.h \
   %reldir%/gl-render.h \
@@ -126,8 +127,11 @@ COREFCN_SRC = \
   %reldir%/__isprimelarge__.cc \
   %reldir%/__lin_interpn__.cc \
   %reldir%/__magick_read__.cc \
+  %reldir%/__movstat__.cc \
   %reldir%/__pchip_deriv__.cc \
   %reldir%/__qp__.cc \
+  %reldir%/__set_index__.cc \
+  %reldir%/__stats__.cc \
   %reldir%/amd.cc \
   %reldir%/auto-shlib.cc \
   %reldir%/balance.cc \
@@ -174,6 +178,7 @@ COREFCN_SRC = \
   %reldir%/file-io.cc \
   %reldir%/filter.cc \
   %reldir%/find.cc \
+  %reldir%/fork-workers.cc \
   %reldir%/ft-text-renderer.cc \
   %reldir%/gcd.cc \
   %reldir%/getgrent.cc \
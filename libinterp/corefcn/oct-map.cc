@@ -27,6 +27,10 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
+#include <string>
+#include <utility>
+
 #include "Array-util.h"
 #include "error.h"
 #include "oct-locbuf.h"
@@ -35,6 +39,32 @@
 #include "oct-map.h"
 #include "utils.h"
 
+static bool
+field_name_less (const std::pair<std::string, octave_idx_type>& fi,
+                 const std::string& key)
+{
+  return fi.first < key;
+}
+
+octave_fields::fields_rep::const_iterator
+octave_fields::fields_rep::find (const std::string& k) const
+{
+  auto p = std::lower_bound (begin (), end (), k, field_name_less);
+
+  return (p != end () && p->first == k) ? p : end ();
+}
+
+octave_idx_type&
+octave_fields::fields_rep::insert (const std::string& k, octave_idx_type n)
+{
+  auto p = std::lower_bound (begin (), end (), k, field_name_less);
+
+  if (p == end () || p->first != k)
+    p = std::vector<field_index>::insert (p, field_index (k, n));
+
+  return p->second;
+}
+
 octave_fields::fields_rep *
 octave_fields::nil_rep ()
 {
@@ -47,7 +77,7 @@ octave_fields::octave_fields (const string_vector& fields)
 {
   octave_idx_type n = fields.numel ();
   for (octave_idx_type i = 0; i < n; i++)
-    (*m_rep)[fields(i)] = i;
+    m_rep->insert (fields(i), i) = i;
 }
 
 octave_fields::octave_fields (const char *const *fields)
@@ -55,7 +85,10 @@ octave_fields::octave_fields (const char *const *fields)
 {
   octave_idx_type n = 0;
   while (*fields)
-    (*m_rep)[std::string (*fields++)] = n++;
+    {
+      m_rep->insert (std::string (*fields++), n) = n;
+      n++;
+    }
 }
 
 bool
@@ -81,7 +114,7 @@ octave_fields::getfield (const std::string& field)
     {
       make_unique ();
       octave_idx_type n = m_rep->size ();
-      return (*m_rep)[field] = n;
+      return m_rep->insert (field, n);
     }
 }
 
@@ -95,7 +128,7 @@ octave_fields::rmfield (const std::string& field)
     {
       octave_idx_type n = p->second;
       make_unique ();
-      m_rep->erase (field);
+      m_rep->erase (m_rep->find (field));
       for (auto& fld_idx : *m_rep)
         {
           if (fld_idx.second >= n)
@@ -30,6 +30,9 @@
 
 #include <algorithm>
 #include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "oct-refcount.h"
 
@@ -42,19 +45,32 @@ class string_vector;
 class OCTINTERP_API
 octave_fields
 {
-  class fields_rep : public std::map<std::string, octave_idx_type>
+  // The fields are kept in a vector sorted by name.  Structs rarely have
+  // more than a few dozen fields, so a binary search over contiguous
+  // memory finds a field faster than walking a tree, and copying the
+  // fields when a shared struct is modified takes a single allocation.
+
+  typedef std::pair<std::string, octave_idx_type> field_index;
+
+  class fields_rep : public std::vector<field_index>
   {
   public:
 
-    fields_rep () : std::map<std::string, octave_idx_type> (), m_count (1) { }
+    fields_rep () : std::vector<field_index> (), m_count (1) { }
 
     fields_rep (const fields_rep& other)
-      : std::map<std::string, octave_idx_type> (other), m_count (1) { }
+      : std::vector<field_index> (other), m_count (1) { }
 
     fields_rep& operator = (const fields_rep&) = delete;
 
     ~fields_rep () = default;
 
+    // Return the entry for K, or end () if there is none.
+    const_iterator find (const std::string& k) const;
+
+    // Return the index of K, adding K with index N if it is not present.
+    octave_idx_type& insert (const std::string& k, octave_idx_type n);
+
     octave::refcount<octave_idx_type> m_count;
   };
 
@@ -105,7 +121,7 @@ public:
 
   // constant iteration support. non-const iteration intentionally unsupported.
 
-  typedef std::map<std::string, octave_idx_type>::const_iterator const_iterator;
+  typedef std::vector<field_index>::const_iterator const_iterator;
   typedef const_iterator iterator;
 
   const_iterator begin () const { return m_rep->begin (); }
@@ -29,6 +29,9 @@
 
 #include <cassert>
 #include <cctype>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 
 #include <algorithm>
@@ -1172,23 +1175,129 @@ printf_format_list::printme () const
     }
 }
 
-// Calculate x^n.  Used for ...e+nn so that, for example, 1e2 is
-// exactly 100 and 5e-1 is 1/2
+// Accumulate the decimal digits of a number as textscan reads them and
+// convert the result to the nearest double.  Up to 19 significant
+// digits are kept exactly in an integer mantissa, and any further
+// digits as text.  Numbers with at most 15 significant digits and a
+// small decimal exponent are converted with a single exact
+// multiplication or division, which is correctly rounded.  All others
+// are passed to strtod with all of their digits.  Unlike scaling by
+// repeated multiplication with 0.1, this produces the same double as
+// the compiler for any input, and it does not depend on the locale.
 
-static double
-pown (double x, unsigned int n)
+class
+decimal_accumulator
 {
-  double retval = 1;
+public:
+
+  decimal_accumulator ()
+    : m_mant (0), m_ndigits (0), m_exp10 (0), m_tail (), m_truncated (false)
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (decimal_accumulator)
+
+  ~decimal_accumulator () = default;
+
+  void add_int_digit (int ch)
+  {
+    if (! push (ch - '0'))
+      m_exp10++;
+  }
+
+  void add_frac_digit (int ch)
+  {
+    if (push (ch - '0'))
+      m_exp10--;
+  }
+
+  // Add one unit in the position of the last digit read.
+  void round_up ()
+  {
+    for (auto p = m_tail.rbegin (); p != m_tail.rend (); p++)
+      {
+        m_truncated = true;
+
+        if (*p != '9')
+          {
+            (*p)++;
+            return;
+          }
+
+        *p = '0';
+      }
+
+    m_mant++;
+  }
+
+  void scale (int exp10) { m_exp10 += exp10; }
 
-  for (unsigned int d = n; d; d >>= 1)
+  double value () const
+  {
+    static const double pow10[] =
     {
-      if (d & 1)
-        retval *= x;
-      x *= x;
-    }
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+      1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+      1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
 
-  return retval;
-}
+    if (m_mant == 0 && ! m_truncated)
+      return 0;
+
+    if (! m_truncated && m_mant <= (static_cast<uint64_t> (1) << 53)
+        && m_exp10 >= -22 && m_exp10 <= 22)
+      {
+        double mant = static_cast<double> (m_mant);
+
+        return (m_exp10 < 0 ? mant / pow10[-m_exp10]
+                            : mant * pow10[m_exp10]);
+      }
+
+    if (! m_truncated)
+      {
+        char buf[48];
+        std::snprintf (buf, sizeof (buf), "%" PRIu64 "e%d", m_mant, m_exp10);
+
+        return std::strtod (buf, nullptr);
+      }
+
+    // The digits beyond the mantissa decide the rounding of numbers
+    // that are close to halfway between two doubles.
+
+    std::string buf = std::to_string (m_mant) + m_tail + 'e'
+                      + std::to_string (m_exp10
+                                        - static_cast<int> (m_tail.size ()));
+
+    return std::strtod (buf.c_str (), nullptr);
+  }
+
+private:
+
+  // Append digit D to the mantissa if there is room for it.  Return
+  // false if the digit was kept in the tail instead.
+  bool push (int d)
+  {
+    if (m_ndigits < 19)
+      {
+        m_mant = m_mant * 10 + d;
+        if (m_mant)
+          m_ndigits++;
+        return true;
+      }
+
+    m_tail += static_cast<char> ('0' + d);
+
+    if (d)
+      m_truncated = true;
+
+    return false;
+  }
+
+  uint64_t m_mant;
+  int m_ndigits;
+  int m_exp10;
+  std::string m_tail;
+  bool m_truncated;
+};
 
 static Cell
 init_inf_nan ()
@@ -2787,6 +2896,7 @@ textscan::read_double (delimited_stream& is,
   int sign = 1;
   unsigned int width_left = fmt.width;
   double retval = 0;
+  decimal_accumulator digits;
   bool valid = false;         // syntactically correct double?
 
   int ch = is.peek_undelim ();
@@ -2813,14 +2923,13 @@ textscan::read_double (delimited_stream& is,
       if (ch >= '0' && ch <= '9')       // valid if at least one digit
         valid = true;
       while (width_left-- && is && (ch = is.get ()) >= '0' && ch <= '9')
-        retval = retval * 10 + (ch - '0');
+        digits.add_int_digit (ch);
       width_left++;
     }
 
   // Read fractional part, up to specified precision
   if (ch == '.' && width_left)
     {
-      double multiplier = 1;
       int precision = fmt.prec;
       int i;
 
@@ -2835,7 +2944,7 @@ textscan::read_double (delimited_stream& is,
       for (i = 0; i < precision; i++)
         {
           if (width_left-- && is && (ch = is.get ()) >= '0' && ch <= '9')
-            retval += (ch - '0') * (multiplier *= 0.1);
+            digits.add_frac_digit (ch);
           else
             {
               width_left++;
@@ -2846,7 +2955,7 @@ textscan::read_double (delimited_stream& is,
       // round up if we truncated and the next digit is >= 5
       if ((i == precision || ! width_left) && (ch = is.get ()) >= '5'
           && ch <= '9')
-        retval += multiplier;
+        digits.round_up ();
 
       if (i > 0)
         valid = true;           // valid if at least one digit after '.'
@@ -2889,18 +2998,16 @@ textscan::read_double (delimited_stream& is,
           valid = false;
           while (width_left-- && is && (ch = is.get_undelim ()) >= '0' && ch <= '9')
             {
-              exp = exp*10 + ch - '0';
+              // Saturate exponents that overflow or underflow anyway.
+              if (exp < 100000)
+                exp = exp*10 + ch - '0';
               valid = true;
             }
           width_left++;
           if (ch != std::istream::traits_type::eof () && width_left)
             is.putback (ch);
 
-          double multiplier = pown (10, exp);
-          if (exp_sign > 0)
-            retval *= multiplier;
-          else
-            retval /= multiplier;
+          digits.scale (exp_sign * exp);
 
           used_exp = true;
         }
@@ -2909,6 +3016,8 @@ textscan::read_double (delimited_stream& is,
   if (! used_exp && ch != std::istream::traits_type::eof () && width_left)
     is.putback (ch);
 
+  retval = digits.value ();
+
   // Check for +/- inf and NaN
   if (! valid && width_left >= 3 && is.remaining () >= 3)
     {
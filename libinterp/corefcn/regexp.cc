@@ -358,29 +358,19 @@ parse_options (regexp::opts& options, const octave_value_list& args,
     }
 }
 
+// Match BUFFER with the compiled expression RX and return the values
+// requested by the options in ARGS.
+
 static octave_value_list
-octregexp (const octave_value_list& args, int nargout,
-           const std::string& who, bool case_insensitive = false)
+octregexp (const regexp& rx, const std::string& buffer,
+           const regexp::opts& options, bool extra_options,
+           const octave_value_list& args, int nargout)
 {
   octave_value_list retval;
 
   int nargin = args.length ();
 
-  // Make sure we have string, pattern
-  const std::string buffer = args(0).string_value ();
-
-  std::string pattern = args(1).string_value ();
-
-  // Rewrite pattern for PCRE
-  pattern = do_regexp_ptn_string_escapes (pattern, args(1).is_sq_string ());
-
-  regexp::opts options;
-  options.case_insensitive (case_insensitive);
-  bool extra_options = false;
-  parse_options (options, args, who, 2, extra_options);
-
-  const regexp::match_data rx_lst
-    = regexp::match (pattern, buffer, options, who);
+  const regexp::match_data rx_lst = rx.match (buffer);
 
   string_vector named_pats = rx_lst.named_patterns ();
 
@@ -542,6 +532,72 @@ octregexp (const octave_value_list& args, int nargout,
   return retval;
 }
 
+static regexp
+octregexp_compile (const octave_value& pat, const octave_value_list& args,
+                   const std::string& who, bool case_insensitive,
+                   regexp::opts& options, bool& extra_options)
+{
+  std::string pattern = pat.string_value ();
+
+  // Rewrite pattern for PCRE
+  pattern = do_regexp_ptn_string_escapes (pattern, pat.is_sq_string ());
+
+  options.case_insensitive (case_insensitive);
+  extra_options = false;
+  parse_options (options, args, who, 2, extra_options);
+
+  return regexp (pattern, options, who);
+}
+
+static octave_value_list
+octregexp (const octave_value_list& args, int nargout,
+           const std::string& who, bool case_insensitive = false)
+{
+  // Make sure we have string, pattern
+  const std::string buffer = args(0).string_value ();
+
+  regexp::opts options;
+  bool extra_options;
+  regexp rx = octregexp_compile (args(1), args, who, case_insensitive,
+                                 options, extra_options);
+
+  return octregexp (rx, buffer, options, extra_options, args, nargout);
+}
+
+// Match each string in CELLSTR with the single pattern PAT.  The
+// pattern is compiled once and reused for all elements.
+
+static void
+octcellregexp_strings (Cell *newretval, const Cell& cellstr,
+                       const octave_value& pat,
+                       const octave_value_list& args, int nargout,
+                       const std::string& who, bool case_insensitive)
+{
+  for (int j = 0; j < nargout; j++)
+    newretval[j].resize (cellstr.dims ());
+
+  octave_idx_type n = cellstr.numel ();
+
+  if (n == 0)
+    return;
+
+  regexp::opts options;
+  bool extra_options;
+  regexp rx = octregexp_compile (pat, args, who, case_insensitive,
+                                 options, extra_options);
+
+  for (octave_idx_type i = 0; i < n; i++)
+    {
+      const std::string buffer = cellstr(i).string_value ();
+
+      octave_value_list tmp = octregexp (rx, buffer, options, extra_options,
+                                         args, nargout);
+
+      for (int j = 0; j < nargout; j++)
+        newretval[j](i) = tmp(j);
+    }
+}
+
 static octave_value_list
 octcellregexp (const octave_value_list& args, int nargout,
                const std::string& who, bool case_insensitive = false)
@@ -558,22 +614,8 @@ octcellregexp (const octave_value_list& args, int nargout,
           Cell cellpat = args(1).cell_value ();
 
           if (cellpat.numel () == 1)
-            {
-              for (int j = 0; j < nargout; j++)
-                newretval[j].resize (cellstr.dims ());
-
-              new_args(1) = cellpat(0);
-
-              for (octave_idx_type i = 0; i < cellstr.numel (); i++)
-                {
-                  new_args(0) = cellstr(i);
-                  octave_value_list tmp = octregexp (new_args, nargout, who,
-                                                     case_insensitive);
-
-                  for (int j = 0; j < nargout; j++)
-                    newretval[j](i) = tmp(j);
-                }
-            }
+            octcellregexp_strings (newretval, cellstr, cellpat(0), args,
+                                   nargout, who, case_insensitive);
           else if (cellstr.numel () == 1)
             {
               for (int j = 0; j < nargout; j++)
@@ -615,20 +657,8 @@ octcellregexp (const octave_value_list& args, int nargout,
             error ("regexp: cell array arguments must be scalar or equal size");
         }
       else
-        {
-          for (int j = 0; j < nargout; j++)
-            newretval[j].resize (cellstr.dims ());
-
-          for (octave_idx_type i = 0; i < cellstr.numel (); i++)
-            {
-              new_args(0) = cellstr(i);
-              octave_value_list tmp = octregexp (new_args, nargout, who,
-                                                 case_insensitive);
-
-              for (int j = 0; j < nargout; j++)
-                newretval[j](i) = tmp(j);
-            }
-        }
+        octcellregexp_strings (newretval, cellstr, args(1), args, nargout,
+                               who, case_insensitive);
 
       for (int j = 0; j < nargout; j++)
         retval(j) = octave_value (newretval[j]);
@@ -1208,6 +1238,31 @@ size) with successive @code{regexp} searches.
 %!assert <*62705> (regexpi ('<n>', '\(?<n\>\)?'), 1)
 %!assert <62705> (regexpi ('<n>a', '\(?<n\>a\)?'), 1)
 
+## Compiled patterns are reused across cell elements and calls
+%!test
+%! str = arrayfun (@(i) sprintf ("id=%d name=n%d", i, 2*i), 1:200,
+%!                 "uniformoutput", false);
+%! nm = regexp (str, 'id=(?<id>\d+) name=(?<name>\w+)', "names");
+%! assert (size (nm), [1, 200]);
+%! assert (nm{1}, struct ("id", "1", "name", "n2"));
+%! assert (nm{200}, struct ("id", "200", "name", "n400"));
+%! nm = regexp (str(1:2), {'id=(?<id>\d+) name=(?<name>\w+)'}, "names");
+%! assert (nm{2}, struct ("id", "2", "name", "n4"));
+
+%!test
+%! assert (regexp ("aBc", 'b', "match"), cell (1, 0));
+%! assert (regexp ("aBc", 'b', "match", "ignorecase"), {"B"});
+%! assert (regexp ("aBc", 'b', "match"), cell (1, 0));
+%! assert (regexp ("x1y2", '(?<d>\d)', "names"), struct ("d", {"1", "2"}));
+%! assert (regexp ("x1y2", '(?<d>\d)', "names"), struct ("d", {"1", "2"}));
+
+## Deeply nested matches fall back from JIT to the interpreter
+%!test
+%! str = [repmat("ab", 1, 50000), "c"];
+%! for i = 1:20
+%!   assert (regexp (str, '(a|b)*c', "once"), 1);
+%! endfor
+
 ## Test input validation
 %!error regexp ('string', 'tri', 'BadArg')
 %!error regexp ('string')
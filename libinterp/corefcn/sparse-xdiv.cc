@@ -27,7 +27,10 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
+#include <vector>
 
 #include "Array-util.h"
 #include "lo-array-errwarn.h"
@@ -35,6 +38,8 @@
 #include "quit.h"
 #include "error.h"
 #include "lo-ieee.h"
+#include "sparse-lu.h"
+#include "unwind-prot.h"
 
 #include "dSparse.h"
 #include "dDiagMatrix.h"
@@ -43,8 +48,115 @@
 #include "oct-spparms.h"
 #include "sparse-xdiv.h"
 
+#include "defun.h"
+#include "interpreter-private.h"
+#include "pt-eval.h"
+#include "variables.h"
+
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+// If TRUE, keep the UMFPACK symbolic analysis of sparse matrices factorized
+// by a left division or lu for reuse with the same sparsity pattern.
+static bool Vreuse_sparse_symbolic_analysis = false;
+
+// The analyses handed out while the option is enabled, so that all of them
+// can be released when it is disabled again.
+static std::vector<std::weak_ptr<math::sparse_lu_symbolic>> symbolic_analyses;
+
+// The most recently created analysis for real and complex matrices.  A new
+// matrix with the same pattern, such as the next Jacobian of a Newton
+// iteration, shares it instead of starting from scratch.
+static std::shared_ptr<math::sparse_lu_symbolic> last_real_analysis;
+static std::shared_ptr<math::sparse_lu_symbolic> last_complex_analysis;
+
+static void
+release_sparse_symbolic_analyses ()
+{
+  for (const auto& wsym : symbolic_analyses)
+    {
+      std::shared_ptr<math::sparse_lu_symbolic> sym = wsym.lock ();
+
+      if (sym)
+        sym->clear ();
+    }
+
+  symbolic_analyses.clear ();
+
+  last_real_analysis.reset ();
+  last_complex_analysis.reset ();
+}
+
+template <typename SM>
+static std::shared_ptr<math::sparse_lu_symbolic>
+do_sparse_symbolic_analysis (const SM& a, MatrixType& typ, bool is_complex)
+{
+  if (! Vreuse_sparse_symbolic_analysis)
+    {
+      typ.sparse_symbolic (nullptr);
+      return nullptr;
+    }
+
+  octave_idx_type nr = a.rows ();
+  octave_idx_type nc = a.cols ();
+
+  auto fits = [=, &a] (const std::shared_ptr<math::sparse_lu_symbolic>& sym)
+  {
+    return (sym && sym->is_complex () == is_complex
+            && sym->same_pattern (nr, nc, a.cidx (), a.ridx ()));
+  };
+
+  // The analysis stored with the matrix itself, which stays valid while
+  // only its values change.  Matrices that have not needed UMFPACK yet
+  // keep their empty object.
+
+  std::shared_ptr<math::sparse_lu_symbolic> sym = typ.sparse_symbolic ();
+
+  if (fits (sym) || (sym && sym->is_complex () == is_complex
+                     && sym->is_empty ()))
+    return sym;
+
+  std::shared_ptr<math::sparse_lu_symbolic>& last
+    = (is_complex ? last_complex_analysis : last_real_analysis);
+
+  if (fits (last))
+    sym = last;
+  else
+    {
+      // Don't replace an analysis that may be shared with a copy of this
+      // matrix; start a new one instead.
+
+      sym = std::make_shared<math::sparse_lu_symbolic> (is_complex);
+
+      auto expired = [] (const std::weak_ptr<math::sparse_lu_symbolic>& w)
+      { return w.expired (); };
+
+      symbolic_analyses.erase (std::remove_if (symbolic_analyses.begin (),
+                                               symbolic_analyses.end (),
+                                               expired),
+                               symbolic_analyses.end ());
+
+      symbolic_analyses.push_back (sym);
+
+      last = sym;
+    }
+
+  typ.sparse_symbolic (sym);
+
+  return sym;
+}
+
+std::shared_ptr<math::sparse_lu_symbolic>
+sparse_symbolic_analysis (const SparseMatrix& a, MatrixType& typ)
+{
+  return do_sparse_symbolic_analysis (a, typ, false);
+}
+
+std::shared_ptr<math::sparse_lu_symbolic>
+sparse_symbolic_analysis (const SparseComplexMatrix& a, MatrixType& typ)
+{
+  return do_sparse_symbolic_analysis (a, typ, true);
+}
+
 static void
 solve_singularity_warning (double rcond)
 {
@@ -470,6 +582,8 @@ xleftdiv (const SparseMatrix& a, const Matrix& b, MatrixType& typ)
   if (! mx_leftdiv_conform (a, b))
     return Matrix ();
 
+  sparse_symbolic_analysis (a, typ);
+
   octave_idx_type info;
   double rcond = 0.0;
   return a.solve (typ, b, info, rcond, solve_singularity_warning);
@@ -482,6 +596,8 @@ xleftdiv (const SparseMatrix& a, const ComplexMatrix& b, MatrixType& typ)
   if (! mx_leftdiv_conform (a, b))
     return ComplexMatrix ();
 
+  sparse_symbolic_analysis (a, typ);
+
   octave_idx_type info;
   double rcond = 0.0;
   return a.solve (typ, b, info, rcond, solve_singularity_warning);
@@ -494,6 +610,8 @@ xleftdiv (const SparseMatrix& a, const SparseMatrix& b, MatrixType& typ)
   if (! mx_leftdiv_conform (a, b))
     return SparseMatrix ();
 
+  sparse_symbolic_analysis (a, typ);
+
   octave_idx_type info;
   double rcond = 0.0;
   return a.solve (typ, b, info, rcond, solve_singularity_warning);
@@ -506,6 +624,8 @@ xleftdiv (const SparseMatrix& a, const SparseComplexMatrix& b, MatrixType& typ)
   if (! mx_leftdiv_conform (a, b))
     return SparseComplexMatrix ();
 
+  sparse_symbolic_analysis (a, typ);
+
   octave_idx_type info;
   double rcond = 0.0;
   return a.solve (typ, b, info, rcond, solve_singularity_warning);
@@ -518,6 +638,8 @@ xleftdiv (const SparseComplexMatrix& a, const Matrix& b, MatrixType& typ)
   if (! mx_leftdiv_conform (a, b))
     return ComplexMatrix ();
 
+  sparse_symbolic_analysis (a, typ);
+
   octave_idx_type info;
   double rcond = 0.0;
   return a.solve (typ, b, info, rcond, solve_singularity_warning);
@@ -530,6 +652,8 @@ xleftdiv (const SparseComplexMatrix& a, const ComplexMatrix& b, MatrixType& typ)
   if (! mx_leftdiv_conform (a, b))
     return ComplexMatrix ();
 
+  sparse_symbolic_analysis (a, typ);
+
   octave_idx_type info;
   double rcond = 0.0;
   return a.solve (typ, b, info, rcond, solve_singularity_warning);
@@ -542,6 +666,8 @@ xleftdiv (const SparseComplexMatrix& a, const SparseMatrix& b, MatrixType& typ)
   if (! mx_leftdiv_conform (a, b))
     return SparseComplexMatrix ();
 
+  sparse_symbolic_analysis (a, typ);
+
   octave_idx_type info;
   double rcond = 0.0;
   return a.solve (typ, b, info, rcond, solve_singularity_warning);
@@ -555,6 +681,8 @@ xleftdiv (const SparseComplexMatrix& a, const SparseComplexMatrix& b,
   if (! mx_leftdiv_conform (a, b))
     return SparseComplexMatrix ();
 
+  sparse_symbolic_analysis (a, typ);
+
   octave_idx_type info;
   double rcond = 0.0;
   return a.solve (typ, b, info, rcond, solve_singularity_warning);
@@ -636,4 +764,106 @@ xleftdiv (const ComplexDiagMatrix& d, const SparseComplexMatrix& a,
   return do_leftdiv_dm_sm<SparseComplexMatrix> (d, a);
 }
 
+DEFUN (reuse_sparse_symbolic_analysis, args, nargout,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{val} =} reuse_sparse_symbolic_analysis ()
+@deftypefnx {} {@var{old_val} =} reuse_sparse_symbolic_analysis (@var{new_val})
+@deftypefnx {} {@var{old_val} =} reuse_sparse_symbolic_analysis (@var{new_val}, "local")
+Query or set whether the symbolic analysis of a sparse matrix is kept for
+later factorizations of matrices with the same sparsity pattern.
+
+When this option is true, the column ordering and symbolic factorization
+computed by UMFPACK for the last general square sparse matrix @var{A} in
+@code{@var{A} \ @var{b}} or @code{lu (@var{A})} are kept, and the next
+division or factorization of a matrix with the same size and sparsity pattern
+only computes the numeric factorization.
+This is useful when many systems with the same structure but changing values
+are solved one after another.  The analysis is stored with the matrix, so
+several matrices with different patterns that are solved in turn each keep
+their own, and a new matrix with the pattern of the most recently analyzed one
+shares its analysis.  All stored analyses are released when the option is set
+to false, including when a @qcode{"local"} setting is restored.
+
+The default value is false.
+
+When called from inside a function with the @qcode{"local"} option, the setting
+is changed locally for the function and any subroutines it calls.  The original
+setting is restored when exiting the function.
+@seealso{cache_matrix_factorizations, mldivide, lu, spparms}
+@end deftypefn */)
+{
+  if (args.length () == 2)
+    {
+      // Registered before the setting is protected, so that this runs
+      // after the previous value has been restored.
+
+      unwind_protect *frame
+        = __get_evaluator__ ().curr_fcn_unwind_protect_frame ();
+
+      if (frame)
+        frame->add ([] ()
+                    {
+                      if (! Vreuse_sparse_symbolic_analysis)
+                        release_sparse_symbolic_analyses ();
+                    });
+    }
+
+  octave_value retval
+    = set_internal_variable (Vreuse_sparse_symbolic_analysis, args, nargout,
+                             "reuse_sparse_symbolic_analysis");
+
+  if (! Vreuse_sparse_symbolic_analysis)
+    release_sparse_symbolic_analyses ();
+
+  return retval;
+}
+
+/*
+%!testif HAVE_UMFPACK
+%! reuse_sparse_symbolic_analysis (true, "local");
+%! A = sparse ([4 1 0; 1 4 1; 0 1 4]);
+%! for k = 1:2
+%!   A = A + k * speye (3);
+%!   [L, U, P, Q] = lu (A);
+%!   assert (L*U, P*A*Q, 4*eps (norm (A, 1)));
+%!   assert (A \ [1; 2; 3], full (A) \ [1; 2; 3], 1e-12);
+%! endfor
+
+## Matrices with different patterns solved in turn keep their own analysis
+%!testif HAVE_UMFPACK
+%! reuse_sparse_symbolic_analysis (true, "local");
+%! A = sparse ([4 1 0; 1 4 1; 0 1 4]);
+%! B = sparse ([4 0 1; 0 4 0; 1 1 4]);
+%! b = [1; 2; 3];
+%! for k = 1:3
+%!   A(2,2) = 4 + k;
+%!   B(3,3) = 4 + k;
+%!   assert (A \ b, full (A) \ b, 1e-12);
+%!   assert (B \ b, full (B) \ b, 1e-12);
+%! endfor
+
+%!function x = __solve_with_reuse__ (A, b)
+%!  reuse_sparse_symbolic_analysis (true, "local");
+%!  x = A \ b;
+%!endfunction
+
+%!testif HAVE_UMFPACK
+%! A = sparse ([4 1 0; 1 4 1; 0 1 4]);
+%! b = [1; 2; 3];
+%! old = reuse_sparse_symbolic_analysis ();
+%! x = __solve_with_reuse__ (A, b);
+%! assert (reuse_sparse_symbolic_analysis (), old);
+%! assert (x, full (A) \ b, 1e-12);
+%! assert (A \ b, x, 1e-12);
+
+%!test
+%! old = reuse_sparse_symbolic_analysis (true);
+%! unwind_protect
+%!   assert (reuse_sparse_symbolic_analysis (), true);
+%! unwind_protect_cleanup
+%!   reuse_sparse_symbolic_analysis (old);
+%! end_unwind_protect
+%! assert (reuse_sparse_symbolic_analysis (), old);
+*/
+
 OCTAVE_END_NAMESPACE(octave)
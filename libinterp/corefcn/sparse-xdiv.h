@@ -28,6 +28,8 @@
 
 #include "octave-config.h"
 
+#include <memory>
+
 #include "oct-cmplx.h"
 #include "MatrixType.h"
 
@@ -102,6 +104,16 @@ extern SparseComplexMatrix xleftdiv (const ComplexDiagMatrix&,
                                      const SparseComplexMatrix&,
                                      MatrixType&);
 
+// Attach to TYP the symbolic analysis to reuse for factorizing A and
+// return it.  If reuse_sparse_symbolic_analysis is disabled, detach any
+// analysis from TYP and return nullptr.
+
+extern std::shared_ptr<math::sparse_lu_symbolic>
+sparse_symbolic_analysis (const SparseMatrix& a, MatrixType& typ);
+
+extern std::shared_ptr<math::sparse_lu_symbolic>
+sparse_symbolic_analysis (const SparseComplexMatrix& a, MatrixType& typ);
+
 OCTAVE_END_NAMESPACE(octave)
 
 #endif
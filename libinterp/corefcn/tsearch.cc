@@ -27,7 +27,9 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 #include "lo-ieee.h"
 
@@ -49,13 +51,185 @@ inline double min (double a, double b, double c)
 
 #define REF(x,k,i) x(static_cast<octave_idx_type> (elem((k), (i))) - 1)
 
-// for large data set the algorithm is very slow
-// one should presort (how?) either the elements of the points of evaluation
-// to cut down the time needed to decide which triangle contains the
-// given point
+// Check whether the point (XT, YT) is inside triangle K, allowing for a
+// tolerance of EPS in the barycentric coordinates.
 
-// e.g., build up a neighbouring triangle structure and use a simplex-like
-// method to traverse it
+static inline bool
+in_triangle (const ColumnVector& x, const ColumnVector& y, const Matrix& elem,
+             octave_idx_type k, double xt, double yt, double eps)
+{
+  double x0  = REF (x, k, 0);
+  double y0  = REF (y, k, 0);
+  double a11 = REF (x, k, 1) - x0;
+  double a12 = REF (y, k, 1) - y0;
+  double a21 = REF (x, k, 2) - x0;
+  double a22 = REF (y, k, 2) - y0;
+  double det = a11 * a22 - a21 * a12;
+
+  // solve the system
+  double dx1 = xt - x0;
+  double dx2 = yt - y0;
+  double c1 = (a22 * dx1 - a21 * dx2) / det;
+  double c2 = (-a12 * dx1 + a11 * dx2) / det;
+
+  return (c1 >= -eps && c2 >= -eps && (c1 + c2) <= 1 + eps);
+}
+
+// A uniform grid over the bounding rectangles of the triangles.  Each
+// cell lists, in increasing order, the triangles whose bounding
+// rectangle overlaps it.  A point can only be inside the bounding
+// rectangles of the triangles listed for its cell, so searching them in
+// order finds the same triangle as searching all triangles in order.
+
+class tri_grid
+{
+public:
+
+  tri_grid (const double *minx, const double *maxx, const double *miny,
+            const double *maxy, octave_idx_type nelem)
+    : m_nx (1), m_ny (1), m_x0 (0), m_y0 (0), m_sx (0), m_sy (0),
+      m_start (), m_tri ()
+  {
+    double x0 = octave::numeric_limits<double>::Inf ();
+    double x1 = -x0;
+    double y0 = x0;
+    double y1 = -x0;
+
+    for (octave_idx_type k = 0; k < nelem; k++)
+      {
+        x0 = std::min (x0, minx[k]);
+        x1 = std::max (x1, maxx[k]);
+        y0 = std::min (y0, miny[k]);
+        y1 = std::max (y1, maxy[k]);
+      }
+
+    if (! (x0 <= x1 && y0 <= y1 && std::isfinite (x1 - x0)
+           && std::isfinite (y1 - y0)))
+      return;
+
+    // Aim for about one triangle per cell.
+    double w = x1 - x0;
+    double h = y1 - y0;
+    double ncells = nelem;
+    if (w > 0 && h > 0)
+      {
+        double aspect = w / h;
+        m_nx = cell_count (std::sqrt (ncells * aspect));
+        m_ny = cell_count (ncells / m_nx);
+      }
+    else if (w > 0)
+      m_nx = cell_count (ncells);
+    else if (h > 0)
+      m_ny = cell_count (ncells);
+
+    m_x0 = x0;
+    m_y0 = y0;
+    m_sx = (w > 0 ? m_nx / w : 0);
+    m_sy = (h > 0 ? m_ny / h : 0);
+
+    m_start.assign (m_nx * m_ny + 1, 0);
+
+    double nref = 0;
+    for (octave_idx_type k = 0; k < nelem; k++)
+      nref += (static_cast<double> (xcell (maxx[k]) - xcell (minx[k]) + 1)
+               * (ycell (maxy[k]) - ycell (miny[k]) + 1));
+
+    // Give up on meshes with many triangles spanning many cells.
+    if (nref > 16.0 * nelem + m_nx * m_ny)
+      {
+        m_start.clear ();
+        return;
+      }
+
+    for (octave_idx_type k = 0; k < nelem; k++)
+      for_cells (k, minx, maxx, miny, maxy,
+                 [this] (octave_idx_type c, octave_idx_type)
+                 { m_start[c+1]++; });
+
+    for (octave_idx_type c = 0; c < m_nx * m_ny; c++)
+      m_start[c+1] += m_start[c];
+
+    m_tri.resize (m_start.back ());
+
+    std::vector<octave_idx_type> pos (m_start.begin (), m_start.end () - 1);
+    for (octave_idx_type k = 0; k < nelem; k++)
+      for_cells (k, minx, maxx, miny, maxy,
+                 [this, &pos] (octave_idx_type c, octave_idx_type kk)
+                 { m_tri[pos[c]++] = kk; });
+  }
+
+  OCTAVE_DISABLE_COPY_MOVE (tri_grid)
+
+  ~tri_grid () = default;
+
+  bool ok () const { return ! m_start.empty (); }
+
+  // Range of triangles listed for the cell containing (XT, YT).
+
+  const octave_idx_type * begin (double xt, double yt) const
+  {
+    return m_tri.data () + m_start[cell (xt, yt)];
+  }
+
+  const octave_idx_type * end (double xt, double yt) const
+  {
+    return m_tri.data () + m_start[cell (xt, yt) + 1];
+  }
+
+private:
+
+  static octave_idx_type cell_count (double n)
+  {
+    return std::max (static_cast<octave_idx_type> (std::min (n, 1e6)),
+                     static_cast<octave_idx_type> (1));
+  }
+
+  // Clamp to the grid.  The mapping is nondecreasing, so a point inside
+  // a rectangle is in one of the cells that the rectangle overlaps.
+
+  static octave_idx_type to_cell (double t, octave_idx_type n)
+  {
+    if (! (t > 0))
+      return 0;
+    else if (t >= n)
+      return n - 1;
+    else
+      return static_cast<octave_idx_type> (t);
+  }
+
+  octave_idx_type xcell (double xt) const
+  {
+    return to_cell ((xt - m_x0) * m_sx, m_nx);
+  }
+
+  octave_idx_type ycell (double yt) const
+  {
+    return to_cell ((yt - m_y0) * m_sy, m_ny);
+  }
+
+  octave_idx_type cell (double xt, double yt) const
+  {
+    return xcell (xt) + m_nx * ycell (yt);
+  }
+
+  template <typename F>
+  void for_cells (octave_idx_type k, const double *minx, const double *maxx,
+                  const double *miny, const double *maxy, F fcn) const
+  {
+    octave_idx_type i1 = xcell (maxx[k]);
+    octave_idx_type j1 = ycell (maxy[k]);
+    for (octave_idx_type j = ycell (miny[k]); j <= j1; j++)
+      for (octave_idx_type i = xcell (minx[k]); i <= i1; i++)
+        fcn (i + m_nx * j, k);
+  }
+
+  octave_idx_type m_nx, m_ny;
+  double m_x0, m_y0, m_sx, m_sy;
+
+  // Triangles of cell C are M_TRI[M_START[C]] to M_TRI[M_START[C+1]-1].
+  std::vector<octave_idx_type> m_start;
+  std::vector<octave_idx_type> m_tri;
+};
 
 DEFUN (tsearch, args, ,
        doc: /* -*- texinfo -*-
@@ -93,70 +267,94 @@ convex hull, @var{idx} is NaN.
       maxy(k) = max (REF (y, k, 0), REF (y, k, 1), REF (y, k, 2)) + eps;
     }
 
+  const double *pminx = minx.data ();
+  const double *pmaxx = maxx.data ();
+  const double *pminy = miny.data ();
+  const double *pmaxy = maxy.data ();
+
   const octave_idx_type np = xi.numel ();
   ColumnVector values (np);
+  double *pvalues = values.fortran_vec ();
+
+  // Without an index, every triangle is a candidate for every point.
+  std::vector<octave_idx_type> all_tri;
+
+  // An index pays off once there are many triangles and points.
+  tri_grid grid (pminx, pmaxx, pminy, pmaxy,
+                 (nelem > 32 && np > 8) ? nelem : 0);
+
+  if (! grid.ok ())
+    {
+      all_tri.resize (nelem);
+      for (octave_idx_type k = 0; k < nelem; k++)
+        all_tri[k] = k;
+    }
+
+  // First triangle that contains the point (xt,yt), or NELEM.
+  auto first_triangle = [&] (double xt, double yt)
+  {
+    const octave_idx_type *p = all_tri.data ();
+    const octave_idx_type *pend = p + all_tri.size ();
+    if (grid.ok ())
+      {
+        p = grid.begin (xt, yt);
+        pend = grid.end (xt, yt);
+      }
 
-  double x0 = 0.0, y0 = 0.0;
-  double a11 = 0.0, a12 = 0.0, a21 = 0.0, a22 = 0.0, det = 0.0;
-  double xt = 0.0, yt = 0.0;
-  double dx1 = 0.0, dx2 = 0.0, c1 = 0.0, c2 = 0.0;
+    for (; p != pend; p++)
+      {
+        octave_idx_type k = *p;
+        if (xt >= pminx[k] && xt <= pmaxx[k]
+            && yt >= pminy[k] && yt <= pmaxy[k])
+          {
+            // Point is inside the triangle's bounding rectangle:
+            // See if it's inside the triangle itself.
+            if (in_triangle (x, y, elem, k, xt, yt, eps))
+              return k;
+          }
+      }
+
+    return nelem;
+  };
+
+  // The first triangle of each point is found independently, in blocks
+  // that are spread across threads.
+  static const octave_idx_type block = 4096;
+
+  for (octave_idx_type kp0 = 0; kp0 < np; kp0 += block)
+    {
+      octave_idx_type kp1 = std::min (kp0 + block, np);
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp parallel for
+#endif
+      for (octave_idx_type kp = kp0; kp < kp1; kp++)
+        pvalues[kp] = first_triangle (xi.xelem (kp), yi.xelem (kp));
+
+      octave_quit ();
+    }
 
   octave_idx_type k = nelem;   // k is more than just an index variable.
 
   for (octave_idx_type kp = 0; kp < np; kp++)   // for each point
     {
-      xt = xi (kp);
-      yt = yi (kp);
-
-      // Check if point (xt,yt) is in the triangle that was last examined.
+      // Check if point (xt,yt) is in the triangle that was last found.
       // This is for inputs where points are in contiguous order,
       // like when the points are sampled from a continuous path.
-      if (k < nelem)  // This check will be false for the very first point.
+      if (k < nelem  // This check will be false for the very first point.
+          && in_triangle (x, y, elem, k, xi.xelem (kp), yi.xelem (kp), eps))
         {
-          // If we are here, then x0, y0, det all exist from before.
-          dx1 = xt - x0;
-          dx2 = yt - y0;
-          c1 = (a22 * dx1 - a21 * dx2) / det;
-          c2 = (-a12 * dx1 + a11 * dx2) / det;
-          if (c1 >= -eps && c2 >= -eps && (c1 + c2) <= 1 + eps)
-            {
-              values (kp) = k+1;
-              continue;
-            }
+          pvalues[kp] = k+1;
+          continue;
         }
 
-      // The point is not in the same triangle, so go through all triangles.
-      for (k = 0; k < nelem; k++)
-        {
-          if (xt >= minx(k) && xt <= maxx(k) && yt >= miny(k) && yt <= maxy(k))
-            {
-              // Point is inside the triangle's bounding rectangle:
-              // See if it's inside the triangle itself.
-              x0  = REF (x, k, 0);
-              y0  = REF (y, k, 0);
-              a11 = REF (x, k, 1) - x0;
-              a12 = REF (y, k, 1) - y0;
-              a21 = REF (x, k, 2) - x0;
-              a22 = REF (y, k, 2) - y0;
-              det = a11 * a22 - a21 * a12;
-
-              // solve the system
-              dx1 = xt - x0;
-              dx2 = yt - y0;
-              c1 = (a22 * dx1 - a21 * dx2) / det;
-              c2 = (-a12 * dx1 + a11 * dx2) / det;
-              if (c1 >= -eps && c2 >= -eps && (c1 + c2) <= 1 + eps)
-                {
-                  values (kp) = k+1;
-                  break;
-                }
-            } //end see if it's inside the triangle itself
-        } //end for each triangle
+      k = static_cast<octave_idx_type> (pvalues[kp]);
 
       if (k == nelem)
-        values (kp) = lo_ieee_nan_value ();
-
-    } //end for each point
+        pvalues[kp] = lo_ieee_nan_value ();
+      else
+        pvalues[kp] = k+1;
+    }
 
   return ovl (values);
 }
@@ -172,6 +370,27 @@ convex hull, @var{idx} is NaN.
 %!assert (tsearch (x,y,tri,-1/3, -1/3), 1)
 %!assert (tsearch (x,y,tri, 1, 1), NaN)
 
+%!shared n, xx, yy, tri
+%! n = 20;
+%! [xx, yy] = meshgrid (0:n);
+%! xx = xx(:);
+%! yy = yy(:);
+%! a = reshape (1:(n+1)^2, n+1, n+1)(1:n,1:n)(:);
+%! tri = [a, a+1, a+n+2; a, a+n+2, a+n+1];
+%!test
+%! xi = rand (500, 1) * n;
+%! yi = rand (500, 1) * n;
+%! idx = tsearch (xx, yy, tri, xi, yi);
+%! v = tri(idx,1);
+%! assert (xx(v), floor (xi));
+%! assert (yy(v), floor (yi));
+%! assert (idx <= n^2, (yi - floor (yi)) > (xi - floor (xi)));
+%!assert (tsearch (xx, yy, tri, [-1; n+1], [1; 1]), [NaN; NaN])
+## A point on an edge stays in the triangle of the point before it
+%!assert (tsearch (xx, yy, tri, [0.5; 0.75; 0.5; NaN(8,1)],
+%!                 [0.5; 0.25; 0.5; ones(8,1)]),
+%!        [1; n^2+1; n^2+1; NaN(8,1)])
+
 %!error tsearch ()
 */
 
@@ -31,6 +31,7 @@
 #include "octave-config.h"
 
 #include <cmath>
+#include <cstdlib>
 
 #include <map>
 #include <set>
@@ -50,7 +51,7 @@ public:
 
   url_handle_manager ()
     : m_handle_map (), m_handle_free_list (),
-      m_next_handle (-1.0 - (rand () + 1.0) / (RAND_MAX + 2.0)) { }
+      m_next_handle (-1.0 - (std::rand () + 1.0) / (RAND_MAX + 2.0)) { }
 
   OCTAVE_DISABLE_COPY_MOVE (url_handle_manager)
 
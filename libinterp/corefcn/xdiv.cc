@@ -46,11 +46,19 @@
 #include "lo-array-errwarn.h"
 #include "quit.h"
 
+#include "defun.h"
 #include "error.h"
+#include "oct-map.h"
+#include "ovl.h"
+#include "variables.h"
 #include "xdiv.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+// If TRUE, keep the factorization of full real matrices for later
+// solves with the same matrix.
+static bool Vcache_matrix_factorizations = false;
+
 static void
 solve_singularity_warning (double rcond)
 {
@@ -129,6 +137,8 @@ xdiv (const Matrix& a, const Matrix& b, MatrixType& typ)
   octave_idx_type info;
   double rcond = 0.0;
 
+  typ.cache_factorization (Vcache_matrix_factorizations);
+
   Matrix result
     = b.solve (typ, a.transpose (), info, rcond,
                solve_singularity_warning, true, blas_trans);
@@ -352,6 +362,9 @@ xleftdiv (const Matrix& a, const Matrix& b, MatrixType& typ,
 
   octave_idx_type info;
   double rcond = 0.0;
+
+  typ.cache_factorization (Vcache_matrix_factorizations);
+
   return a.solve (typ, b, info, rcond, solve_singularity_warning, true, transt);
 }
 
@@ -1011,4 +1024,121 @@ FloatComplexDiagMatrix
 xleftdiv (const FloatComplexDiagMatrix& a, const FloatComplexDiagMatrix& b)
 { return dmdm_leftdiv_impl (a, b); }
 
+DEFUN (cache_matrix_factorizations, args, nargout,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{val} =} cache_matrix_factorizations ()
+@deftypefnx {} {@var{old_val} =} cache_matrix_factorizations (@var{new_val})
+@deftypefnx {} {@var{old_val} =} cache_matrix_factorizations (@var{new_val}, "local")
+Query or set whether the factorization of a full real matrix is kept for
+later solves with the same matrix.
+
+When this option is true, the LU or Cholesky factorization computed by
+@code{@var{A} \ @var{b}} or @code{@var{b} / @var{A}} is stored with the
+matrix @var{A}, and later divisions by the same, unmodified @var{A} only
+perform the triangular solves.  This is useful when many systems with the
+same matrix and different right-hand sides are solved one after another.
+The cached factorization uses as much memory as @var{A} itself and is
+discarded as soon as @var{A} is modified.
+
+The default value is false.
+
+When called from inside a function with the @qcode{"local"} option, the setting
+is changed locally for the function and any subroutines it calls.  The original
+setting is restored when exiting the function.
+@seealso{matrix_type, mldivide, mrdivide}
+@end deftypefn */)
+{
+  return set_internal_variable (Vcache_matrix_factorizations, args, nargout,
+                                "cache_matrix_factorizations");
+}
+
+DEFUN (__solve_stats__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{stats} =} __solve_stats__ ()
+@deftypefnx {} {@var{stats} =} __solve_stats__ ("reset")
+Undocumented internal function.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  MatrixType::solve_statistics& stats = MatrixType::solve_stats ();
+
+  octave_scalar_map retval;
+
+  retval.assign ("probes", stats.probes);
+  retval.assign ("probe_time", stats.probe_time);
+  retval.assign ("factorizations", stats.factorizations);
+  retval.assign ("factor_time", stats.factor_time);
+  retval.assign ("cache_hits", stats.factorization_hits);
+
+  if (nargin == 1)
+    {
+      std::string opt
+        = args(0).xstring_value ("__solve_stats__: argument must be a string");
+
+      if (opt != "reset")
+        error (R"(__solve_stats__: unrecognized option "%s")", opt.c_str ());
+
+      stats = MatrixType::solve_statistics ();
+    }
+
+  return ovl (retval);
+}
+
+/*
+%!function [x1, x2, x3, s] = __test_solve_cache__ (A, b)
+%!  cache_matrix_factorizations (true, "local");
+%!  __solve_stats__ ("reset");
+%!  x1 = A \ b;
+%!  x2 = A \ (2*b);
+%!  x3 = b' / A;
+%!  s = __solve_stats__ ();
+%!endfunction
+
+%!test
+%! A = [4 1 2; 0 3 1; 1 1 5];
+%! b = [1; 2; 3];
+%! [x1, x2, x3, s] = __test_solve_cache__ (A, b);
+%! assert (x1, A \ b, 4*eps);
+%! assert (x2, 2 * (A \ b), 8*eps);
+%! assert (x3, b' / A, 4*eps);
+%! assert (s.factorizations, 1);
+%! assert (s.cache_hits, 2);
+%! assert (s.probes, 1);
+
+## Symmetric positive definite matrices keep their Cholesky factors
+%!test
+%! A = [4 1 0; 1 3 1; 0 1 5];
+%! b = [1 2; 3 4; 5 6];
+%! [x1, x2, x3, s] = __test_solve_cache__ (A, b);
+%! assert (x1, A \ b, 4*eps);
+%! assert (x2, 2 * (A \ b), 8*eps);
+%! assert (x3, b' / A, 4*eps);
+%! assert (s.factorizations, 1);
+%! assert (s.cache_hits, 2);
+
+## Modifying the matrix discards the cached factorization
+%!test
+%! cache_matrix_factorizations (true, "local");
+%! A = [2 1; 1 -3];
+%! b = [1; 1];
+%! x = A \ b;
+%! A(2,2) = 5;
+%! assert (A \ b, [4; 1] / 9, 4*eps);
+
+%!test
+%! cache_matrix_factorizations (true, "local");
+%! A = [1 2; 2 4];
+%! warning ("off", "Octave:singular-matrix", "local");
+%! x1 = A \ [1; 2];
+%! x2 = A \ [1; 2];
+%! assert (x1, x2);
+
+%!error <argument must be a string> __solve_stats__ (1)
+%!error <unrecognized option> __solve_stats__ ("foo")
+*/
+
 OCTAVE_END_NAMESPACE(octave)
@@ -51,6 +51,7 @@ OCTAVE_VALUE_INC = \
   %reldir%/ov-flt-cx-mat.h \
   %reldir%/ov-flt-re-diag.h \
   %reldir%/ov-flt-re-mat.h \
+  %reldir%/ov-hash-map.h \
   %reldir%/ov-inline.h \
   %reldir%/ov-java.h \
   %reldir%/ov-lazy-idx.h \
@@ -121,6 +122,7 @@ OCTAVE_VALUE_SRC = \
   %reldir%/ov-flt-cx-mat.cc \
   %reldir%/ov-flt-re-diag.cc \
   %reldir%/ov-flt-re-mat.cc \
+  %reldir%/ov-hash-map.cc \
   %reldir%/ov-java.cc \
   %reldir%/ov-lazy-idx.cc \
   %reldir%/ov-legacy-range.cc \
@@ -0,0 +1,943 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <ostream>
+#include <vector>
+
+#include "boolNDArray.h"
+#include "dNDArray.h"
+#include "fNDArray.h"
+#include "int32NDArray.h"
+#include "int64NDArray.h"
+#include "lo-mappers.h"
+#include "uint32NDArray.h"
+#include "uint64NDArray.h"
+
+#include "Cell.h"
+#include "defun.h"
+#include "error.h"
+#include "ov-hash-map.h"
+#include "ovl.h"
+
+DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_hash_map, "hash_map", "hash_map");
+
+// Spread the bits of a hash value over the low bits that select a slot.
+// Keys that differ only in their high bits, such as small integers
+// stored as doubles, would otherwise collide.
+
+static inline std::size_t
+mix_hash (std::uint64_t h)
+{
+  // Finalizer of MurmurHash3.
+  h ^= h >> 33;
+  h *= UINT64_C (0xff51afd7ed558ccd);
+  h ^= h >> 33;
+  h *= UINT64_C (0xc4ceb9fe1a85ec53);
+  h ^= h >> 33;
+
+  return h;
+}
+
+// Hash table with open addressing and linear probing.  The keys and
+// values are stored densely in insertion order, and the slots hold
+// indices into them, so that lookups touch little memory and the
+// entries can be listed without scanning empty slots.
+
+template <typename K>
+class open_hash_table
+{
+public:
+
+  open_hash_table ()
+    : m_keys (), m_vals (), m_slots (min_slots, empty_slot), m_nused (0),
+      m_order (), m_order_valid (true)
+  { }
+
+  OCTAVE_DEFAULT_COPY_MOVE_DELETE (open_hash_table)
+
+  octave_idx_type size () const { return m_keys.size (); }
+
+  const K& key (octave_idx_type i) const { return m_keys[i]; }
+
+  const octave_value& value (octave_idx_type i) const { return m_vals[i]; }
+
+  // Return the index of the entry for KEY, or -1.
+
+  octave_idx_type find (const K& key) const
+  {
+    std::size_t s = find_slot (key);
+
+    return s == no_slot ? -1 : m_slots[s];
+  }
+
+  void assign (const K& key, const octave_value& val)
+  {
+    std::size_t mask = m_slots.size () - 1;
+    std::size_t s = hash (key) & mask;
+    std::size_t reuse = no_slot;
+
+    for (;;)
+      {
+        octave_idx_type i = m_slots[s];
+
+        if (i == empty_slot)
+          break;
+
+        if (i == deleted_slot)
+          {
+            if (reuse == no_slot)
+              reuse = s;
+          }
+        else if (m_keys[i] == key)
+          {
+            m_vals[i] = val;
+            return;
+          }
+
+        s = (s + 1) & mask;
+      }
+
+    if (reuse != no_slot)
+      s = reuse;
+    else
+      m_nused++;
+
+    m_slots[s] = m_keys.size ();
+    m_keys.push_back (key);
+    m_vals.push_back (val);
+
+    m_order_valid = false;
+
+    // Keep at least a quarter of the slots empty so that the probe
+    // sequences stay short.
+
+    if (4 * m_nused > 3 * m_slots.size ())
+      rehash ();
+  }
+
+  bool erase (const K& key)
+  {
+    std::size_t s = find_slot (key);
+
+    if (s == no_slot)
+      return false;
+
+    octave_idx_type i = m_slots[s];
+    octave_idx_type last = m_keys.size () - 1;
+
+    m_slots[s] = deleted_slot;
+
+    // Move the last entry into the hole to keep the storage dense.
+
+    if (i != last)
+      {
+        m_slots[find_slot (m_keys[last])] = i;
+
+        m_keys[i] = std::move (m_keys[last]);
+        m_vals[i] = m_vals[last];
+      }
+
+    m_keys.pop_back ();
+    m_vals.pop_back ();
+
+    m_order_valid = false;
+
+    return true;
+  }
+
+  // Indices of the entries sorted by key with LESS.  The order is only
+  // computed again after the keys have changed.
+
+  template <typename Less>
+  const std::vector<octave_idx_type>& order (Less less)
+  {
+    if (! m_order_valid)
+      {
+        m_order.resize (m_keys.size ());
+
+        std::iota (m_order.begin (), m_order.end (), 0);
+
+        std::sort (m_order.begin (), m_order.end (),
+                   [this, &less] (octave_idx_type a, octave_idx_type b)
+                   { return less (m_keys[a], m_keys[b]); });
+
+        m_order_valid = true;
+      }
+
+    return m_order;
+  }
+
+private:
+
+  static constexpr std::size_t min_slots = 8;
+
+  static constexpr octave_idx_type empty_slot = -1;
+  static constexpr octave_idx_type deleted_slot = -2;
+
+  static constexpr std::size_t no_slot = static_cast<std::size_t> (-1);
+
+  static std::size_t hash (const K& key)
+  {
+    return mix_hash (std::hash<K> () (key));
+  }
+
+  std::size_t find_slot (const K& key) const
+  {
+    std::size_t mask = m_slots.size () - 1;
+    std::size_t s = hash (key) & mask;
+
+    for (;;)
+      {
+        octave_idx_type i = m_slots[s];
+
+        if (i == empty_slot)
+          return no_slot;
+
+        if (i != deleted_slot && m_keys[i] == key)
+          return s;
+
+        s = (s + 1) & mask;
+      }
+  }
+
+  // Resize the slots to at least twice the number of entries, which
+  // also drops the deleted slots.
+
+  void rehash ()
+  {
+    std::size_t nslots = min_slots;
+
+    while (nslots < 2 * (m_keys.size () + 1))
+      nslots *= 2;
+
+    m_slots.assign (nslots, empty_slot);
+
+    std::size_t mask = nslots - 1;
+
+    for (std::size_t i = 0; i < m_keys.size (); i++)
+      {
+        std::size_t s = hash (m_keys[i]) & mask;
+
+        while (m_slots[s] != empty_slot)
+          s = (s + 1) & mask;
+
+        m_slots[s] = i;
+      }
+
+    m_nused = m_keys.size ();
+  }
+
+  std::vector<K> m_keys;
+
+  std::vector<octave_value> m_vals;
+
+  // Number of slots is a power of 2.
+  std::vector<octave_idx_type> m_slots;
+
+  // Slots that are not empty, including deleted ones.
+  std::size_t m_nused;
+
+  std::vector<octave_idx_type> m_order;
+
+  bool m_order_valid;
+};
+
+// Keys converted for a table, with the shape of the array of keys they
+// came from.  Elements that are not keys of the right kind are marked
+// invalid.
+
+struct hash_map_keys
+{
+  dim_vector dims;
+
+  std::vector<bool> valid;
+
+  std::vector<std::string> strings;
+
+  std::vector<std::uint64_t> numbers;
+};
+
+class octave_hash_map::table
+{
+public:
+
+  table (key_type type)
+    : m_type (type), m_strings (), m_numbers ()
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (table)
+
+  ~table () = default;
+
+  key_type type () const { return m_type; }
+
+  bool has_string_keys () const { return m_type == char_key; }
+
+  octave_idx_type count () const
+  {
+    return has_string_keys () ? m_strings.size () : m_numbers.size ();
+  }
+
+  hash_map_keys convert (const octave_value& keys) const;
+
+  // Index of entry for key I of KEYS, or -1.
+  octave_idx_type find (const hash_map_keys& keys, octave_idx_type i) const
+  {
+    if (! keys.valid[i])
+      return -1;
+
+    return (has_string_keys () ? m_strings.find (keys.strings[i])
+            : m_numbers.find (keys.numbers[i]));
+  }
+
+  void assign (const hash_map_keys& keys, octave_idx_type i,
+               const octave_value& val)
+  {
+    if (has_string_keys ())
+      m_strings.assign (keys.strings[i], val);
+    else
+      m_numbers.assign (keys.numbers[i], val);
+  }
+
+  void erase (const hash_map_keys& keys, octave_idx_type i)
+  {
+    if (has_string_keys ())
+      m_strings.erase (keys.strings[i]);
+    else
+      m_numbers.erase (keys.numbers[i]);
+  }
+
+  const octave_value& value (octave_idx_type i) const
+  {
+    return has_string_keys () ? m_strings.value (i) : m_numbers.value (i);
+  }
+
+  octave_value key (octave_idx_type i) const;
+
+  const std::vector<octave_idx_type>& order ();
+
+private:
+
+  std::vector<std::uint64_t> numeric_keys (const octave_value& val) const;
+
+  key_type m_type;
+
+  open_hash_table<std::string> m_strings;
+
+  // Numeric keys are stored as the bit patterns of their values in the
+  // key type.
+  open_hash_table<std::uint64_t> m_numbers;
+};
+
+static inline std::uint64_t
+double_bits (double x)
+{
+  // 0 and -0 are the same key.
+  if (x == 0)
+    x = 0;
+
+  std::uint64_t bits;
+  std::memcpy (&bits, &x, sizeof (x));
+
+  return bits;
+}
+
+static inline double
+bits_double (std::uint64_t bits)
+{
+  double x;
+  std::memcpy (&x, &bits, sizeof (x));
+
+  return x;
+}
+
+static inline std::uint64_t
+float_bits (float x)
+{
+  if (x == 0)
+    x = 0;
+
+  std::uint32_t bits;
+  std::memcpy (&bits, &x, sizeof (x));
+
+  return bits;
+}
+
+static inline float
+bits_float (std::uint64_t bits)
+{
+  std::uint32_t b = bits;
+
+  float x;
+  std::memcpy (&x, &b, sizeof (x));
+
+  return x;
+}
+
+// Convert the elements of the real numeric or logical array VAL to the
+// key type, as the conversion functions double, int32, etc. would.
+
+std::vector<std::uint64_t>
+octave_hash_map::table::numeric_keys (const octave_value& val) const
+{
+  octave_idx_type n = val.numel ();
+
+  std::vector<std::uint64_t> retval (n);
+
+  switch (m_type)
+    {
+    case double_key:
+      {
+        const NDArray a = val.array_value ();
+
+        for (octave_idx_type i = 0; i < n; i++)
+          retval[i] = double_bits (a(i));
+      }
+      break;
+
+    case single_key:
+      {
+        const FloatNDArray a = val.float_array_value ();
+
+        for (octave_idx_type i = 0; i < n; i++)
+          retval[i] = float_bits (a(i));
+      }
+      break;
+
+    case int32_key:
+      {
+        const int32NDArray a = val.int32_array_value ();
+
+        for (octave_idx_type i = 0; i < n; i++)
+          retval[i] = static_cast<std::int64_t> (a(i).value ());
+      }
+      break;
+
+    case uint32_key:
+      {
+        const uint32NDArray a = val.uint32_array_value ();
+
+        for (octave_idx_type i = 0; i < n; i++)
+          retval[i] = a(i).value ();
+      }
+      break;
+
+    case int64_key:
+      {
+        const int64NDArray a = val.int64_array_value ();
+
+        for (octave_idx_type i = 0; i < n; i++)
+          retval[i] = a(i).value ();
+      }
+      break;
+
+    case uint64_key:
+      {
+        const uint64NDArray a = val.uint64_array_value ();
+
+        for (octave_idx_type i = 0; i < n; i++)
+          retval[i] = a(i).value ();
+      }
+      break;
+
+    default:
+      break;
+    }
+
+  return retval;
+}
+
+static inline bool
+is_real_numeric (const octave_value& val)
+{
+  return (val.isnumeric () || val.islogical ()) && ! val.iscomplex ();
+}
+
+static inline bool
+is_string_key (const octave_value& val)
+{
+  return val.is_string () && val.rows () <= 1;
+}
+
+// KEYS may be a cell array of keys, an array of numeric keys, or a
+// single string.
+
+hash_map_keys
+octave_hash_map::table::convert (const octave_value& keys) const
+{
+  hash_map_keys retval;
+
+  if (keys.iscell ())
+    {
+      const Cell c = keys.cell_value ();
+
+      octave_idx_type n = c.numel ();
+
+      retval.dims = c.dims ();
+      retval.valid.resize (n, false);
+
+      if (has_string_keys ())
+        {
+          retval.strings.resize (n);
+
+          for (octave_idx_type i = 0; i < n; i++)
+            {
+              if (is_string_key (c(i)))
+                {
+                  retval.strings[i] = c(i).string_value ();
+                  retval.valid[i] = true;
+                }
+            }
+        }
+      else
+        {
+          retval.numbers.resize (n);
+
+          for (octave_idx_type i = 0; i < n; i++)
+            {
+              if (is_real_numeric (c(i)) && c(i).numel () == 1)
+                {
+                  retval.numbers[i] = numeric_keys (c(i))[0];
+                  retval.valid[i] = true;
+                }
+            }
+        }
+    }
+  else if (has_string_keys ())
+    {
+      // Numeric arrays are arrays of keys of the wrong kind.
+
+      retval.dims = (keys.isnumeric () || keys.islogical ()
+                     ? keys.dims () : dim_vector (1, 1));
+
+      retval.valid.resize (retval.dims.numel (), false);
+      retval.strings.resize (retval.dims.numel ());
+
+      if (is_string_key (keys))
+        {
+          retval.strings[0] = keys.string_value ();
+          retval.valid[0] = true;
+        }
+    }
+  else if (is_real_numeric (keys))
+    {
+      retval.dims = keys.dims ();
+      retval.numbers = numeric_keys (keys.full_value ());
+      retval.valid.resize (retval.numbers.size (), true);
+    }
+  else
+    {
+      retval.dims = (keys.isnumeric () ? keys.dims () : dim_vector (1, 1));
+      retval.valid.resize (retval.dims.numel (), false);
+      retval.numbers.resize (retval.dims.numel ());
+    }
+
+  return retval;
+}
+
+octave_value
+octave_hash_map::table::key (octave_idx_type i) const
+{
+  if (has_string_keys ())
+    return octave_value (m_strings.key (i));
+
+  std::uint64_t bits = m_numbers.key (i);
+
+  switch (m_type)
+    {
+    case double_key:
+      return octave_value (bits_double (bits));
+
+    case single_key:
+      return octave_value (bits_float (bits));
+
+    case int32_key:
+      return octave_value (octave_int32 (static_cast<std::int64_t> (bits)));
+
+    case uint32_key:
+      return octave_value (octave_uint32 (bits));
+
+    case int64_key:
+      return octave_value (octave_int64 (static_cast<std::int64_t> (bits)));
+
+    case uint64_key:
+      return octave_value (octave_uint64 (bits));
+
+    default:
+      return octave_value ();
+    }
+}
+
+// Numeric keys are sorted as sort does, with NaN last.
+
+template <typename T>
+static inline bool
+key_less (T a, T b)
+{
+  return ! octave::math::isnan (a) && (octave::math::isnan (b) || a < b);
+}
+
+const std::vector<octave_idx_type>&
+octave_hash_map::table::order ()
+{
+  switch (m_type)
+    {
+    case char_key:
+      return m_strings.order (std::less<std::string> ());
+
+    case double_key:
+      return m_numbers.order ([] (std::uint64_t a, std::uint64_t b)
+                              {
+                                return key_less (bits_double (a),
+                                                 bits_double (b));
+                              });
+
+    case single_key:
+      return m_numbers.order ([] (std::uint64_t a, std::uint64_t b)
+                              {
+                                return key_less (bits_float (a),
+                                                 bits_float (b));
+                              });
+
+    case int32_key:
+    case int64_key:
+      return m_numbers.order ([] (std::uint64_t a, std::uint64_t b)
+                              {
+                                return (static_cast<std::int64_t> (a)
+                                        < static_cast<std::int64_t> (b));
+                              });
+
+    default:
+      return m_numbers.order (std::less<std::uint64_t> ());
+    }
+}
+
+static octave_hash_map::key_type
+hash_map_key_type (const std::string& name)
+{
+  if (name == "char")
+    return octave_hash_map::char_key;
+  else if (name == "double")
+    return octave_hash_map::double_key;
+  else if (name == "single")
+    return octave_hash_map::single_key;
+  else if (name == "int32")
+    return octave_hash_map::int32_key;
+  else if (name == "uint32")
+    return octave_hash_map::uint32_key;
+  else if (name == "int64")
+    return octave_hash_map::int64_key;
+  else if (name == "uint64")
+    return octave_hash_map::uint64_key;
+  else
+    error ("hash map: unsupported key type '%s'", name.c_str ());
+}
+
+octave_hash_map::octave_hash_map ()
+  : octave_base_value (), m_table (new table (char_key))
+{ }
+
+octave_hash_map::octave_hash_map (const std::string& key_type)
+  : octave_base_value (), m_table (new table (hash_map_key_type (key_type)))
+{ }
+
+void
+octave_hash_map::print (std::ostream& os, bool pr_as_read_syntax)
+{
+  print_raw (os, pr_as_read_syntax);
+  newline (os);
+}
+
+void
+octave_hash_map::print_raw (std::ostream& os, bool) const
+{
+  os << "<hash map with " << count () << " keys>";
+}
+
+octave_idx_type
+octave_hash_map::count () const
+{
+  return m_table->count ();
+}
+
+Cell
+octave_hash_map::keys () const
+{
+  const std::vector<octave_idx_type>& order = m_table->order ();
+
+  Cell retval (1, order.size ());
+
+  for (std::size_t i = 0; i < order.size (); i++)
+    retval(i) = m_table->key (order[i]);
+
+  return retval;
+}
+
+Cell
+octave_hash_map::values () const
+{
+  const std::vector<octave_idx_type>& order = m_table->order ();
+
+  Cell retval (1, order.size ());
+
+  for (std::size_t i = 0; i < order.size (); i++)
+    retval(i) = m_table->value (order[i]);
+
+  return retval;
+}
+
+Cell
+octave_hash_map::values (const octave_value& keys, boolNDArray& found) const
+{
+  hash_map_keys hkeys = m_table->convert (keys);
+
+  Cell retval (hkeys.dims);
+  found = boolNDArray (hkeys.dims, false);
+
+  for (octave_idx_type i = 0; i < retval.numel (); i++)
+    {
+      octave_idx_type k = m_table->find (hkeys, i);
+
+      if (k >= 0)
+        {
+          retval(i) = m_table->value (k);
+          found(i) = true;
+        }
+    }
+
+  return retval;
+}
+
+boolNDArray
+octave_hash_map::iskey (const octave_value& keys) const
+{
+  hash_map_keys hkeys = m_table->convert (keys);
+
+  boolNDArray retval (hkeys.dims, false);
+
+  for (octave_idx_type i = 0; i < retval.numel (); i++)
+    retval(i) = m_table->find (hkeys, i) >= 0;
+
+  return retval;
+}
+
+void
+octave_hash_map::assign (const octave_value& keys, const Cell& vals) const
+{
+  hash_map_keys hkeys = m_table->convert (keys);
+
+  octave_idx_type n = hkeys.valid.size ();
+
+  if (vals.numel () != n)
+    error ("hash map: the number of keys and values must match");
+
+  if (std::find (hkeys.valid.begin (), hkeys.valid.end (), false)
+      != hkeys.valid.end ())
+    error ("hash map: key type does not match the type of the map");
+
+  for (octave_idx_type i = 0; i < n; i++)
+    m_table->assign (hkeys, i, vals(i));
+}
+
+void
+octave_hash_map::remove (const octave_value& keys) const
+{
+  hash_map_keys hkeys = m_table->convert (keys);
+
+  for (std::size_t i = 0; i < hkeys.valid.size (); i++)
+    {
+      if (hkeys.valid[i])
+        m_table->erase (hkeys, i);
+    }
+}
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+static const octave_hash_map&
+hash_map_arg (const octave_value& arg, const char *who)
+{
+  if (arg.type_id () != octave_hash_map::static_type_id ())
+    error ("%s: H must be a hash map", who);
+
+  return dynamic_cast<const octave_hash_map&> (arg.get_rep ());
+}
+
+DEFUN (__hash_map__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{h} =} __hash_map__ (@var{key_type})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 1)
+    print_usage ();
+
+  std::string key_type
+    = args(0).xstring_value ("__hash_map__: KEY_TYPE must be a string");
+
+  return ovl (new octave_hash_map (key_type));
+}
+
+DEFUN (__hash_map_count__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{n} =} __hash_map_count__ (@var{h})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 1)
+    print_usage ();
+
+  const octave_hash_map& h = hash_map_arg (args(0), "__hash_map_count__");
+
+  return ovl (static_cast<double> (h.count ()));
+}
+
+DEFUN (__hash_map_keys__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{keys} =} __hash_map_keys__ (@var{h})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 1)
+    print_usage ();
+
+  const octave_hash_map& h = hash_map_arg (args(0), "__hash_map_keys__");
+
+  return ovl (h.keys ());
+}
+
+DEFUN (__hash_map_values__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{vals} =} __hash_map_values__ (@var{h})
+@deftypefnx {} {[@var{vals}, @var{found}] =} __hash_map_values__ (@var{h}, @var{keys})
+Undocumented internal function.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 1 || nargin > 2)
+    print_usage ();
+
+  const octave_hash_map& h = hash_map_arg (args(0), "__hash_map_values__");
+
+  if (nargin == 1)
+    return ovl (h.values ());
+
+  boolNDArray found;
+
+  Cell vals = h.values (args(1), found);
+
+  return ovl (vals, found);
+}
+
+DEFUN (__hash_map_iskey__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{tf} =} __hash_map_iskey__ (@var{h}, @var{keys})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 2)
+    print_usage ();
+
+  const octave_hash_map& h = hash_map_arg (args(0), "__hash_map_iskey__");
+
+  return ovl (h.iskey (args(1)));
+}
+
+DEFUN (__hash_map_assign__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {} __hash_map_assign__ (@var{h}, @var{keys}, @var{vals})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 3)
+    print_usage ();
+
+  const octave_hash_map& h = hash_map_arg (args(0), "__hash_map_assign__");
+
+  const Cell vals
+    = args(2).xcell_value ("__hash_map_assign__: VALS must be a cell array");
+
+  h.assign (args(1), vals);
+
+  return ovl ();
+}
+
+DEFUN (__hash_map_remove__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {} __hash_map_remove__ (@var{h}, @var{keys})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 2)
+    print_usage ();
+
+  const octave_hash_map& h = hash_map_arg (args(0), "__hash_map_remove__");
+
+  h.remove (args(1));
+
+  return ovl ();
+}
+
+/*
+%!test
+%! h = __hash_map__ ("double");
+%! __hash_map_assign__ (h, 1:1000, num2cell (2 * (1:1000)));
+%! assert (__hash_map_count__ (h), 1000);
+%! [v, found] = __hash_map_values__ (h, [3, 1001; -0, 500]);
+%! assert (v, {6, []; [], 1000});
+%! assert (found, [true, false; false, true]);
+%! __hash_map_remove__ (h, 2:2:1000);
+%! assert (__hash_map_keys__ (h), num2cell (1:2:999));
+%! assert (__hash_map_iskey__ (h, {1, 2, "a"}), [true, false, false]);
+%! h2 = h;
+%! __hash_map_assign__ (h2, {NaN, -Inf}, {"nan", "-inf"});
+%! assert (__hash_map_count__ (h), 502);
+%! k = __hash_map_keys__ (h);
+%! assert (k{1}, -Inf);
+%! assert (isnan (k{end}));
+
+%!test
+%! h = __hash_map__ ("char");
+%! __hash_map_assign__ (h, {"b", "", "a"}, {2, 0, 1});
+%! assert (__hash_map_keys__ (h), {"", "a", "b"});
+%! assert (__hash_map_values__ (h), {0, 1, 2});
+%! assert (__hash_map_iskey__ (h, "b"), true);
+%! assert (__hash_map_iskey__ (h, [1, 2]), [false, false]);
+
+%!error <unsupported key type> __hash_map__ ("int8")
+%!error <key type does not match>
+%! __hash_map_assign__ (__hash_map__ ("char"), {1}, {1});
+*/
+
+OCTAVE_END_NAMESPACE(octave)
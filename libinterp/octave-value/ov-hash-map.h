@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_ov_hash_map_h)
+#define octave_ov_hash_map_h 1
+
+#include "octave-config.h"
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+#include "ov-base.h"
+#include "ov.h"
+
+class Cell;
+class boolNDArray;
+
+// A hash table that maps numeric or string keys to values.  This is the
+// storage of containers.Map objects.
+//
+// Like the handle object that uses it, a value of this type is a
+// reference: copies share the same table, and the functions that modify
+// the table are const.
+
+class OCTINTERP_API octave_hash_map : public octave_base_value
+{
+public:
+
+  enum key_type
+  {
+    char_key,
+    double_key,
+    single_key,
+    int32_key,
+    uint32_key,
+    int64_key,
+    uint64_key
+  };
+
+  octave_hash_map ();
+
+  // KEY_TYPE is the class name of the keys, as for containers.Map.
+  octave_hash_map (const std::string& key_type);
+
+  octave_hash_map (const octave_hash_map&) = default;
+
+  ~octave_hash_map () = default;
+
+  octave_base_value * clone () const { return new octave_hash_map (*this); }
+
+  octave_base_value * empty_clone () const { return new octave_hash_map (); }
+
+  bool is_defined () const { return true; }
+
+  dim_vector dims () const
+  {
+    static dim_vector dv (1, 1);
+    return dv;
+  }
+
+  bool print_as_scalar () const { return true; }
+
+  void print (std::ostream& os, bool pr_as_read_syntax = false);
+
+  void print_raw (std::ostream& os, bool pr_as_read_syntax = false) const;
+
+  // Number of keys.
+  octave_idx_type count () const;
+
+  // All keys and their values, sorted by key, as 1xN cell arrays.
+  Cell keys () const;
+  Cell values () const;
+
+  // The values for the keys KEYS, which may be a cell array of keys, an
+  // array of numeric keys, or a single string key.  FOUND is set to
+  // false for keys that are not in the table, whose value is left
+  // empty.
+  Cell values (const octave_value& keys, boolNDArray& found) const;
+
+  // True for the elements of KEYS that are in the table.
+  boolNDArray iskey (const octave_value& keys) const;
+
+  // Set the values for KEYS to the elements of the cell array VALS.
+  void assign (const octave_value& keys, const Cell& vals) const;
+
+  // Remove the elements of KEYS that are in the table.
+  void remove (const octave_value& keys) const;
+
+private:
+
+  class table;
+
+  std::shared_ptr<table> m_table;
+
+  DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
+};
+
+#endif
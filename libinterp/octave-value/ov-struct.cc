@@ -1355,6 +1355,20 @@ octave_scalar_struct::subsasgn (const std::string& type,
 %! idx = struct ("type", ".", "subs", {{"a", "b"}});
 %! fail ("x = subsasgn (x, idx, 42)", ...
 %!       "structure field names must be strings");
+
+%!test
+%! s = struct ();
+%! s.zeta = 1;
+%! s.alpha = 2;
+%! s.mid = 3;
+%! assert (fieldnames (s), {"zeta"; "alpha"; "mid"});
+%! s = rmfield (s, "alpha");
+%! t = s;
+%! t.beta = 4;
+%! assert (fieldnames (s), {"zeta"; "mid"});
+%! assert (fieldnames (t), {"zeta"; "mid"; "beta"});
+%! assert ([t.zeta, t.mid, t.beta], [1, 3, 4]);
+%! assert (isequal (orderfields (t), struct ("beta", 4, "mid", 3, "zeta", 1)));
 */
 
 octave_value
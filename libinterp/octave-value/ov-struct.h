@@ -266,6 +266,16 @@ public:
   bool isfield (const std::string& field_name) const
   { return m_map.isfield (field_name); }
 
+  // Direct field access for the bytecode interpreter, which bypasses
+  // the generic subsref and subsasgn machinery for S.NAME.  The field
+  // name must be a valid identifier.
+
+  octave_value getfield (const std::string& field_name) const
+  { return m_map.getfield (field_name); }
+
+  void setfield (const std::string& field_name, const octave_value& val)
+  { m_map.setfield (field_name, val.storable_value ()); }
+
   void print (std::ostream& os, bool pr_as_read_syntax = false);
 
   void print_raw (std::ostream& os, bool pr_as_read_syntax = false) const;
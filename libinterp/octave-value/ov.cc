@@ -73,6 +73,7 @@
 #include "ov-struct.h"
 #include "ov-class.h"
 #include "ov-classdef.h"
+#include "ov-hash-map.h"
 #include "ov-oncleanup.h"
 #include "ov-cs-list.h"
 #include "ov-colon.h"
@@ -3599,6 +3600,7 @@ install_types (octave::type_info& ti)
   octave_null_sq_str::register_type (ti);
   octave_lazy_index::register_type (ti);
   octave_oncleanup::register_type (ti);
+  octave_hash_map::register_type (ti);
   octave_java::register_type (ti);
   octave_trivial_range::register_type (ti);
 }
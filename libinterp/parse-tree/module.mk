@@ -37,6 +37,7 @@ PARSE_TREE_INC = \
   %reldir%/pt-loop.h \
   %reldir%/pt-mat.h \
   %reldir%/pt-misc.h \
+  %reldir%/pt-parfor.h \
   %reldir%/pt-pr-code.h \
   %reldir%/pt-select.h \
   %reldir%/pt-spmd.h \
@@ -86,6 +87,7 @@ PARSE_TREE_SRC = \
   %reldir%/pt-loop.cc \
   %reldir%/pt-mat.cc \
   %reldir%/pt-misc.cc \
+  %reldir%/pt-parfor.cc \
   %reldir%/pt-pr-code.cc \
   %reldir%/pt-select.cc \
   %reldir%/pt-spmd.cc \
@@ -47,6 +47,7 @@
 #include "ov-ref.h"
 #include "ov-range.h"
 #include "ov-inline.h"
+#include "ov-struct.h"
 
 #include "ov-vm.h"
 #include "ov-fcn-handle.h"
@@ -5364,6 +5365,24 @@ index_struct_n:
 
     octave_value &ov = TOP_OV ();
 
+    // Look up a field of a scalar struct directly.  Missing fields and
+    // values that need to be called take the general path below.
+    if (nargout <= 1
+        && ov.type_id () == octave_scalar_struct::static_type_id ())
+      {
+        const octave_scalar_struct& s
+          = static_cast<const octave_scalar_struct&> (ov.get_rep ());
+
+        octave_value val = s.getfield (name_data[slot_for_field]);
+
+        if (val.is_defined () && ! val.is_function ())
+          {
+            STACK_DESTROY (1);
+            PUSH_OV (std::move (val));
+            DISPATCH ();
+          }
+      }
+
     std::string field_name = name_data [slot_for_field];
 
     octave_value ov_field_name {field_name};
@@ -5425,6 +5444,20 @@ subasgn_struct:
     else
       ov.ref_rep ()->ref ().make_unique ();
 
+    // Store a field of a scalar struct that we own directly.
+    if (OCTAVE_LIKELY (! ov.is_ref ())
+        && ov.type_id () == octave_scalar_struct::static_type_id ()
+        && rhs.is_defined () && ! rhs.is_cs_list ())
+      {
+        octave_scalar_struct *s
+          = static_cast<octave_scalar_struct *> (ov.internal_rep ());
+
+        s->setfield (name_data[field_slot], rhs);
+
+        STACK_DESTROY (1);
+        DISPATCH ();
+      }
+
     // TODO: Uggly containers
     std::list<octave_value_list> idx;
     octave_value_list ovl;
@@ -41,6 +41,7 @@
 #include "file-stat.h"
 #include "lo-array-errwarn.h"
 #include "lo-ieee.h"
+#include "lo-mappers.h"
 #include "oct-env.h"
 
 #include "bp-table.h"
@@ -50,6 +51,7 @@
 #include "error.h"
 #include "errwarn.h"
 #include "event-manager.h"
+#include "fork-workers.h"
 #include "input.h"
 #include "interpreter-private.h"
 #include "interpreter.h"
@@ -66,6 +68,7 @@
 #include "pt-all.h"
 #include "pt-anon-scopes.h"
 #include "pt-eval.h"
+#include "pt-parfor.h"
 #include "pt-tm-const.h"
 #include "stack-frame.h"
 #include "symtab.h"
@@ -3103,9 +3106,6 @@ tree_evaluator::visit_simple_for_command (tree_simple_for_command& cmd)
   if (m_debug_mode)
     do_breakpoint (cmd.is_active_breakpoint (*this));
 
-  // FIXME: need to handle PARFOR loops here using cmd.in_parallel ()
-  // and cmd.maxproc_expr ();
-
   unwind_protect_var<bool> upv (m_in_loop_command, true);
 
   tree_expression *expr = cmd.control_expr ();
@@ -3121,6 +3121,17 @@ tree_evaluator::visit_simple_for_command (tree_simple_for_command& cmd)
 
   tree_statement_list *loop_body = cmd.body ();
 
+  if (cmd.in_parallel ())
+    {
+      int nworkers = parfor_num_workers (cmd);
+
+      // Loops that can't be distributed over worker processes run
+      // serially below.
+
+      if (nworkers > 1 && execute_parfor_loop (cmd, rhs, ult, nworkers))
+        return;
+    }
+
   if (rhs.is_range ())
     {
       // FIXME: is there a better way to dispatch here?
@@ -3217,6 +3228,90 @@ tree_evaluator::visit_simple_for_command (tree_simple_for_command& cmd)
          cmd.line (), cmd.column ());
 }
 
+// Return the number of worker processes for a parfor loop, which is
+// limited by the optional second argument of parfor.  That argument is
+// only evaluated if more than one worker is allowed, as serial loops
+// have always ignored it.
+
+int
+tree_evaluator::parfor_num_workers (tree_simple_for_command& cmd)
+{
+  int retval = m_parfor_max_workers;
+
+  if (retval <= 1)
+    return retval;
+
+  tree_expression *maxproc_expr = cmd.maxproc_expr ();
+
+  if (maxproc_expr)
+    {
+      octave_value maxproc = maxproc_expr->evaluate (*this);
+
+      double dval = maxproc.xdouble_value ("parfor: maximum number of "
+                                           "workers must be a real scalar");
+
+      if (math::isnan (dval) || dval < 0)
+        error ("parfor: maximum number of workers must be non-negative");
+
+      if (dval < retval)
+        retval = static_cast<int> (dval);
+    }
+
+  return retval;
+}
+
+// Run the iterations of a parfor loop in worker processes if the loop
+// and the state of the interpreter allow it.  Return false if the loop
+// must be run serially instead.
+
+bool
+tree_evaluator::execute_parfor_loop (tree_simple_for_command& cmd,
+                                     const octave_value& rhs,
+                                     octave_lvalue& ult, int nworkers)
+{
+  tree_statement_list *loop_body = cmd.body ();
+
+  if (! loop_body || ! can_fork_workers (m_interpreter))
+    return false;
+
+  // Only the elements of numeric row vectors are distributed.
+
+  if (! ((rhs.is_range () && rhs.is_double_type ())
+         || (rhs.is_real_matrix () && rhs.rows () == 1 && rhs.ndims () == 2))
+      || rhs.numel () < 2)
+    return false;
+
+  tree_parfor_analyzer plan (cmd);
+
+  if (! plan.can_run_in_parallel ())
+    return false;
+
+  // Reductions start from the value before the loop, and global
+  // variables can't be shared with the workers.
+
+  for (const auto& nm : plan.reduction_variables ())
+    {
+      if (! is_variable (nm) || is_global (nm))
+        return false;
+    }
+
+  for (const auto& nm : plan.temporary_variables ())
+    {
+      if (is_global (nm))
+        return false;
+    }
+
+  for (const auto& nm_expr : plan.sliced_outputs ())
+    {
+      if (is_global (nm_expr.first))
+        return false;
+    }
+
+  run_parfor_workers (*this, plan, *loop_body, ult, rhs, nworkers);
+
+  return true;
+}
+
 void
 tree_evaluator::visit_complex_for_command (tree_complex_for_command& cmd)
 {
@@ -4548,6 +4643,14 @@ tree_evaluator::max_recursion_depth (const octave_value_list& args,
                                 "max_recursion_depth", 0);
 }
 
+octave_value
+tree_evaluator::parfor_max_workers (const octave_value_list& args,
+                                    int nargout)
+{
+  return set_internal_variable (m_parfor_max_workers, args, nargout,
+                                "parfor_max_workers", 1);
+}
+
 symbol_info_list
 tree_evaluator::glob_symbol_info (const std::string& pattern) const
 {
@@ -5285,6 +5388,81 @@ return tw.max_recursion_depth (args, nargout);
 %!error max_recursion_depth (1, 2)
 */
 
+DEFMETHOD (parfor_max_workers, interp, args, nargout,
+         doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{val} =} parfor_max_workers ()
+@deftypefnx {} {@var{old_val} =} parfor_max_workers (@var{new_val})
+@deftypefnx {} {@var{old_val} =} parfor_max_workers (@var{new_val}, "local")
+Query or set the internal limit on the number of worker processes that
+execute the iterations of a @code{parfor} loop.
+
+The default value of 1 runs all @code{parfor} loops serially, like
+@code{for} loops.  With a larger value, the iterations of a loop are divided
+among at most this many child processes, which start with a copy of the
+workspace.  The optional second argument of @code{parfor} can further limit
+the number of processes for a single loop.
+
+A loop is only run in parallel if its iterations are independent.  Its body
+must consist of assignments and expressions only, and every variable that is
+assigned in it must be one of the following:
+
+@itemize
+@item
+a sliced output that is assigned once as
+@code{@var{x}(:, @dots{}, @var{i}, @dots{}, :) = @dots{}}, where @var{i} is
+the loop variable, and is not used otherwise in the loop;
+
+@item
+a reduction variable that is only used as
+@code{@var{s} = @var{s} + @dots{}} or @code{@var{s} += @dots{}};
+
+@item
+a temporary variable that is assigned before it is used in each iteration.
+@end itemize
+
+The loop must iterate over a numeric row vector and must not call functions
+that access the workspace, such as @code{eval}.  All other loops, and all loops
+in the GUI, in the debugger, or while profiling, are run serially.  Changes to
+global variables, files, or other state outside of the variables listed above
+that are made in the body of a parallel loop are not reflected in the calling
+process.
+
+Each worker process seeds the generators used by @code{rand}, @code{randn},
+@code{rande}, @code{randg}, and @code{randp}, also when they are called by
+other functions, with a state derived from the state of the calling process
+and the number of the worker.  The workers therefore draw different random
+numbers, and a loop run after setting the state, e.g., with
+@code{rand ("state", 42)}, draws the same numbers again if the number of
+workers is the same.  Because iterations are handed to the workers as they
+become free, these numbers are not the ones a serial loop would draw, and the
+iteration in which each number is used may change from run to run.  After
+the loop, the generators of the calling process continue from a new state.
+
+When called from inside a function with the @qcode{"local"} option, the
+variable is changed locally for the function and any subroutines it calls.
+The original variable value is restored when exiting the function.
+
+@seealso{parfor, nproc}
+@end deftypefn */)
+{
+  tree_evaluator& tw = interp.get_evaluator ();
+
+  return tw.parfor_max_workers (args, nargout);
+}
+
+/*
+%!test
+%! orig_val = parfor_max_workers ();
+%! old_val = parfor_max_workers (4);
+%! assert (orig_val, old_val);
+%! assert (parfor_max_workers (), 4);
+%! parfor_max_workers (orig_val);
+%! assert (parfor_max_workers (), orig_val);
+
+%!error parfor_max_workers (1, 2)
+%!error parfor_max_workers (0)
+*/
+
 DEFMETHOD (whos_line_format, interp, args, nargout,
          doc: /* -*- texinfo -*-
 @deftypefn  {} {@var{val} =} whos_line_format ()
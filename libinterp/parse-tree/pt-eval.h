@@ -134,6 +134,7 @@ public:
       m_call_stack (*this), m_profiler (), m_debug_frame (0),
       m_debug_mode (false), m_quiet_breakpoint_flag (false),
       m_debugger_stack (), m_exit_status (0), m_max_recursion_depth (256),
+      m_parfor_max_workers (1),
       m_whos_line_format ("  %la:5; %ln:6; %cs:16:6:1;  %rb:12;  %lc:-1;\n"),
       m_silent_functions (false), m_string_fill_char (' '), m_PS4 ("+ "),
       m_dbstep_flag (0), m_break_on_next_stmt (false), m_echo (ECHO_OFF),
@@ -613,6 +614,18 @@ public:
   octave_value
   max_recursion_depth (const octave_value_list& args, int nargout);
 
+  int parfor_max_workers () const { return m_parfor_max_workers; }
+
+  int parfor_max_workers (int n)
+  {
+    int val = m_parfor_max_workers;
+    m_parfor_max_workers = n;
+    return val;
+  }
+
+  octave_value
+  parfor_max_workers (const octave_value_list& args, int nargout);
+
   bool silent_functions () const { return m_silent_functions; }
 
   bool silent_functions (bool b)
@@ -884,6 +897,12 @@ private:
                            octave_lvalue& ult,
                            tree_statement_list *loop_body);
 
+  int parfor_num_workers (tree_simple_for_command& cmd);
+
+  bool execute_parfor_loop (tree_simple_for_command& cmd,
+                            const octave_value& rhs, octave_lvalue& ult,
+                            int nworkers);
+
   void set_echo_state (int type, const std::string& file_name, int pos);
 
   void maybe_set_echo_state ();
@@ -955,6 +974,9 @@ private:
   // called recursively.
   int m_max_recursion_depth;
 
+  // Maximum number of worker processes used to run parfor loops.
+  int m_parfor_max_workers;
+
   // Defines layout for the whos/who -long command
   std::string m_whos_line_format;
 
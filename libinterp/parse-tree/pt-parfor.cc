@@ -0,0 +1,500 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "error.h"
+#include "fork-workers.h"
+#include "oct-lvalue.h"
+#include "ov.h"
+#include "ovl.h"
+#include "pt-all.h"
+#include "pt-eval.h"
+#include "pt-parfor.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+tree_parfor_analyzer::tree_parfor_analyzer (tree_simple_for_command& cmd)
+  : tree_walker (), m_ok (false), m_loop_var (), m_sliced (),
+    m_reductions (), m_temporaries (), m_names ()
+{
+  tree_expression *lhs = cmd.left_hand_side ();
+  tree_statement_list *body = cmd.body ();
+
+  if (! lhs || ! lhs->is_identifier () || ! body)
+    return;
+
+  m_loop_var = lhs->name ();
+
+  m_ok = true;
+
+  classify (*body);
+
+  if (m_ok)
+    check_uses (*body);
+}
+
+void
+tree_parfor_analyzer::visit_identifier (tree_identifier& id)
+{
+  m_names.insert (id.name ());
+}
+
+void
+tree_parfor_analyzer::visit_simple_assignment (tree_simple_assignment&)
+{
+  // Assignments nested in other expressions are not analyzed.
+
+  m_ok = false;
+}
+
+void
+tree_parfor_analyzer::visit_multi_assignment (tree_multi_assignment&)
+{
+  m_ok = false;
+}
+
+// Sort the variables assigned in BODY into sliced outputs, reductions
+// and temporaries.
+
+void
+tree_parfor_analyzer::classify (tree_statement_list& body)
+{
+  for (tree_statement *stmt : body)
+    {
+      if (! stmt)
+        continue;
+
+      if (stmt->is_command ())
+        {
+          if (dynamic_cast<tree_no_op_command *> (stmt->command ()))
+            continue;
+
+          // Control flow, declarations, and nested loops.
+          m_ok = false;
+          return;
+        }
+
+      tree_expression *expr = stmt->expression ();
+
+      if (! expr)
+        continue;
+
+      if (! expr->is_assignment_expression ())
+        {
+          // The value of an expression statement may be stored in ans.
+          m_temporaries.insert ("ans");
+          continue;
+        }
+
+      tree_simple_assignment *asn
+        = dynamic_cast<tree_simple_assignment *> (expr);
+
+      if (! asn)
+        {
+          m_ok = false;
+          return;
+        }
+
+      tree_expression *lhs = asn->left_hand_side ();
+
+      if (lhs->is_identifier ())
+        {
+          std::string nm = lhs->name ();
+          tree_expression *term = nullptr;
+
+          if (nm == m_loop_var)
+            {
+              m_ok = false;
+              return;
+            }
+
+          // A variable that was already assigned a value in this
+          // iteration is a temporary, even if it is accumulated.
+
+          if (m_temporaries.count (nm) == 0
+              && is_reduction (*asn, nm, term))
+            m_reductions.insert (nm);
+          else
+            m_temporaries.insert (nm);
+        }
+      else if (is_sliced_output (lhs))
+        {
+          tree_index_expression *idx
+            = dynamic_cast<tree_index_expression *> (lhs);
+
+          std::string nm = idx->name ();
+
+          tree_expression *rhs = asn->right_hand_side ();
+
+          // Assigning [] would delete elements.
+
+          bool is_deletion
+            = ((rhs->is_matrix ()
+                && dynamic_cast<tree_matrix *> (rhs)->empty ())
+               || (rhs->is_constant ()
+                   && dynamic_cast<tree_constant *> (rhs)->value ().isempty ()));
+
+          if (nm == m_loop_var || m_sliced.count (nm)
+              || asn->op_type () != octave_value::op_asn_eq || is_deletion)
+            {
+              m_ok = false;
+              return;
+            }
+
+          m_sliced[nm] = idx;
+        }
+      else
+        {
+          m_ok = false;
+          return;
+        }
+    }
+
+  for (const auto& nm : m_temporaries)
+    {
+      if (m_reductions.count (nm) || m_sliced.count (nm))
+        {
+          m_ok = false;
+          return;
+        }
+    }
+
+  for (const auto& nm : m_reductions)
+    {
+      if (m_sliced.count (nm))
+        {
+          m_ok = false;
+          return;
+        }
+    }
+}
+
+// Check that sliced outputs and reduction variables are only used in
+// their own assignments, that temporaries are assigned before they are
+// used, and that no function is called that inspects or changes the
+// workspace.  Workers reseed the random number generators, so calls to
+// rand and friends are allowed.
+
+void
+tree_parfor_analyzer::check_uses (tree_statement_list& body)
+{
+  static const std::set<std::string> unsafe_functions
+    = { "assignin", "clear", "clearvars", "eval", "evalc", "evalin",
+        "exit", "input", "inputname", "keyboard", "load", "quit",
+        "who", "whos"
+      };
+
+  std::set<std::string> assigned;
+
+  for (tree_statement *stmt : body)
+    {
+      if (! stmt || stmt->is_command ())
+        continue;
+
+      tree_expression *expr = stmt->expression ();
+
+      if (! expr)
+        continue;
+
+      std::set<std::string> uses;
+      std::string assigned_name;
+
+      if (! expr->is_assignment_expression ())
+        {
+          uses = identifiers (expr);
+          assigned_name = "ans";
+        }
+      else
+        {
+          tree_simple_assignment *asn
+            = dynamic_cast<tree_simple_assignment *> (expr);
+
+          tree_expression *lhs = asn->left_hand_side ();
+
+          if (lhs->is_identifier ()
+              && m_reductions.count (lhs->name ()))
+            {
+              tree_expression *term = nullptr;
+
+              if (! is_reduction (*asn, lhs->name (), term))
+                {
+                  m_ok = false;
+                  return;
+                }
+
+              uses = identifiers (term);
+            }
+          else
+            {
+              uses = identifiers (asn->right_hand_side ());
+
+              if (lhs->is_identifier ())
+                assigned_name = lhs->name ();
+            }
+        }
+
+      if (! m_ok)
+        return;
+
+      for (const auto& nm : uses)
+        {
+          if (unsafe_functions.count (nm) || m_sliced.count (nm)
+              || m_reductions.count (nm)
+              || (m_temporaries.count (nm) && ! assigned.count (nm)))
+            {
+              m_ok = false;
+              return;
+            }
+        }
+
+      if (! assigned_name.empty ())
+        assigned.insert (assigned_name);
+    }
+}
+
+// Return true if LHS has the form X(:,...,i,...,:) where i is the loop
+// variable.
+
+bool
+tree_parfor_analyzer::is_sliced_output (tree_expression *lhs)
+{
+  if (! lhs->is_index_expression ())
+    return false;
+
+  tree_index_expression *idx = dynamic_cast<tree_index_expression *> (lhs);
+
+  tree_expression *base = idx->expression ();
+
+  if (! base || ! base->is_identifier () || idx->type_tags () != "(")
+    return false;
+
+  tree_argument_list *args = idx->arg_lists ().front ();
+
+  if (! args)
+    return false;
+
+  int n_loop_var = 0;
+
+  for (tree_expression *arg : *args)
+    {
+      if (! arg)
+        return false;
+
+      if (arg->is_identifier () && arg->name () == m_loop_var)
+        n_loop_var++;
+      else if (! (arg->is_constant ()
+                  && dynamic_cast<tree_constant *> (arg)->value ().is_magic_colon ()))
+        return false;
+    }
+
+  return n_loop_var == 1;
+}
+
+// Return true if EXPR has the form NAME = NAME + TERM, NAME = TERM + NAME,
+// or NAME += TERM, where TERM does not use NAME.
+
+bool
+tree_parfor_analyzer::is_reduction (tree_simple_assignment& expr,
+                                    const std::string& name,
+                                    tree_expression *& term)
+{
+  tree_expression *rhs = expr.right_hand_side ();
+
+  term = nullptr;
+
+  if (expr.op_type () == octave_value::op_add_eq)
+    term = rhs;
+  else if (expr.op_type () == octave_value::op_asn_eq
+           && rhs->is_binary_expression () && ! rhs->is_boolean_expression ())
+    {
+      tree_binary_expression *binop
+        = dynamic_cast<tree_binary_expression *> (rhs);
+
+      if (binop->op_type () != octave_value::op_add)
+        return false;
+
+      tree_expression *op1 = binop->lhs ();
+      tree_expression *op2 = binop->rhs ();
+
+      if (op1 && op1->is_identifier () && op1->name () == name)
+        term = op2;
+      else if (op2 && op2->is_identifier () && op2->name () == name)
+        term = op1;
+    }
+
+  if (! term)
+    return false;
+
+  // Walking TERM may clear m_ok for nested assignments.  That is
+  // reported by the caller.
+
+  bool ok = m_ok;
+
+  bool uses_name = identifiers (term).count (name) != 0;
+
+  m_ok = ok && m_ok;
+
+  return ! uses_name;
+}
+
+std::set<std::string>
+tree_parfor_analyzer::identifiers (tree_expression *expr)
+{
+  m_names.clear ();
+
+  if (expr)
+    expr->accept (*this);
+
+  return m_names;
+}
+
+// Values of the loop variable for iterations BEGIN to END-1.
+
+static octave_value
+parfor_chunk_values (octave_value rhs, octave_idx_type begin,
+                     octave_idx_type end)
+{
+  return rhs.index_op (ovl (octave_value (idx_vector (begin, end))));
+}
+
+// Run iterations BEGIN to END-1 in a worker process and write the values
+// that are needed to merge the results to OS.
+
+static void
+run_parfor_chunk (tree_evaluator& tw, const tree_parfor_analyzer& plan,
+                  tree_statement_list& body, octave_lvalue& ult,
+                  octave_value rhs, octave_idx_type begin,
+                  octave_idx_type end, bool last, std::ostream& os)
+{
+  // Nested parfor loops run serially in the workers.
+  tw.parfor_max_workers (1);
+
+  for (const auto& nm : plan.reduction_variables ())
+    tw.assign (nm, octave_value (0.0));
+
+  for (octave_idx_type k = begin; k < end; k++)
+    {
+      ult.assign (octave_value::op_asn_eq, rhs.index_op (ovl (k+1)));
+
+      body.accept (tw);
+    }
+
+  if (last)
+    {
+      for (const auto& nm : plan.temporary_variables ())
+        {
+          octave_value val = tw.varval (nm);
+
+          if (val.is_defined ())
+            write_worker_value (os, nm, val);
+        }
+    }
+
+  for (const auto& nm : plan.reduction_variables ())
+    write_worker_value (os, nm, tw.varval (nm));
+
+  // Index the sliced outputs with all values of the loop variable in
+  // this chunk at once.
+
+  ult.assign (octave_value::op_asn_eq, parfor_chunk_values (rhs, begin, end));
+
+  for (const auto& nm_expr : plan.sliced_outputs ())
+    write_worker_value (os, nm_expr.first, nm_expr.second->evaluate (tw));
+}
+
+void
+run_parfor_workers (tree_evaluator& tw, const tree_parfor_analyzer& plan,
+                    tree_statement_list& body, octave_lvalue& ult,
+                    octave_value rhs, int nworkers)
+{
+  octave_idx_type n = rhs.numel ();
+
+  if (nworkers > n)
+    nworkers = n;
+
+  std::vector<octave_idx_type> chunk_begin (nworkers + 1);
+
+  for (int w = 0; w <= nworkers; w++)
+    chunk_begin[w] = (n * w) / nworkers;
+
+  // All results are read before any variable is changed so that the
+  // workspace is left unchanged if a worker failed.
+
+  std::vector<worker_values> results
+    = run_worker_processes ("parfor", nworkers,
+                            [&] (int w, std::ostream& os)
+                            {
+                              run_parfor_chunk (tw, plan, body, ult, rhs,
+                                                chunk_begin[w],
+                                                chunk_begin[w+1],
+                                                w == nworkers - 1, os);
+                            });
+
+  for (int w = 0; w < nworkers; w++)
+    {
+      worker_values& vals = results[w];
+
+      if (! plan.sliced_outputs ().empty ())
+        {
+          ult.assign (octave_value::op_asn_eq,
+                      parfor_chunk_values (rhs, chunk_begin[w],
+                                           chunk_begin[w+1]));
+
+          for (const auto& nm_expr : plan.sliced_outputs ())
+            {
+              octave_lvalue lval = nm_expr.second->lvalue (tw);
+
+              lval.assign (octave_value::op_asn_eq, vals[nm_expr.first]);
+            }
+        }
+
+      for (const auto& nm : plan.reduction_variables ())
+        tw.assign (nm, binary_op (octave_value::op_add, tw.varval (nm),
+                                  vals[nm]));
+    }
+
+  for (const auto& nm : plan.temporary_variables ())
+    {
+      auto p = results[nworkers-1].find (nm);
+
+      if (p != results[nworkers-1].end ())
+        tw.assign (nm, p->second);
+    }
+
+  // Leave the loop variable at its last value, as a serial loop does.
+
+  ult.assign (octave_value::op_asn_eq, rhs.index_op (ovl (n)));
+}
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_pt_parfor_h)
+#define octave_pt_parfor_h 1
+
+#include "octave-config.h"
+
+#include <map>
+#include <set>
+#include <string>
+
+#include "pt-walk.h"
+
+class octave_value;
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+class octave_lvalue;
+class tree_evaluator;
+
+// Classify the variables assigned in the body of a parfor loop and
+// decide whether its iterations are independent, so that they can be
+// distributed over worker processes.
+//
+// Only bodies that are a sequence of expressions and assignments are
+// accepted.  Each assigned variable must be one of
+//
+//   * a sliced output, assigned exactly once as X(:,...,i,...,:) = expr
+//     with the loop variable I as one index and colons as the others,
+//     and not used otherwise in the loop;
+//
+//   * a reduction variable, only used in statements of the form
+//     S = S + expr or S += expr;
+//
+//   * a temporary variable, which is assigned before it is used in the
+//     same iteration.
+//
+// Any other variables are only read and are passed to the workers
+// unchanged.
+
+class
+tree_parfor_analyzer : public tree_walker
+{
+public:
+
+  tree_parfor_analyzer () = delete;
+
+  tree_parfor_analyzer (tree_simple_for_command& cmd);
+
+  OCTAVE_DISABLE_COPY_MOVE (tree_parfor_analyzer)
+
+  ~tree_parfor_analyzer () = default;
+
+  bool can_run_in_parallel () const { return m_ok; }
+
+  std::string loop_variable () const { return m_loop_var; }
+
+  const std::map<std::string, tree_index_expression *>&
+  sliced_outputs () const { return m_sliced; }
+
+  const std::set<std::string>&
+  reduction_variables () const { return m_reductions; }
+
+  const std::set<std::string>&
+  temporary_variables () const { return m_temporaries; }
+
+  // The following methods, though public, don't belong to the
+  // intended user interface of this class.
+
+  void visit_identifier (tree_identifier&);
+
+  void visit_simple_assignment (tree_simple_assignment&);
+
+  void visit_multi_assignment (tree_multi_assignment&);
+
+private:
+
+  void classify (tree_statement_list& body);
+
+  void check_uses (tree_statement_list& body);
+
+  bool is_sliced_output (tree_expression *lhs);
+
+  bool is_reduction (tree_simple_assignment& expr, const std::string& name,
+                     tree_expression *& term);
+
+  std::set<std::string> identifiers (tree_expression *expr);
+
+  bool m_ok;
+
+  std::string m_loop_var;
+
+  std::map<std::string, tree_index_expression *> m_sliced;
+
+  std::set<std::string> m_reductions;
+
+  std::set<std::string> m_temporaries;
+
+  // Identifiers found while walking an expression.
+  std::set<std::string> m_names;
+};
+
+// Run the iterations over the columns of the row vector RHS in
+// NWORKERS forked processes and merge their results into the
+// workspace.  PLAN must have accepted the loop.
+
+extern void
+run_parfor_workers (tree_evaluator& tw, const tree_parfor_analyzer& plan,
+                    tree_statement_list& body, octave_lvalue& ult,
+                    octave_value rhs, int nworkers);
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
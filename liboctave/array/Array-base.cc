@@ -31,7 +31,10 @@
 // C++ source files that should have included config.h before including
 // this file.
 
+#include <algorithm>
 #include <ostream>
+#include <type_traits>
+#include <vector>
 
 #include "Array-util.h"
 #include "Array.h"
@@ -309,14 +312,24 @@ Array<T, Alloc>::linear_slice (octave_idx_type lo, octave_idx_type up) const
 }
 
 // Helper class for multi-d dimension permuting (generalized transpose).
+//
+// Singleton dimensions are dropped and dimensions that remain adjacent
+// after permuting are merged.  If the first remaining dimension is not
+// contiguous in the source and is too long for the source lines it
+// reads to stay in cache until their next elements are needed, it is
+// copied together with the dimension that is contiguous in small
+// square tiles.  For large arrays of trivially copyable elements, the
+// outermost loop is split across threads.
+
 class rec_permute_helper
 {
 public:
 
   rec_permute_helper (const dim_vector& dv, const Array<octave_idx_type>& perm)
 
-    : m_n (dv.ndims ()), m_top (0), m_dim (new octave_idx_type [2*m_n]),
-      m_stride (m_dim + m_n), m_use_blk (false)
+    : m_n (dv.ndims ()), m_top (0), m_tile (0), m_numel (dv.numel ()),
+      m_dim (new octave_idx_type [3*m_n]), m_stride (m_dim + m_n),
+      m_dstride (m_stride + m_n)
   {
     assert (m_n == perm.numel ());
 
@@ -325,16 +338,28 @@ public:
     cdim[0] = 1;
     for (int i = 1; i < m_n+1; i++) cdim[i] = cdim[i-1] * dv(i-1);
 
-    // Setup the permuted strides.
+    // Setup the permuted strides, skipping singleton dimensions.
+    int nd = 0;
     for (int k = 0; k < m_n; k++)
       {
         int kk = perm(k);
-        m_dim[k] = dv(kk);
-        m_stride[k] = cdim[kk];
+        if (dv(kk) != 1)
+          {
+            m_dim[nd] = dv(kk);
+            m_stride[nd] = cdim[kk];
+            nd++;
+          }
+      }
+
+    if (nd == 0)
+      {
+        m_dim[0] = 1;
+        m_stride[0] = 1;
+        nd = 1;
       }
 
     // Reduce contiguous runs.
-    for (int k = 1; k < m_n; k++)
+    for (int k = 1; k < nd; k++)
       {
         if (m_stride[k] == m_stride[m_top]*m_dim[m_top])
           m_dim[m_top] *= m_dim[k];
@@ -346,9 +371,24 @@ public:
           }
       }
 
-    // Determine whether we can use block transposes.
-    m_use_blk = m_top >= 1 && m_stride[1] == 1 && m_stride[0] == m_dim[1];
+    // The destination is filled in order.
+    m_dstride[0] = 1;
+    for (int k = 1; k <= m_top; k++)
+      m_dstride[k] = m_dstride[k-1] * m_dim[k-1];
 
+    // Find the dimension that is contiguous in the source if the first
+    // one is not.
+    if (m_stride[0] != 1 && m_dim[0] > 256)
+      {
+        for (int k = 1; k <= m_top; k++)
+          {
+            if (m_stride[k] == 1)
+              {
+                m_tile = k;
+                break;
+              }
+          }
+      }
   }
 
   OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (rec_permute_helper)
@@ -356,93 +396,154 @@ public:
   ~rec_permute_helper () { delete [] m_dim; }
 
   template <typename T>
-  void permute (const T *src, T *dest) const { do_permute (src, dest, m_top); }
+  void permute (const T *src, T *dest) const
+  {
+    bool par = use_threads<T> (m_numel);
+
+    // Outermost level that is looped over.  The tiled level is handled
+    // together with the first one.
+    int lev = (m_tile > 0 && m_tile == m_top) ? m_top - 1 : m_top;
+
+    if (lev > 0)
+      {
+        octave_idx_type len = m_dim[lev];
+        octave_idx_type step = m_stride[lev];
+        octave_idx_type dstep = m_dstride[lev];
+
+        auto permute_range = [=] (octave_idx_type i0, octave_idx_type i1)
+        {
+          for (octave_idx_type i = i0; i < i1; i++)
+            do_permute (src + i*step, dest + i*dstep, lev-1);
+        };
+
+        if (par)
+          octave::parallel_ranges (len, num_tasks (len), permute_range);
+        else
+          permute_range (0, len);
+      }
+    else if (m_tile > 0)
+      tile_copy (src, dest, m_dim[0], m_stride[0], m_dim[m_tile],
+                 m_dstride[m_tile], par);
+    else
+      do_permute (src, dest, 0);
+  }
 
   // Helper method for fast blocked transpose.
   template <typename T>
   static T *
   blk_trans (const T *src, T *dest, octave_idx_type nr, octave_idx_type nc)
+  {
+    tile_copy (src, dest, nc, nr, nr, nc, use_threads<T> (nr*nc));
+
+    return dest + nr*nc;
+  }
+
+private:
+
+  // Only split the work across threads if it is large enough to pay
+  // for starting them and the elements can be copied independently.
+  template <typename T>
+  static bool use_threads (octave_idx_type n)
+  {
+    return std::is_trivially_copyable<T>::value && n >= 65536;
+  }
+
+  // Number of ranges to split a loop of N independent iterations into.
+  static octave_idx_type num_tasks (octave_idx_type n)
+  {
+    return std::min (n, static_cast<octave_idx_type> (256));
+  }
+
+  // Copy the N0 x NP array at SRC, whose elements are S0 apart along
+  // the first dimension and contiguous along the second, to DEST,
+  // where they are contiguous along the first dimension and DP apart
+  // along the second.  The second dimension is split across threads
+  // if PAR is true.
+  template <typename T>
+  static void
+  tile_copy (const T *src, T *dest, octave_idx_type n0, octave_idx_type s0,
+             octave_idx_type np, octave_idx_type dp, bool par = false)
   {
     static const octave_idx_type m = 8;
-    OCTAVE_LOCAL_BUFFER (T, blk, m*m);
-    for (octave_idx_type kr = 0; kr < nr; kr += m)
-      for (octave_idx_type kc = 0; kc < nc; kc += m)
+
+    octave_idx_type nblk = (np + m - 1) / m;
+
+    auto copy_blocks = [=] (octave_idx_type b0, octave_idx_type b1)
+    {
+      for (octave_idx_type b = b0; b < b1; b++)
         {
-          octave_idx_type lr = std::min (m, nr - kr);
-          octave_idx_type lc = std::min (m, nc - kc);
-          if (lr == m && lc == m)
-            {
-              const T *ss = src + kc * nr + kr;
-              for (octave_idx_type j = 0; j < m; j++)
-                for (octave_idx_type i = 0; i < m; i++)
-                  blk[j*m+i] = ss[j*nr + i];
-              T *dd = dest + kr * nc + kc;
-              for (octave_idx_type j = 0; j < m; j++)
-                for (octave_idx_type i = 0; i < m; i++)
-                  dd[j*nc+i] = blk[i*m+j];
-            }
-          else
+          octave_idx_type kp = b * m;
+          octave_idx_type lp = std::min (m, np - kp);
+
+          for (octave_idx_type k0 = 0; k0 < n0; k0 += m)
             {
-              const T *ss = src + kc * nr + kr;
-              for (octave_idx_type j = 0; j < lc; j++)
-                for (octave_idx_type i = 0; i < lr; i++)
-                  blk[j*m+i] = ss[j*nr + i];
-              T *dd = dest + kr * nc + kc;
-              for (octave_idx_type j = 0; j < lr; j++)
-                for (octave_idx_type i = 0; i < lc; i++)
-                  dd[j*nc+i] = blk[i*m+j];
+              octave_idx_type l0 = std::min (m, n0 - k0);
+              const T *ss = src + k0 * s0 + kp;
+              T *dd = dest + kp * dp + k0;
+              if (lp == m && l0 == m)
+                {
+                  for (octave_idx_type j = 0; j < m; j++)
+                    for (octave_idx_type i = 0; i < m; i++)
+                      dd[j*dp + i] = ss[i*s0 + j];
+                }
+              else
+                {
+                  for (octave_idx_type j = 0; j < lp; j++)
+                    for (octave_idx_type i = 0; i < l0; i++)
+                      dd[j*dp + i] = ss[i*s0 + j];
+                }
             }
         }
+    };
 
-    return dest + nr*nc;
+    if (par)
+      octave::parallel_ranges (nblk, num_tasks (nblk), copy_blocks);
+    else
+      copy_blocks (0, nblk);
   }
 
-private:
-
   // Recursive N-D generalized transpose
   template <typename T>
-  T * do_permute (const T *src, T *dest, int lev) const
+  void do_permute (const T *src, T *dest, int lev) const
   {
     if (lev == 0)
       {
         octave_idx_type step = m_stride[0];
         octave_idx_type len = m_dim[0];
-        if (step == 1)
-          {
-            std::copy_n (src, len, dest);
-            dest += len;
-          }
+        if (m_tile > 0)
+          tile_copy (src, dest, len, step, m_dim[m_tile], m_dstride[m_tile]);
+        else if (step == 1)
+          std::copy_n (src, len, dest);
         else
           {
             for (octave_idx_type i = 0, j = 0; i < len; i++, j += step)
               dest[i] = src[j];
-
-            dest += len;
           }
       }
-    else if (m_use_blk && lev == 1)
-      dest = blk_trans (src, dest, m_dim[1], m_dim[0]);
+    else if (lev == m_tile)
+      do_permute (src, dest, lev-1);
     else
       {
         octave_idx_type step = m_stride[lev];
+        octave_idx_type dstep = m_dstride[lev];
         octave_idx_type len = m_dim[lev];
-        for (octave_idx_type i = 0, j = 0; i < len; i++, j+= step)
-          dest = do_permute (src + i * step, dest, lev-1);
+        for (octave_idx_type i = 0; i < len; i++)
+          do_permute (src + i * step, dest + i * dstep, lev-1);
       }
-
-    return dest;
   }
 
   //--------
 
-  // STRIDE occupies the last half of the space allocated for dim to
-  // avoid a double allocation.
+  // STRIDE and DSTRIDE occupy the last two thirds of the space
+  // allocated for dim to avoid multiple allocations.
 
   int m_n;
   int m_top;
+  int m_tile;
+  octave_idx_type m_numel;
   octave_idx_type *m_dim;
   octave_idx_type *m_stride;
-  bool m_use_blk;
+  octave_idx_type *m_dstride;
 };
 
 template <typename T, typename Alloc>
@@ -558,7 +659,55 @@ public:
   ~rec_index_helper () { delete [] m_idx; delete [] m_dim; }
 
   template <typename T>
-  void index (const T *src, T *dest) const { do_index (src, dest, m_top); }
+  void index (const T *src, T *dest) const
+  {
+    if (m_top == 0)
+      {
+        do_index (src, dest, m_top);
+        return;
+      }
+
+    // Each index of the outermost level selects a block of the result
+    // of the same size, so large gathers can be split across threads
+    // at that level, unless the first level would already be split.
+    // Mask indices cache their position in xelem, so they must not be
+    // used by several threads at the intermediate levels.
+
+    octave_idx_type nn = m_idx[m_top].length (m_dim[m_top]);
+
+    octave_idx_type blk = 1;
+    bool par = nn > 1;
+    for (int k = 0; k < m_top; k++)
+      {
+        blk *= m_idx[k].length (m_dim[k]);
+        if (k > 0 && m_idx[k].idx_class () == octave::idx_vector::class_mask)
+          par = false;
+      }
+
+    if (par && octave::idx_vector::parallel_copy_ok<T> (nn * blk)
+        && ! octave::idx_vector::parallel_copy_ok<T> (m_dim[0]))
+      {
+        // Look up the outer indices first.
+        std::vector<octave_idx_type> jj (nn);
+        for (octave_idx_type i = 0; i < nn; i++)
+          jj[i] = m_idx[m_top].xelem (i);
+
+        octave_idx_type d = m_cdim[m_top];
+
+        auto index_range = [&] (octave_idx_type i0, octave_idx_type i1)
+        {
+          for (octave_idx_type i = i0; i < i1; i++)
+            do_index (src + d*jj[i], dest + i*blk, m_top-1);
+        };
+
+        octave_idx_type ntasks
+          = std::min (nn, static_cast<octave_idx_type> (256));
+
+        octave::parallel_ranges (nn, ntasks, index_range);
+      }
+    else
+      do_index (src, dest, m_top);
+  }
 
   template <typename T>
   void assign (const T *src, T *dest) const { do_assign (src, dest, m_top); }
@@ -1776,6 +1925,24 @@ sort_isnan (typename ref_param<T>::type)
   return false;
 }
 
+// Call FCN (J0, J1) on ranges that together cover the ITER vectors of
+// length NS to be sorted.  Each call sorts its vectors with its own
+// octave_sort object, so large arrays of plain data are split across
+// threads.
+
+template <typename T, typename F>
+static void
+sort_vector_ranges (octave_idx_type iter, octave_idx_type ns, const F& fcn)
+{
+  octave_idx_type ntasks = 1;
+
+  if (std::is_trivially_copyable<T>::value)
+    ntasks = std::min (std::min (iter, iter * ns / 65536),
+                       static_cast<octave_idx_type> (1024));
+
+  octave::parallel_ranges (iter, ntasks, fcn);
+}
+
 template <typename T, typename Alloc>
 Array<T, Alloc>
 Array<T, Alloc>::sort (int dim, sortmode mode) const
@@ -1803,87 +1970,60 @@ Array<T, Alloc>::sort (int dim, sortmode mode) const
   T *v = m.fortran_vec ();
   const T *ov = data ();
 
-  octave_sort<T> lsort;
-
-  if (mode != UNSORTED)
-    lsort.set_compare (mode);
-  else
+  if (mode == UNSORTED)
     return m;
 
-  if (stride == 1)
-    {
-      // Special case along first dimension avoids gather/scatter AND directly
-      // sorts into destination buffer for an 11% performance boost.
-      for (octave_idx_type j = 0; j < iter; j++)
-        {
-          // Copy and partition out NaNs.
-          // No need to special case integer types <T> from floating point
-          // types <T> to avoid sort_isnan() test as it makes no discernible
-          // performance impact.
-          octave_idx_type kl = 0;
-          octave_idx_type ku = ns;
-          for (octave_idx_type i = 0; i < ns; i++)
-            {
-              T tmp = ov[i];
-              if (sort_isnan<T> (tmp))
-                v[--ku] = tmp;
-              else
-                v[kl++] = tmp;
-            }
-
-          // sort.
-          lsort.sort (v, kl);
-
-          if (ku < ns)
-            {
-              // NaNs are in reverse order
-              std::reverse (v + ku, v + ns);
-              if (mode == DESCENDING)
-                std::rotate (v, v + ku, v + ns);
-            }
-
-          v += ns;
-          ov += ns;
-        }
-    }
-  else
-    {
-      OCTAVE_LOCAL_BUFFER (T, buf, ns);
+  auto sort_range = [=] (octave_idx_type j0, octave_idx_type j1)
+  {
+    octave_sort<T> lsort;
+    lsort.set_compare (mode);
 
-      for (octave_idx_type j = 0; j < iter; j++)
-        {
-          octave_idx_type offset = j;
-          octave_idx_type n_strides = j / stride;
-          offset += n_strides * stride * (ns - 1);
+    OCTAVE_LOCAL_BUFFER (T, buf, stride == 1 ? 0 : ns);
 
-          // gather and partition out NaNs.
-          octave_idx_type kl = 0;
-          octave_idx_type ku = ns;
-          for (octave_idx_type i = 0; i < ns; i++)
-            {
-              T tmp = ov[i*stride + offset];
-              if (sort_isnan<T> (tmp))
-                buf[--ku] = tmp;
-              else
-                buf[kl++] = tmp;
-            }
+    for (octave_idx_type j = j0; j < j1; j++)
+      {
+        octave_idx_type offset = j;
+        octave_idx_type n_strides = j / stride;
+        offset += n_strides * stride * (ns - 1);
+
+        // Along the first dimension, avoid gather/scatter AND directly
+        // sort into the destination buffer for an 11% performance boost.
+        T *dst = (stride == 1 ? v + offset : buf);
+
+        // Copy or gather and partition out NaNs.
+        // No need to special case integer types <T> from floating point
+        // types <T> to avoid sort_isnan() test as it makes no discernible
+        // performance impact.
+        octave_idx_type kl = 0;
+        octave_idx_type ku = ns;
+        for (octave_idx_type i = 0; i < ns; i++)
+          {
+            T tmp = ov[i*stride + offset];
+            if (sort_isnan<T> (tmp))
+              dst[--ku] = tmp;
+            else
+              dst[kl++] = tmp;
+          }
 
-          // sort.
-          lsort.sort (buf, kl);
+        // sort.
+        lsort.sort (dst, kl);
 
-          if (ku < ns)
-            {
-              // NaNs are in reverse order
-              std::reverse (buf + ku, buf + ns);
-              if (mode == DESCENDING)
-                std::rotate (buf, buf + ku, buf + ns);
-            }
+        if (ku < ns)
+          {
+            // NaNs are in reverse order
+            std::reverse (dst + ku, dst + ns);
+            if (mode == DESCENDING)
+              std::rotate (dst, dst + ku, dst + ns);
+          }
 
-          // scatter.
+        // scatter.
+        if (stride != 1)
           for (octave_idx_type i = 0; i < ns; i++)
             v[i*stride + offset] = buf[i];
-        }
-    }
+      }
+  };
+
+  sort_vector_ranges<T> (iter, ns, sort_range);
 
   return m;
 }
@@ -1916,115 +2056,77 @@ Array<T, Alloc>::sort (Array<octave_idx_type>& sidx, int dim,
   T *v = m.fortran_vec ();
   const T *ov = data ();
 
-  octave_sort<T> lsort;
-
   sidx = Array<octave_idx_type> (dv);
   octave_idx_type *vi = sidx.fortran_vec ();
 
-  if (mode != UNSORTED)
-    lsort.set_compare (mode);
-  else
+  if (mode == UNSORTED)
     return m;
 
-  if (stride == 1)
-    {
-      // Special case for dim 1 avoids gather/scatter for performance boost.
-      // See comments in Array::sort (dim, mode).
-      for (octave_idx_type j = 0; j < iter; j++)
-        {
-          // copy and partition out NaNs.
-          octave_idx_type kl = 0;
-          octave_idx_type ku = ns;
-          for (octave_idx_type i = 0; i < ns; i++)
-            {
-              T tmp = ov[i];
-              if (sort_isnan<T> (tmp))
-                {
-                  --ku;
-                  v[ku] = tmp;
-                  vi[ku] = i;
-                }
-              else
-                {
-                  v[kl] = tmp;
-                  vi[kl] = i;
-                  kl++;
-                }
-            }
+  auto sort_range = [=] (octave_idx_type j0, octave_idx_type j1)
+  {
+    octave_sort<T> lsort;
+    lsort.set_compare (mode);
 
-          // sort.
-          lsort.sort (v, vi, kl);
+    OCTAVE_LOCAL_BUFFER (T, buf, stride == 1 ? 0 : ns);
+    OCTAVE_LOCAL_BUFFER (octave_idx_type, bufi, stride == 1 ? 0 : ns);
 
-          if (ku < ns)
-            {
-              // NaNs are in reverse order
-              std::reverse (v + ku, v + ns);
-              std::reverse (vi + ku, vi + ns);
-              if (mode == DESCENDING)
-                {
-                  std::rotate (v, v + ku, v + ns);
-                  std::rotate (vi, vi + ku, vi + ns);
-                }
-            }
-
-          v += ns;
-          vi += ns;
-          ov += ns;
-        }
-    }
-  else
-    {
-      OCTAVE_LOCAL_BUFFER (T, buf, ns);
-      OCTAVE_LOCAL_BUFFER (octave_idx_type, bufi, ns);
-
-      for (octave_idx_type j = 0; j < iter; j++)
-        {
-          octave_idx_type offset = j;
-          octave_idx_type n_strides = j / stride;
-          offset += n_strides * stride * (ns - 1);
+    for (octave_idx_type j = j0; j < j1; j++)
+      {
+        octave_idx_type offset = j;
+        octave_idx_type n_strides = j / stride;
+        offset += n_strides * stride * (ns - 1);
+
+        // See comments in Array::sort (dim, mode).
+        T *dst = (stride == 1 ? v + offset : buf);
+        octave_idx_type *dsti = (stride == 1 ? vi + offset : bufi);
+
+        // Copy or gather and partition out NaNs.
+        octave_idx_type kl = 0;
+        octave_idx_type ku = ns;
+        for (octave_idx_type i = 0; i < ns; i++)
+          {
+            T tmp = ov[i*stride + offset];
+            if (sort_isnan<T> (tmp))
+              {
+                --ku;
+                dst[ku] = tmp;
+                dsti[ku] = i;
+              }
+            else
+              {
+                dst[kl] = tmp;
+                dsti[kl] = i;
+                kl++;
+              }
+          }
 
-          // gather and partition out NaNs.
-          octave_idx_type kl = 0;
-          octave_idx_type ku = ns;
-          for (octave_idx_type i = 0; i < ns; i++)
-            {
-              T tmp = ov[i*stride + offset];
-              if (sort_isnan<T> (tmp))
-                {
-                  --ku;
-                  buf[ku] = tmp;
-                  bufi[ku] = i;
-                }
-              else
-                {
-                  buf[kl] = tmp;
-                  bufi[kl] = i;
-                  kl++;
-                }
-            }
+        // sort.
+        lsort.sort (dst, dsti, kl);
 
-          // sort.
-          lsort.sort (buf, bufi, kl);
+        if (ku < ns)
+          {
+            // NaNs are in reverse order
+            std::reverse (dst + ku, dst + ns);
+            std::reverse (dsti + ku, dsti + ns);
+            if (mode == DESCENDING)
+              {
+                std::rotate (dst, dst + ku, dst + ns);
+                std::rotate (dsti, dsti + ku, dsti + ns);
+              }
+          }
 
-          if (ku < ns)
-            {
-              // NaNs are in reverse order
-              std::reverse (buf + ku, buf + ns);
-              std::reverse (bufi + ku, bufi + ns);
-              if (mode == DESCENDING)
-                {
-                  std::rotate (buf, buf + ku, buf + ns);
-                  std::rotate (bufi, bufi + ku, bufi + ns);
-                }
-            }
+        // scatter.
+        if (stride != 1)
+          {
+            for (octave_idx_type i = 0; i < ns; i++)
+              v[i*stride + offset] = buf[i];
+            for (octave_idx_type i = 0; i < ns; i++)
+              vi[i*stride + offset] = bufi[i];
+          }
+      }
+  };
 
-          // scatter.
-          for (octave_idx_type i = 0; i < ns; i++)
-            v[i*stride + offset] = buf[i];
-          for (octave_idx_type i = 0; i < ns; i++)
-            vi[i*stride + offset] = bufi[i];
-        }
-    }
+  sort_vector_ranges<T> (iter, ns, sort_range);
 
   return m;
 }
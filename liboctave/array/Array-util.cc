@@ -27,6 +27,8 @@
 #  include "config.h"
 #endif
 
+#include <exception>
+
 #include "Array-util.h"
 #include "lo-error.h"
 #include "oct-locbuf.h"
@@ -648,3 +650,46 @@ permute_vector_compare (const void *a, const void *b)
 
   return pva->pidx > pvb->pidx;
 }
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+void
+parallel_ranges (octave_idx_type n, octave_idx_type ntasks,
+                 const std::function<void (octave_idx_type,
+                                           octave_idx_type)>& fcn)
+{
+#if ! defined (OCTAVE_ENABLE_OPENMP)
+  ntasks = 1;
+#endif
+
+  if (ntasks <= 1)
+    {
+      fcn (0, n);
+      return;
+    }
+
+  std::exception_ptr err;
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp parallel for schedule (dynamic)
+#endif
+  for (octave_idx_type t = 0; t < ntasks; t++)
+    {
+      try
+        {
+          fcn ((n * t) / ntasks, (n * (t + 1)) / ntasks);
+        }
+      catch (...)
+        {
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp critical (parallel_ranges)
+#endif
+          err = std::current_exception ();
+        }
+    }
+
+  if (err)
+    std::rethrow_exception (err);
+}
+
+OCTAVE_END_NAMESPACE(octave)
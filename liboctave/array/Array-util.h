@@ -28,6 +28,8 @@
 
 #include "octave-config.h"
 
+#include <functional>
+
 #include "Array.h"
 #include "lo-array-errwarn.h"
 
@@ -118,4 +120,18 @@ permute_vector
 
 extern int OCTAVE_API permute_vector_compare (const void *a, const void *b);
 
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Split [0, N) into NTASKS consecutive ranges and call FCN (I0, I1) on
+// each of them, in parallel when Octave is built with OpenMP.  Without
+// OpenMP, FCN is called once for the whole range.  An exception thrown
+// by any range is rethrown once all are done.
+
+extern OCTAVE_API void
+parallel_ranges (octave_idx_type n, octave_idx_type ntasks,
+                 const std::function<void (octave_idx_type,
+                                           octave_idx_type)>& fcn);
+
+OCTAVE_END_NAMESPACE(octave)
+
 #endif
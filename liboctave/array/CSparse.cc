@@ -53,6 +53,7 @@
 #include "oct-spparms.h"
 #include "sparse-lu.h"
 #include "oct-sparse.h"
+#include "sparse-mul-tasks.h"
 #include "sparse-util.h"
 #include "sparse-chol.h"
 #include "sparse-qr.h"
@@ -5544,7 +5545,8 @@ void *
 SparseComplexMatrix::factorize (octave_idx_type& err, double& rcond,
                                 Matrix& Control, Matrix& Info,
                                 solve_singularity_handler sing_handler,
-                                bool calc_cond) const
+                                bool calc_cond,
+                                octave::math::sparse_lu_symbolic *symbolic) const
 {
   // The return values
   void *Numeric = nullptr;
@@ -5586,14 +5588,26 @@ SparseComplexMatrix::factorize (octave_idx_type& err, double& rcond,
                                  reinterpret_cast<const double *> (Ax),
                                  nullptr, 1, control);
 
-  void *Symbolic;
   Info = Matrix (1, UMFPACK_INFO);
   double *info = Info.fortran_vec ();
-  int status = UMFPACK_ZNAME (qsymbolic) (nr, nc,
-                                          octave::to_suitesparse_intptr (Ap),
-                                          octave::to_suitesparse_intptr (Ai),
-                                          reinterpret_cast<const double *> (Ax),
-                                          nullptr, nullptr, &Symbolic, control, info);
+
+  // Reuse the symbolic analysis of a previously factorized matrix with
+  // the same sparsity pattern if one was given.
+
+  if (symbolic && ! symbolic->is_complex ())
+    (*current_liboctave_error_handler)
+      ("SparseComplexMatrix::solve: symbolic analysis is for a real matrix");
+
+  void *Symbolic = (symbolic ? symbolic->take (nr, nc, Ap, Ai, control)
+                    : nullptr);
+  int status = 0;
+
+  if (! Symbolic)
+    status = UMFPACK_ZNAME (qsymbolic) (nr, nc,
+                                        octave::to_suitesparse_intptr (Ap),
+                                        octave::to_suitesparse_intptr (Ai),
+                                        reinterpret_cast<const double *> (Ax),
+                                        nullptr, nullptr, &Symbolic, control, info);
 
   if (status < 0)
     {
@@ -5615,7 +5629,11 @@ SparseComplexMatrix::factorize (octave_idx_type& err, double& rcond,
                                         octave::to_suitesparse_intptr (Ai),
                                         reinterpret_cast<const double *> (Ax),
                                         nullptr, Symbolic, &Numeric, control, info);
-      UMFPACK_ZNAME (free_symbolic) (&Symbolic);
+
+      if (symbolic)
+        symbolic->put (nr, nc, Ap, Ai, control, Symbolic);
+      else
+        UMFPACK_ZNAME (free_symbolic) (&Symbolic);
 
       if (calc_cond)
         rcond = Info (UMFPACK_RCOND);
@@ -5820,7 +5838,8 @@ SparseComplexMatrix::fsolve (MatrixType& mattype, const Matrix& b,
 #if defined (HAVE_UMFPACK)
           Matrix Control, Info;
           void *Numeric = factorize (err, rcond, Control, Info,
-                                     sing_handler, calc_cond);
+                                     sing_handler, calc_cond,
+                                     mattype.sparse_symbolic ().get ());
 
           if (err == 0)
             {
@@ -6077,7 +6096,8 @@ SparseComplexMatrix::fsolve (MatrixType& mattype, const SparseMatrix& b,
 #if defined (HAVE_UMFPACK)
           Matrix Control, Info;
           void *Numeric = factorize (err, rcond, Control, Info,
-                                     sing_handler, calc_cond);
+                                     sing_handler, calc_cond,
+                                     mattype.sparse_symbolic ().get ());
 
           if (err == 0)
             {
@@ -6351,7 +6371,8 @@ SparseComplexMatrix::fsolve (MatrixType& mattype, const ComplexMatrix& b,
 #if defined (HAVE_UMFPACK)
           Matrix Control, Info;
           void *Numeric = factorize (err, rcond, Control, Info,
-                                     sing_handler, calc_cond);
+                                     sing_handler, calc_cond,
+                                     mattype.sparse_symbolic ().get ());
 
           if (err == 0)
             {
@@ -6587,7 +6608,8 @@ SparseComplexMatrix::fsolve (MatrixType& mattype, const SparseComplexMatrix& b,
 #if defined (HAVE_UMFPACK)
           Matrix Control, Info;
           void *Numeric = factorize (err, rcond, Control, Info,
-                                     sing_handler, calc_cond);
+                                     sing_handler, calc_cond,
+                                     mattype.sparse_symbolic ().get ());
 
           if (err == 0)
             {
@@ -280,7 +280,8 @@ private:
   // Full matrix solvers (umfpack/cholesky)
   void * factorize (octave_idx_type& err, double& rcond, Matrix& Control,
                     Matrix& Info, solve_singularity_handler sing_handler,
-                    bool calc_cond) const;
+                    bool calc_cond,
+                    octave::math::sparse_lu_symbolic *symbolic = nullptr) const;
 
   ComplexMatrix fsolve (MatrixType& mattype, const Matrix& b,
                         octave_idx_type& info, double& rcond,
@@ -27,6 +27,11 @@
 // C++ source files that should have included config.h before including
 // this file.
 
+#include <algorithm>
+#include <complex>
+#include <type_traits>
+#include <vector>
+
 #include "MArray.h"
 #include "Array-util.h"
 #include "lo-error.h"
@@ -59,6 +64,105 @@ private:
   const T *m_vals;
 };
 
+// Apply COMBINE (DST[IDX(I)], VAL (I)) for I from 0 to LEN-1 in
+// parallel and return true, or return false if the problem is too small
+// or IDX is not an index vector.
+//
+// Usually the elements are distributed, in their original order, to
+// ranges of DST which are processed by separate threads.  Each element
+// of DST thus receives its values in the same order as in a serial loop.
+//
+// If DST has so few elements that most ranges would be empty and
+// REORDER is true, the index vector is instead split into a fixed
+// number of chunks, each reduced into a private copy of DST, and the
+// copies are combined into DST in chunk order.  The values of an
+// element may then be combined in a different order than in a serial
+// loop, so REORDER must only be true if COMBINE is associative or may
+// round differently.
+//
+// In both cases the result does not depend on the number of threads.
+
+template <typename T, typename Val, typename Combine>
+static bool
+idx_scatter_parallel (const octave::idx_vector& idx, octave_idx_type len,
+                      T *dst, octave_idx_type n, Val val, Combine combine,
+                      bool reorder)
+{
+  if (! std::is_trivially_copyable<T>::value
+      || idx.idx_class () != octave::idx_vector::class_vector)
+    return false;
+
+  octave::idx_vector tmp (idx);
+  const octave_idx_type *data = tmp.raw ();
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+  static const octave_idx_type nchunks = 64;
+
+  if (reorder && len >= 262144 && n < 1024)
+    {
+      std::vector<T> bins (nchunks * n);
+      std::vector<char> seen (nchunks * n, 0);
+
+      octave::parallel_ranges
+        (nchunks, nchunks,
+         [=, &bins, &seen] (octave_idx_type c0, octave_idx_type c1)
+         {
+           for (octave_idx_type c = c0; c < c1; c++)
+             {
+               T *bin = bins.data () + c * n;
+               char *used = seen.data () + c * n;
+
+               for (octave_idx_type i = (len * c) / nchunks;
+                    i < (len * (c + 1)) / nchunks; i++)
+                 {
+                   octave_idx_type k = data[i];
+
+                   if (used[k])
+                     combine (bin[k], val (i));
+                   else
+                     {
+                       bin[k] = val (i);
+                       used[k] = 1;
+                     }
+                 }
+             }
+         });
+
+      for (octave_idx_type c = 0; c < nchunks; c++)
+        for (octave_idx_type k = 0; k < n; k++)
+          if (seen[c * n + k])
+            combine (dst[k], bins[c * n + k]);
+
+      return true;
+    }
+#else
+  octave_unused_parameter (reorder);
+#endif
+
+  return octave::idx_vector::scatter_parts
+           (data, len, n,
+            [=] (const octave_idx_type *order, octave_idx_type m)
+            {
+              for (octave_idx_type j = 0; j < m; j++)
+                {
+                  octave_idx_type i = order[j];
+                  combine (dst[data[i]], val (i));
+                }
+            });
+}
+
+// Sums of floating point values may be reordered.  Integer sums may
+// not, because they saturate.
+
+template <typename T>
+static bool
+idx_add_reorder ()
+{
+  return (std::is_floating_point<T>::value
+          || std::is_same<T, std::complex<double>>::value
+          || std::is_same<T, std::complex<float>>::value);
+}
+
 template <typename T>
 void
 MArray<T>::idx_add (const octave::idx_vector& idx, T val)
@@ -74,7 +178,13 @@ MArray<T>::idx_add (const octave::idx_vector& idx, T val)
   octave_quit ();
 
   octave_idx_type len = idx.length (n);
-  idx.loop (len, _idxadds_helper<T> (this->fortran_vec (), val));
+  T *dst = this->fortran_vec ();
+
+  if (! idx_scatter_parallel (idx, len, dst, n,
+                              [val] (octave_idx_type) { return val; },
+                              [] (T& d, const T& v) { d += v; },
+                              idx_add_reorder<T> ()))
+    idx.loop (len, _idxadds_helper<T> (dst, val));
 }
 
 template <typename T>
@@ -92,7 +202,14 @@ MArray<T>::idx_add (const octave::idx_vector& idx, const MArray<T>& vals)
   octave_quit ();
 
   octave_idx_type len = std::min (idx.length (n), vals.numel ());
-  idx.loop (len, _idxadda_helper<T> (this->fortran_vec (), vals.data ()));
+  T *dst = this->fortran_vec ();
+  const T *src = vals.data ();
+
+  if (! idx_scatter_parallel (idx, len, dst, n,
+                              [src] (octave_idx_type i) { return src[i]; },
+                              [] (T& d, const T& v) { d += v; },
+                              idx_add_reorder<T> ()))
+    idx.loop (len, _idxadda_helper<T> (dst, src));
 }
 
 template <typename T, T op (typename ref_param<T>::type,
@@ -125,8 +242,15 @@ MArray<T>::idx_min (const octave::idx_vector& idx, const MArray<T>& vals)
   octave_quit ();
 
   octave_idx_type len = std::min (idx.length (n), vals.numel ());
-  idx.loop (len, _idxbinop_helper<T, octave::math::min> (this->fortran_vec (),
-                                                         vals.data ()));
+  T *dst = this->fortran_vec ();
+  const T *src = vals.data ();
+
+  if (! idx_scatter_parallel (idx, len, dst, n,
+                              [src] (octave_idx_type i) { return src[i]; },
+                              [] (T& d, const T& v)
+                              { d = octave::math::min (d, v); },
+                              true))
+    idx.loop (len, _idxbinop_helper<T, octave::math::min> (dst, src));
 }
 
 template <typename T>
@@ -144,8 +268,15 @@ MArray<T>::idx_max (const octave::idx_vector& idx, const MArray<T>& vals)
   octave_quit ();
 
   octave_idx_type len = std::min (idx.length (n), vals.numel ());
-  idx.loop (len, _idxbinop_helper<T, octave::math::max> (this->fortran_vec (),
-                                                         vals.data ()));
+  T *dst = this->fortran_vec ();
+  const T *src = vals.data ();
+
+  if (! idx_scatter_parallel (idx, len, dst, n,
+                              [src] (octave_idx_type i) { return src[i]; },
+                              [] (T& d, const T& v)
+                              { d = octave::math::max (d, v); },
+                              true))
+    idx.loop (len, _idxbinop_helper<T, octave::math::max> (dst, src));
 }
 
 template <typename T>
@@ -183,7 +314,73 @@ void MArray<T>::idx_add_nd (const octave::idx_vector& idx,
   const T *src = vals.data ();
   octave_idx_type len = idx.length (ns);
 
-  if (l == 1)
+  // Independent pages, or independent rows within the only page, are
+  // split across threads for large problems.  Each element receives
+  // its values in the same order either way.
+  octave_idx_type nrows = 1;
+  bool par_pages = false;
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+  if (std::is_trivially_copyable<T>::value
+      && idx.idx_class () != octave::idx_vector::class_colon
+      && static_cast<double> (len) * l * u >= 262144)
+    {
+      if (u > 1)
+        par_pages = true;
+      else
+        nrows = std::min (l / 64, static_cast<octave_idx_type> (64));
+    }
+#endif
+
+  // The threads read the indices from a plain array, because other
+  // kinds of index vectors, such as masks, cache their position in
+  // members that can't be shared between threads.
+  octave::idx_vector vidx;
+  Array<octave_idx_type> idx_copy;
+  const octave_idx_type *ip = nullptr;
+
+  if (par_pages || nrows > 1)
+    {
+      if (idx.idx_class () == octave::idx_vector::class_vector)
+        {
+          vidx = idx;
+          ip = vidx.raw ();
+        }
+      else
+        {
+          idx_copy.clear (dim_vector (len, 1));
+          idx.copy_data (idx_copy.fortran_vec ());
+          ip = idx_copy.data ();
+        }
+    }
+
+  if (par_pages)
+    {
+      octave::parallel_ranges
+        (u, u, [=] (octave_idx_type j0, octave_idx_type j1)
+         {
+           for (octave_idx_type j = j0; j < j1; j++)
+             {
+               if (l == 1)
+                 for (octave_idx_type i = 0; i < len; i++)
+                   dst[j*n + ip[i]] += src[j*ns + i];
+               else
+                 for (octave_idx_type i = 0; i < len; i++)
+                   mx_inline_add2 (l, dst + l*(j*n + ip[i]),
+                                   src + l*(j*ns + i));
+             }
+         });
+    }
+  else if (nrows > 1)
+    {
+      octave::parallel_ranges
+        (l, nrows, [=] (octave_idx_type r0, octave_idx_type r1)
+         {
+           for (octave_idx_type i = 0; i < len; i++)
+             mx_inline_add2 (r1 - r0, dst + l*ip[i] + r0, src + l*i + r0);
+         });
+    }
+  else if (l == 1)
     {
       for (octave_idx_type j = 0; j < u; j++)
         {
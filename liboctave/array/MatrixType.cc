@@ -39,6 +39,7 @@
 #include "CSparse.h"
 #include "oct-spparms.h"
 #include "oct-locbuf.h"
+#include "oct-time.h"
 
 static void
 warn_cached ()
@@ -61,19 +62,53 @@ warn_calculating_sparse_type ()
     ("Octave:matrix-type-info", "calculating sparse matrix type");
 }
 
+MatrixType::solve_statistics&
+MatrixType::solve_stats ()
+{
+  static solve_statistics stats;
+
+  return stats;
+}
+
+// The solve statistics are only collected when factorizations are cached,
+// so that probing a full matrix doesn't read the clock otherwise.
+
+static double
+probe_start_time (bool collect)
+{
+  return collect ? octave::sys::time ().double_value () : 0.0;
+}
+
+static void
+count_probe (bool collect, double start)
+{
+  if (! collect)
+    return;
+
+  MatrixType::solve_statistics& stats = MatrixType::solve_stats ();
+
+  stats.probes++;
+  stats.probe_time += octave::sys::time ().double_value () - start;
+}
+
 // FIXME: There is a large code duplication here
 
 MatrixType::MatrixType ()
   : m_type (MatrixType::Unknown),
     m_sp_bandden (octave::sparse_params::get_bandden ()),
     m_bandden (0), m_upper_band (0), m_lower_band (0),
-    m_dense (false), m_full (false), m_nperm (0), m_perm (nullptr) { }
+    m_dense (false), m_full (false), m_nperm (0), m_perm (nullptr),
+    m_cache_factorization (false), m_factorization (),
+    m_sparse_symbolic () { }
 
 MatrixType::MatrixType (const MatrixType& a)
   : m_type (a.m_type), m_sp_bandden (a.m_sp_bandden), m_bandden (a.m_bandden),
     m_upper_band (a.m_upper_band), m_lower_band (a.m_lower_band),
     m_dense (a.m_dense), m_full (a.m_full),
-    m_nperm (a.m_nperm), m_perm (nullptr)
+    m_nperm (a.m_nperm), m_perm (nullptr),
+    m_cache_factorization (a.m_cache_factorization),
+    m_factorization (a.m_factorization),
+    m_sparse_symbolic (a.m_sparse_symbolic)
 {
   if (m_nperm != 0)
     {
@@ -203,7 +238,9 @@ matrix_complex_probe (const MArray<std::complex<T>>& a)
 MatrixType::MatrixType (const Matrix& a)
   : m_type (MatrixType::Unknown),
     m_sp_bandden (0), m_bandden (0), m_upper_band (0), m_lower_band (0),
-    m_dense (false), m_full (true), m_nperm (0), m_perm (nullptr)
+    m_dense (false), m_full (true), m_nperm (0), m_perm (nullptr),
+    m_cache_factorization (false), m_factorization (),
+    m_sparse_symbolic ()
 {
   m_type = matrix_real_probe (a);
 }
@@ -211,7 +248,9 @@ MatrixType::MatrixType (const Matrix& a)
 MatrixType::MatrixType (const ComplexMatrix& a)
   : m_type (MatrixType::Unknown),
     m_sp_bandden (0), m_bandden (0), m_upper_band (0), m_lower_band (0),
-    m_dense (false), m_full (true), m_nperm (0), m_perm (nullptr)
+    m_dense (false), m_full (true), m_nperm (0), m_perm (nullptr),
+    m_cache_factorization (false), m_factorization (),
+    m_sparse_symbolic ()
 {
   m_type = matrix_complex_probe (a);
 }
@@ -219,7 +258,9 @@ MatrixType::MatrixType (const ComplexMatrix& a)
 MatrixType::MatrixType (const FloatMatrix& a)
   : m_type (MatrixType::Unknown),
     m_sp_bandden (0), m_bandden (0), m_upper_band (0), m_lower_band (0),
-    m_dense (false), m_full (true), m_nperm (0), m_perm (nullptr)
+    m_dense (false), m_full (true), m_nperm (0), m_perm (nullptr),
+    m_cache_factorization (false), m_factorization (),
+    m_sparse_symbolic ()
 {
   m_type = matrix_real_probe (a);
 }
@@ -227,7 +268,9 @@ MatrixType::MatrixType (const FloatMatrix& a)
 MatrixType::MatrixType (const FloatComplexMatrix& a)
   : m_type (MatrixType::Unknown),
     m_sp_bandden (0), m_bandden (0), m_upper_band (0), m_lower_band (0),
-    m_dense (false), m_full (true), m_nperm (0), m_perm (nullptr)
+    m_dense (false), m_full (true), m_nperm (0), m_perm (nullptr),
+    m_cache_factorization (false), m_factorization (),
+    m_sparse_symbolic ()
 {
   m_type = matrix_complex_probe (a);
 }
@@ -237,7 +280,9 @@ template <typename T>
 MatrixType::MatrixType (const MSparse<T>& a)
   : m_type (MatrixType::Unknown),
     m_sp_bandden (0), m_bandden (0), m_upper_band (0), m_lower_band (0),
-    m_dense (false), m_full (false), m_nperm (0), m_perm (nullptr)
+    m_dense (false), m_full (false), m_nperm (0), m_perm (nullptr),
+    m_cache_factorization (false), m_factorization (),
+    m_sparse_symbolic ()
 {
   octave_idx_type nrows = a.rows ();
   octave_idx_type ncols = a.cols ();
@@ -564,7 +609,9 @@ MatrixType::MatrixType (const matrix_type t, bool _full)
   : m_type (MatrixType::Unknown),
     m_sp_bandden (octave::sparse_params::get_bandden ()),
     m_bandden (0), m_upper_band (0), m_lower_band (0),
-    m_dense (false), m_full (_full), m_nperm (0), m_perm (nullptr)
+    m_dense (false), m_full (_full), m_nperm (0), m_perm (nullptr),
+    m_cache_factorization (false), m_factorization (),
+    m_sparse_symbolic ()
 {
   if (t == MatrixType::Unknown || t == MatrixType::Full
       || t == MatrixType::Diagonal || t == MatrixType::Permuted_Diagonal
@@ -581,7 +628,9 @@ MatrixType::MatrixType (const matrix_type t, const octave_idx_type np,
   : m_type (MatrixType::Unknown),
     m_sp_bandden (octave::sparse_params::get_bandden ()),
     m_bandden (0), m_upper_band (0), m_lower_band (0),
-    m_dense (false), m_full (_full), m_nperm (0), m_perm (nullptr)
+    m_dense (false), m_full (_full), m_nperm (0), m_perm (nullptr),
+    m_cache_factorization (false), m_factorization (),
+    m_sparse_symbolic ()
 {
   if ((t == MatrixType::Permuted_Upper || t == MatrixType::Permuted_Lower)
       && np > 0 && p != nullptr)
@@ -601,7 +650,9 @@ MatrixType::MatrixType (const matrix_type t, const octave_idx_type ku,
   : m_type (MatrixType::Unknown),
     m_sp_bandden (octave::sparse_params::get_bandden ()),
     m_bandden (0), m_upper_band (0), m_lower_band (0),
-    m_dense (false), m_full (_full), m_nperm (0), m_perm (nullptr)
+    m_dense (false), m_full (_full), m_nperm (0), m_perm (nullptr),
+    m_cache_factorization (false), m_factorization (),
+    m_sparse_symbolic ()
 {
   if (t == MatrixType::Banded || t == MatrixType::Banded_Hermitian)
     {
@@ -647,6 +698,10 @@ MatrixType::operator = (const MatrixType& a)
         }
 
       m_nperm = a.m_nperm;
+
+      m_cache_factorization = a.m_cache_factorization;
+      m_factorization = a.m_factorization;
+      m_sparse_symbolic = a.m_sparse_symbolic;
     }
 
   return *this;
@@ -749,7 +804,12 @@ MatrixType::type (const Matrix& a)
       return m_type;
     }
 
+  double start = probe_start_time (m_cache_factorization);
+
   MatrixType tmp_typ (a);
+
+  count_probe (m_cache_factorization, start);
+
   m_type = tmp_typ.m_type;
   m_full = tmp_typ.m_full;
   m_nperm = tmp_typ.m_nperm;
@@ -775,7 +835,12 @@ MatrixType::type (const ComplexMatrix& a)
       return m_type;
     }
 
+  double start = probe_start_time (m_cache_factorization);
+
   MatrixType tmp_typ (a);
+
+  count_probe (m_cache_factorization, start);
+
   m_type = tmp_typ.m_type;
   m_full = tmp_typ.m_full;
   m_nperm = tmp_typ.m_nperm;
@@ -801,7 +866,12 @@ MatrixType::type (const FloatMatrix& a)
       return m_type;
     }
 
+  double start = probe_start_time (m_cache_factorization);
+
   MatrixType tmp_typ (a);
+
+  count_probe (m_cache_factorization, start);
+
   m_type = tmp_typ.m_type;
   m_full = tmp_typ.m_full;
   m_nperm = tmp_typ.m_nperm;
@@ -827,7 +897,12 @@ MatrixType::type (const FloatComplexMatrix& a)
       return m_type;
     }
 
+  double start = probe_start_time (m_cache_factorization);
+
   MatrixType tmp_typ (a);
+
+  count_probe (m_cache_factorization, start);
+
   m_type = tmp_typ.m_type;
   m_full = tmp_typ.m_full;
   m_nperm = tmp_typ.m_nperm;
@@ -973,6 +1048,7 @@ MatrixType
 MatrixType::transpose () const
 {
   MatrixType retval (*this);
+  retval.m_factorization.reset ();
   if (m_type == MatrixType::Upper)
     retval.m_type = MatrixType::Lower;
   else if (m_type == MatrixType::Permuted_Upper)
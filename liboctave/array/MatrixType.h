@@ -28,10 +28,22 @@
 
 #include "octave-config.h"
 
+#include <memory>
+
 #include "mx-fwd.h"
 
 #include "MSparse.h"
 
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+OCTAVE_BEGIN_NAMESPACE(math)
+
+class OCTAVE_API sparse_lu_symbolic;
+
+OCTAVE_END_NAMESPACE(math)
+
+OCTAVE_END_NAMESPACE(octave)
+
 class
 MatrixType
 {
@@ -54,6 +66,38 @@ public:
     Rectangular
   };
 
+  // Base class for a factorization of a full matrix that is kept with
+  // its type so that later solves with the same matrix can reuse it.
+  // Derived classes are defined by the matrix classes that create them.
+
+  class factorization
+  {
+  public:
+
+    factorization () = default;
+
+    virtual ~factorization () = default;
+  };
+
+  // Counters describing the work done to solve linear systems with full
+  // matrices whose factorizations are cached.  Times are in seconds.
+
+  struct solve_statistics
+  {
+    solve_statistics ()
+      : probes (0), probe_time (0), factorizations (0), factor_time (0),
+        factorization_hits (0)
+    { }
+
+    octave_idx_type probes;
+    double probe_time;
+    octave_idx_type factorizations;
+    double factor_time;
+    octave_idx_type factorization_hits;
+  };
+
+  static OCTAVE_API solve_statistics& solve_stats ();
+
   OCTAVE_API MatrixType ();
 
   OCTAVE_API MatrixType (const MatrixType& a);
@@ -168,6 +212,37 @@ public:
 
   OCTAVE_API MatrixType transpose () const;
 
+  bool cache_factorization () const { return m_cache_factorization; }
+
+  // If FLAG is true, solvers for full matrices store the factorization
+  // they compute here and reuse it when called again with the same,
+  // unmodified matrix.
+
+  void cache_factorization (bool flag)
+  {
+    m_cache_factorization = flag;
+
+    if (! flag)
+      m_factorization.reset ();
+  }
+
+  std::shared_ptr<factorization> cached_factorization () const
+  { return m_factorization; }
+
+  void cached_factorization (const std::shared_ptr<factorization>& fact)
+  { m_factorization = fact; }
+
+  // If set, the UMFPACK solvers for sparse matrices reuse the symbolic
+  // analysis stored in this object for matrices with the same pattern,
+  // and store their analysis in it otherwise.
+
+  std::shared_ptr<octave::math::sparse_lu_symbolic> sparse_symbolic () const
+  { return m_sparse_symbolic; }
+
+  void
+  sparse_symbolic (const std::shared_ptr<octave::math::sparse_lu_symbolic>& sym)
+  { m_sparse_symbolic = sym; }
+
 private:
   void type (int new_typ) { m_type = static_cast<matrix_type> (new_typ); }
 
@@ -180,6 +255,9 @@ private:
   bool m_full;
   octave_idx_type m_nperm;
   octave_idx_type *m_perm;
+  bool m_cache_factorization;
+  std::shared_ptr<factorization> m_factorization;
+  std::shared_ptr<octave::math::sparse_lu_symbolic> m_sparse_symbolic;
 };
 
 #endif
@@ -30,6 +30,7 @@
 #include <algorithm>
 #include <istream>
 #include <limits>
+#include <memory>
 #include <ostream>
 
 #include "Array-util.h"
@@ -59,6 +60,7 @@
 #include "oct-fftw.h"
 #include "oct-locbuf.h"
 #include "oct-norm.h"
+#include "oct-time.h"
 #include "quit.h"
 #include "schur.h"
 #include "svd.h"
@@ -1389,10 +1391,95 @@ Matrix::ltsolve (MatrixType& mattype, const Matrix& b, octave_idx_type& info,
   return retval;
 }
 
+// LU or Cholesky factorization of a full matrix, kept in the MatrixType
+// of the matrix when factorizations are cached.  It holds a reference
+// to the data of the factored matrix, so any later change to that matrix
+// makes a copy of the data and the factorization no longer matches.
+
+class full_factorization : public MatrixType::factorization
+{
+public:
+
+  full_factorization (const Matrix& a, int typ, const Matrix& fact,
+                      const Array<F77_INT>& ipvt)
+    : m_a (a), m_typ (typ), m_fact (fact), m_ipvt (ipvt)
+  {
+    m_rcon[0] = m_rcon[1] = -1.0;
+  }
+
+  bool matches (const Matrix& a, int typ) const
+  {
+    return (typ == m_typ && a.data () == m_a.data ()
+            && a.rows () == m_a.rows () && a.cols () == m_a.cols ());
+  }
+
+  const Matrix& factors () const { return m_fact; }
+
+  const Array<F77_INT>& pivots () const { return m_ipvt; }
+
+  // Reciprocal condition number for solves with the matrix or with its
+  // transpose, or a negative value if it is not known yet.
+
+  double rcond (bool trans) const { return m_rcon[trans]; }
+
+  void rcond (bool trans, double rcon) { m_rcon[trans] = rcon; }
+
+private:
+
+  Matrix m_a;
+  int m_typ;
+  Matrix m_fact;
+  Array<F77_INT> m_ipvt;
+  double m_rcon[2];
+};
+
+// Return the factorization of A of type TYP cached in MATTYPE, if any.
+
+static std::shared_ptr<full_factorization>
+find_factorization (const MatrixType& mattype, const Matrix& a, int typ)
+{
+  std::shared_ptr<full_factorization> fact;
+
+  if (mattype.cache_factorization ())
+    {
+      fact = std::dynamic_pointer_cast<full_factorization>
+               (mattype.cached_factorization ());
+
+      if (fact && fact->matches (a, typ))
+        MatrixType::solve_stats ().factorization_hits++;
+      else
+        fact.reset ();
+    }
+
+  return fact;
+}
+
+// The statistics are only collected when factorizations are cached, so
+// that other solves don't read the clock.
+
+static double
+factor_start_time (const MatrixType& mattype)
+{
+  return (mattype.cache_factorization ()
+          ? octave::sys::time ().double_value () : 0.0);
+}
+
+static void
+count_factorization (const MatrixType& mattype, double start)
+{
+  if (! mattype.cache_factorization ())
+    return;
+
+  MatrixType::solve_statistics& stats = MatrixType::solve_stats ();
+
+  stats.factorizations++;
+  stats.factor_time += octave::sys::time ().double_value () - start;
+}
+
 Matrix
 Matrix::fsolve (MatrixType& mattype, const Matrix& b, octave_idx_type& info,
                 double& rcon, solve_singularity_handler sing_handler,
-                bool calc_cond) const
+                bool calc_cond, blas_trans_type transt) const
 {
   Matrix retval;
 
@@ -1409,6 +1496,10 @@ Matrix::fsolve (MatrixType& mattype, const Matrix& b, octave_idx_type& info,
     {
       volatile int typ = mattype.type ();
 
+      // Solve with the transpose of the matrix, using its factors.  For
+      // LU, the 1-norm of the transpose is the infinity norm.
+      bool trans = (transt == blas_trans || transt == blas_conj_trans);
+
       // Calculate the norm of the matrix for later use when determining rcon.
       double anorm = -1.0;
 
@@ -1417,20 +1508,33 @@ Matrix::fsolve (MatrixType& mattype, const Matrix& b, octave_idx_type& info,
           info = 0;
           char job = 'L';
 
-          Matrix atmp = *this;
-          double *tmp_data = atmp.fortran_vec ();
-
-          // The norm of the matrix for later use when determining rcon.
-          if (calc_cond)
-            anorm = norm1 (atmp);
+          std::shared_ptr<full_factorization> fact
+            = find_factorization (mattype, *this, typ);
 
+          Matrix atmp;
           F77_INT tmp_info = 0;
 
-          F77_XFCN (dpotrf, DPOTRF, (F77_CONST_CHAR_ARG2 (&job, 1), nr,
-                                     tmp_data, nr, tmp_info
-                                     F77_CHAR_ARG_LEN (1)));
+          if (fact)
+            atmp = fact->factors ();
+          else
+            {
+              atmp = *this;
+              double *tmp_data = atmp.fortran_vec ();
 
-          info = tmp_info;
+              // The norm of the matrix for later use when determining rcon.
+              if (calc_cond)
+                anorm = norm1 (atmp);
+
+              double start = factor_start_time (mattype);
+
+              F77_XFCN (dpotrf, DPOTRF, (F77_CONST_CHAR_ARG2 (&job, 1), nr,
+                                         tmp_data, nr, tmp_info
+                                         F77_CHAR_ARG_LEN (1)));
+
+              count_factorization (mattype, start);
+
+              info = tmp_info;
+            }
 
           // Throw away extra info LAPACK gives so as to not change output.
           rcon = 0.0;
@@ -1445,20 +1549,32 @@ Matrix::fsolve (MatrixType& mattype, const Matrix& b, octave_idx_type& info,
             {
               if (calc_cond)
                 {
-                  Array<double> z (dim_vector (3 * nc, 1));
-                  double *pz = z.fortran_vec ();
-                  Array<F77_INT> iz (dim_vector (nc, 1));
-                  F77_INT *piz = iz.fortran_vec ();
+                  if (fact && fact->rcond (false) >= 0.0)
+                    rcon = fact->rcond (false);
+                  else
+                    {
+                      if (anorm < 0.0)
+                        anorm = norm1 (*this);
 
-                  F77_XFCN (dpocon, DPOCON, (F77_CONST_CHAR_ARG2 (&job, 1),
-                                             nr, tmp_data, nr, anorm,
-                                             rcon, pz, piz, tmp_info
-                                             F77_CHAR_ARG_LEN (1)));
+                      Array<double> z (dim_vector (3 * nc, 1));
+                      double *pz = z.fortran_vec ();
+                      Array<F77_INT> iz (dim_vector (nc, 1));
+                      F77_INT *piz = iz.fortran_vec ();
 
-                  info = tmp_info;
+                      // DPOCON does not modify the factors, which may be
+                      // shared with the cached factorization.
+                      double *tmp_data = const_cast<double *> (atmp.data ());
 
-                  if (info != 0)
-                    info = -2;
+                      F77_XFCN (dpocon, DPOCON, (F77_CONST_CHAR_ARG2 (&job, 1),
+                                                 nr, tmp_data, nr, anorm,
+                                                 rcon, pz, piz, tmp_info
+                                                 F77_CHAR_ARG_LEN (1)));
+
+                      info = tmp_info;
+
+                      if (info != 0)
+                        info = -2;
+                    }
 
                   volatile double rcond_plus_one = rcon + 1.0;
 
@@ -1475,6 +1591,17 @@ Matrix::fsolve (MatrixType& mattype, const Matrix& b, octave_idx_type& info,
 
               if (info == 0)
                 {
+                  if (! fact && mattype.cache_factorization ())
+                    {
+                      fact = std::make_shared<full_factorization>
+                               (*this, typ, atmp, Array<F77_INT> ());
+
+                      if (calc_cond)
+                        fact->rcond (false, rcon);
+
+                      mattype.cached_factorization (fact);
+                    }
+
                   retval = b;
                   double *result = retval.fortran_vec ();
 
@@ -1482,7 +1609,7 @@ Matrix::fsolve (MatrixType& mattype, const Matrix& b, octave_idx_type& info,
                   F77_INT b_nc = octave::to_f77_int (b.cols ());
 
                   F77_XFCN (dpotrs, DPOTRS, (F77_CONST_CHAR_ARG2 (&job, 1),
-                                             nr, b_nc, tmp_data, nr,
+                                             nr, b_nc, atmp.data (), nr,
                                              result, b_nr, tmp_info
                                              F77_CHAR_ARG_LEN (1)));
 
@@ -1500,25 +1627,35 @@ Matrix::fsolve (MatrixType& mattype, const Matrix& b, octave_idx_type& info,
         {
           info = 0;
 
-          Array<F77_INT> ipvt (dim_vector (nr, 1));
-          F77_INT *pipvt = ipvt.fortran_vec ();
+          std::shared_ptr<full_factorization> fact
+            = find_factorization (mattype, *this, typ);
 
-          Matrix atmp = *this;
-          double *tmp_data = atmp.fortran_vec ();
+          Matrix atmp;
+          Array<F77_INT> ipvt;
+          F77_INT tmp_info = 0;
 
-          if (calc_cond && anorm < 0.0)
-            anorm = norm1 (atmp);
+          if (fact)
+            {
+              atmp = fact->factors ();
+              ipvt = fact->pivots ();
+            }
+          else
+            {
+              ipvt = Array<F77_INT> (dim_vector (nr, 1));
+              F77_INT *pipvt = ipvt.fortran_vec ();
 
-          Array<double> z (dim_vector (4 * nc, 1));
-          double *pz = z.fortran_vec ();
-          Array<F77_INT> iz (dim_vector (nc, 1));
-          F77_INT *piz = iz.fortran_vec ();
+              atmp = *this;
+              double *tmp_data = atmp.fortran_vec ();
 
-          F77_INT tmp_info = 0;
+              double start = factor_start_time (mattype);
 
-          F77_XFCN (dgetrf, DGETRF, (nr, nr, tmp_data, nr, pipvt, tmp_info));
+              F77_XFCN (dgetrf, DGETRF, (nr, nr, tmp_data, nr, pipvt,
+                                         tmp_info));
 
-          info = tmp_info;
+              count_factorization (mattype, start);
+
+              info = tmp_info;
+            }
 
           // Throw away extra info LAPACK gives so as to not change output.
           rcon = 0.0;
@@ -1537,17 +1674,36 @@ Matrix::fsolve (MatrixType& mattype, const Matrix& b, octave_idx_type& info,
             {
               if (calc_cond)
                 {
-                  // Calculate the condition number for non-singular matrix.
-                  char job = '1';
-                  F77_XFCN (dgecon, DGECON, (F77_CONST_CHAR_ARG2 (&job, 1),
-                                             nc, tmp_data, nr, anorm,
-                                             rcon, pz, piz, tmp_info
-                                             F77_CHAR_ARG_LEN (1)));
-
-                  info = tmp_info;
-
-                  if (info != 0)
-                    info = -2;
+                  if (fact && fact->rcond (trans) >= 0.0)
+                    rcon = fact->rcond (trans);
+                  else
+                    {
+                      if (anorm < 0.0)
+                        anorm = norm1 (trans ? transpose () : *this);
+
+                      Array<double> z (dim_vector (4 * nc, 1));
+                      double *pz = z.fortran_vec ();
+                      Array<F77_INT> iz (dim_vector (nc, 1));
+                      F77_INT *piz = iz.fortran_vec ();
+
+                      // DGECON does not modify the factors, which may be
+                      // shared with the cached factorization.
+                      double *tmp_data = const_cast<double *> (atmp.data ());
+
+                      // Calculate the condition number for non-singular matrix.
+                      char job = (trans ? 'I' : '1');
+                      F77_XFCN (dgecon, DGECON, (F77_CONST_CHAR_ARG2 (&job, 1),
+                                                 nc, tmp_data, nr, anorm,
+                                                 rcon, pz, piz, tmp_info
+                                                 F77_CHAR_ARG_LEN (1)));
+
+                      info = tmp_info;
+
+                      if (info != 0)
+                        info = -2;
+                      else if (fact)
+                        fact->rcond (trans, rcon);
+                    }
 
                   volatile double rcond_plus_one = rcon + 1.0;
 
@@ -1562,16 +1718,28 @@ Matrix::fsolve (MatrixType& mattype, const Matrix& b, octave_idx_type& info,
 
               if (info == 0)
                 {
+                  if (! fact && mattype.cache_factorization ())
+                    {
+                      fact = std::make_shared<full_factorization>
+                               (*this, typ, atmp, ipvt);
+
+                      if (calc_cond)
+                        fact->rcond (trans, rcon);
+
+                      mattype.cached_factorization (fact);
+                    }
+
                   retval = b;
                   double *result = retval.fortran_vec ();
 
                   F77_INT b_nr = octave::to_f77_int (b.rows ());
                   F77_INT b_nc = octave::to_f77_int (b.cols ());
 
-                  char job = 'N';
+                  char job = (trans ? 'T' : 'N');
                   F77_XFCN (dgetrs, DGETRS, (F77_CONST_CHAR_ARG2 (&job, 1),
-                                             nr, b_nc, tmp_data, nr,
-                                             pipvt, result, b_nr, tmp_info
+                                             nr, b_nc, atmp.data (), nr,
+                                             ipvt.data (), result, b_nr,
+                                             tmp_info
                                              F77_CHAR_ARG_LEN (1)));
 
                   info = tmp_info;
@@ -1626,11 +1794,17 @@ Matrix::solve (MatrixType& mattype, const Matrix& b, octave_idx_type& info,
     retval = utsolve (mattype, b, info, rcon, sing_handler, true, transt);
   else if (typ == MatrixType::Lower || typ == MatrixType::Permuted_Lower)
     retval = ltsolve (mattype, b, info, rcon, sing_handler, true, transt);
-  else if (transt == blas_trans || transt == blas_conj_trans)
+  else if ((transt == blas_trans || transt == blas_conj_trans)
+           && ! (mattype.cache_factorization ()
+                 && (typ == MatrixType::Full || typ == MatrixType::Hermitian)))
     return transpose ().solve (mattype, b, info, rcon, sing_handler,
                                singular_fallback);
   else if (typ == MatrixType::Full || typ == MatrixType::Hermitian)
-    retval = fsolve (mattype, b, info, rcon, sing_handler, true);
+    {
+      // With a cached factorization, solve with the transpose using the
+      // factors of the matrix itself so they can be reused.
+      retval = fsolve (mattype, b, info, rcon, sing_handler, true, transt);
+    }
   else if (typ != MatrixType::Rectangular)
     (*current_liboctave_error_handler) ("unknown matrix type");
 
@@ -1638,7 +1812,10 @@ Matrix::solve (MatrixType& mattype, const Matrix& b, octave_idx_type& info,
   if (singular_fallback && mattype.type () == MatrixType::Rectangular)
     {
       octave_idx_type rank;
-      retval = lssolve (b, info, rank, rcon);
+      if (transt == blas_trans || transt == blas_conj_trans)
+        retval = transpose ().lssolve (b, info, rank, rcon);
+      else
+        retval = lssolve (b, info, rank, rcon);
     }
 
   return retval;
@@ -216,7 +216,8 @@ private:
   // Full matrix solvers (lu/cholesky)
   Matrix fsolve (MatrixType& mattype, const Matrix& b, octave_idx_type& info,
                  double& rcon, solve_singularity_handler sing_handler,
-                 bool calc_cond = false) const;
+                 bool calc_cond = false,
+                 blas_trans_type transt = blas_no_trans) const;
 
 public:
   // Generic interface to solver with no probing of type
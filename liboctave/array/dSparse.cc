@@ -45,6 +45,7 @@
 #include "sparse-lu.h"
 #include "MatrixType.h"
 #include "oct-sparse.h"
+#include "sparse-mul-tasks.h"
 #include "sparse-util.h"
 #include "sparse-chol.h"
 #include "sparse-qr.h"
@@ -5588,7 +5589,8 @@ SparseMatrix::bsolve (MatrixType& mattype, const SparseComplexMatrix& b,
 void *
 SparseMatrix::factorize (octave_idx_type& err, double& rcond, Matrix& Control,
                          Matrix& Info, solve_singularity_handler sing_handler,
-                         bool calc_cond) const
+                         bool calc_cond,
+                         octave::math::sparse_lu_symbolic *symbolic) const
 {
   // The return values
   void *Numeric = nullptr;
@@ -5629,13 +5631,25 @@ SparseMatrix::factorize (octave_idx_type& err, double& rcond, Matrix& Control,
                                  octave::to_suitesparse_intptr (Ai),
                                  Ax, 1, control);
 
-  void *Symbolic;
   Info = Matrix (1, UMFPACK_INFO);
   double *info = Info.fortran_vec ();
-  int status = UMFPACK_DNAME (qsymbolic) (nr, nc,
-                                          octave::to_suitesparse_intptr (Ap),
-                                          octave::to_suitesparse_intptr (Ai),
-                                          Ax, nullptr, &Symbolic, control, info);
+
+  // Reuse the symbolic analysis of a previously factorized matrix with
+  // the same sparsity pattern if one was given.
+
+  if (symbolic && symbolic->is_complex ())
+    (*current_liboctave_error_handler)
+      ("SparseMatrix::solve: symbolic analysis is for a complex matrix");
+
+  void *Symbolic = (symbolic ? symbolic->take (nr, nc, Ap, Ai, control)
+                    : nullptr);
+  int status = 0;
+
+  if (! Symbolic)
+    status = UMFPACK_DNAME (qsymbolic) (nr, nc,
+                                        octave::to_suitesparse_intptr (Ap),
+                                        octave::to_suitesparse_intptr (Ai),
+                                        Ax, nullptr, &Symbolic, control, info);
 
   if (status < 0)
     {
@@ -5656,7 +5670,11 @@ SparseMatrix::factorize (octave_idx_type& err, double& rcond, Matrix& Control,
       status = UMFPACK_DNAME (numeric) (octave::to_suitesparse_intptr (Ap),
                                         octave::to_suitesparse_intptr (Ai),
                                         Ax, Symbolic, &Numeric, control, info);
-      UMFPACK_DNAME (free_symbolic) (&Symbolic);
+
+      if (symbolic)
+        symbolic->put (nr, nc, Ap, Ai, control, Symbolic);
+      else
+        UMFPACK_DNAME (free_symbolic) (&Symbolic);
 
       if (calc_cond)
         rcond = Info (UMFPACK_RCOND);
@@ -5862,7 +5880,8 @@ SparseMatrix::fsolve (MatrixType& mattype, const Matrix& b,
 #if defined (HAVE_UMFPACK)
           Matrix Control, Info;
           void *Numeric
-            = factorize (err, rcond, Control, Info, sing_handler, calc_cond);
+            = factorize (err, rcond, Control, Info, sing_handler, calc_cond,
+                         mattype.sparse_symbolic ().get ());
 
           if (err == 0)
             {
@@ -6091,7 +6110,8 @@ SparseMatrix::fsolve (MatrixType& mattype, const SparseMatrix& b,
 #if defined (HAVE_UMFPACK)
           Matrix Control, Info;
           void *Numeric = factorize (err, rcond, Control, Info,
-                                     sing_handler, calc_cond);
+                                     sing_handler, calc_cond,
+                                     mattype.sparse_symbolic ().get ());
 
           if (err == 0)
             {
@@ -6336,7 +6356,8 @@ SparseMatrix::fsolve (MatrixType& mattype, const ComplexMatrix& b,
 #if defined (HAVE_UMFPACK)
           Matrix Control, Info;
           void *Numeric = factorize (err, rcond, Control, Info,
-                                     sing_handler, calc_cond);
+                                     sing_handler, calc_cond,
+                                     mattype.sparse_symbolic ().get ());
 
           if (err == 0)
             {
@@ -6586,7 +6607,8 @@ SparseMatrix::fsolve (MatrixType& mattype, const SparseComplexMatrix& b,
 #if defined (HAVE_UMFPACK)
           Matrix Control, Info;
           void *Numeric = factorize (err, rcond, Control, Info,
-                                     sing_handler, calc_cond);
+                                     sing_handler, calc_cond,
+                                     mattype.sparse_symbolic ().get ());
 
           if (err == 0)
             {
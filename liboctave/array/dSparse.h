@@ -268,7 +268,8 @@ private:
   OCTAVE_API void *
   factorize (octave_idx_type& err, double& rcond, Matrix& Control,
              Matrix& Info, solve_singularity_handler sing_handler,
-             bool calc_cond = false) const;
+             bool calc_cond = false,
+             octave::math::sparse_lu_symbolic *symbolic = nullptr) const;
 
   OCTAVE_API Matrix
   fsolve (MatrixType& typ, const Matrix& b, octave_idx_type& info,
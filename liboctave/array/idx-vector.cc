@@ -30,7 +30,9 @@
 #include <cinttypes>
 #include <cstdlib>
 
+#include <algorithm>
 #include <ostream>
+#include <vector>
 
 #include "idx-vector.h"
 #include "Array.h"
@@ -1260,6 +1262,145 @@ octave_idx_type idx_vector::ones_count () const
   return n;
 }
 
+// Size of the blocks handed to each thread by parallel_blocks and
+// mask_chunks.
+
+static const octave_idx_type parallel_block_size = 32768;
+
+void
+idx_vector::parallel_blocks (octave_idx_type n,
+                             const std::function<void (octave_idx_type,
+                                                       octave_idx_type)>& body)
+{
+  octave_idx_type nblocks
+    = (n + parallel_block_size - 1) / parallel_block_size;
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp parallel for
+#endif
+  for (octave_idx_type b = 0; b < nblocks; b++)
+    body (b * parallel_block_size,
+          std::min (n, (b + 1) * parallel_block_size));
+}
+
+void
+idx_vector::mask_chunks (const bool *data, octave_idx_type ext,
+                         const std::function<void (octave_idx_type,
+                                                   octave_idx_type,
+                                                   octave_idx_type)>& body)
+{
+  octave_idx_type nchunks
+    = (ext + parallel_block_size - 1) / parallel_block_size;
+
+  std::vector<octave_idx_type> offset (nchunks);
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp parallel for
+#endif
+  for (octave_idx_type c = 0; c < nchunks; c++)
+    {
+      const bool *p = data + c * parallel_block_size;
+      offset[c] = std::count (p, p + std::min (parallel_block_size,
+                                               ext - c * parallel_block_size),
+                              true);
+    }
+
+  octave_idx_type k = 0;
+  for (octave_idx_type c = 0; c < nchunks; c++)
+    {
+      octave_idx_type nc = offset[c];
+      offset[c] = k;
+      k += nc;
+    }
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp parallel for
+#endif
+  for (octave_idx_type c = 0; c < nchunks; c++)
+    body (c * parallel_block_size,
+          std::min (ext, (c + 1) * parallel_block_size), offset[c]);
+}
+
+bool
+idx_vector::scatter_parts (const octave_idx_type *data, octave_idx_type len,
+                           octave_idx_type n,
+                           const std::function<void (const octave_idx_type *,
+                                                     octave_idx_type)>& body)
+{
+#if defined (OCTAVE_ENABLE_OPENMP)
+  if (len < 262144 || n < 2)
+    return false;
+
+  // Number of ranges of values and of chunks of the index vector, and
+  // number of positions distributed at a time.
+  static const int nparts = 64;
+  static const octave_idx_type slab = 4194304;
+
+  octave_idx_type width = (n + nparts - 1) / nparts;
+
+  std::vector<octave_idx_type> order (std::min (len, slab));
+  std::vector<octave_idx_type> pos (nparts * nparts);
+  octave_idx_type start[nparts + 1];
+
+  for (octave_idx_type s0 = 0; s0 < len; s0 += slab)
+    {
+      octave_idx_type ns = std::min (len - s0, slab);
+
+      // Count the positions of each chunk that fall into each range.
+#  pragma omp parallel for
+      for (int c = 0; c < nparts; c++)
+        {
+          octave_idx_type *cnt = &pos[c * nparts];
+          std::fill (cnt, cnt + nparts, 0);
+
+          for (octave_idx_type i = s0 + (ns * c) / nparts;
+               i < s0 + (ns * (c + 1)) / nparts; i++)
+            cnt[data[i] / width]++;
+        }
+
+      // Turn the counts into the positions of the chunks in ORDER.
+      octave_idx_type k = 0;
+
+      for (int p = 0; p < nparts; p++)
+        {
+          start[p] = k;
+
+          for (int c = 0; c < nparts; c++)
+            {
+              octave_idx_type m = pos[c * nparts + p];
+              pos[c * nparts + p] = k;
+              k += m;
+            }
+        }
+
+      start[nparts] = k;
+
+#  pragma omp parallel for
+      for (int c = 0; c < nparts; c++)
+        {
+          octave_idx_type *cpos = &pos[c * nparts];
+
+          for (octave_idx_type i = s0 + (ns * c) / nparts;
+               i < s0 + (ns * (c + 1)) / nparts; i++)
+            order[cpos[data[i] / width]++] = i;
+        }
+
+#  pragma omp parallel for schedule (dynamic)
+      for (int p = 0; p < nparts; p++)
+        body (order.data () + start[p], start[p+1] - start[p]);
+    }
+
+  return true;
+#else
+  octave_unused_parameter (data);
+  octave_unused_parameter (len);
+  octave_unused_parameter (n);
+  octave_unused_parameter (body);
+
+  return false;
+#endif
+}
+
 // Instantiate the octave_int constructors we want.
 #define INSTANTIATE_SCALAR_VECTOR_REP_CONST(T)                          \
   template OCTAVE_API idx_vector::idx_scalar_rep::idx_scalar_rep (T);   \
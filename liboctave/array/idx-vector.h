@@ -32,8 +32,11 @@
 #include <cstring>
 
 #include <algorithm>
+#include <functional>
 #include <iosfwd>
 #include <memory>
+#include <type_traits>
+#include <vector>
 
 #include "Array-fwd.h"
 #include "dim-vector.h"
@@ -573,6 +576,84 @@ public:
   friend std::ostream& operator << (std::ostream& os, const idx_vector& a)
   { return a.print (os); }
 
+  // Whether a gather or scatter of N elements of type T is worth
+  // splitting across threads.  Elements that are not trivially
+  // copyable may share reference counts, so they are always copied by
+  // a single thread.
+  template <typename T>
+  static bool
+  parallel_copy_ok (octave_idx_type n)
+  {
+    return std::is_trivially_copyable<T>::value && n >= 65536;
+  }
+
+  // Call BODY (LO, HI, K) for each run of true values DATA[LO:HI-1] in
+  // DATA[BEG:END-1], where K is the number of true values before LO,
+  // starting from K.  Return the number of true values up to END.
+  template <typename Functor>
+  static octave_idx_type
+  mask_runs (const bool *data, octave_idx_type beg, octave_idx_type end,
+             octave_idx_type k, Functor body)
+  {
+    const bool *p = data + beg;
+    const bool *pend = data + end;
+
+    while ((p = std::find (p, pend, true)) != pend)
+      {
+        const bool *q = std::find (p, pend, false);
+        body (p - data, q - data, k);
+        k += q - p;
+        p = q;
+      }
+
+    return k;
+  }
+
+  // Call BODY (BEG, END) for consecutive blocks [BEG, END) covering
+  // [0, N), with the blocks handled by different threads.
+  static void
+  parallel_blocks (octave_idx_type n,
+                   const std::function<void (octave_idx_type,
+                                             octave_idx_type)>& body);
+
+  // Call BODY (BEG, END, K) for consecutive chunks [BEG, END) of the
+  // mask DATA of length EXT, with the chunks handled by different
+  // threads.  K is the number of true values before BEG; the true
+  // values in each chunk are counted first to find it.
+  static void
+  mask_chunks (const bool *data, octave_idx_type ext,
+               const std::function<void (octave_idx_type, octave_idx_type,
+                                         octave_idx_type)>& body);
+
+  // Distribute the positions 0 to LEN-1 of the index vector DATA,
+  // whose values are less than N, to ranges of the values, and call
+  // BODY (ORDER, M) for each range, with the ranges handled by
+  // different threads.  ORDER lists the M positions whose values fall
+  // into the range, in increasing order.  Return false without calling
+  // BODY if the problem is too small to split or Octave is built
+  // without OpenMP.
+  static bool
+  scatter_parts (const octave_idx_type *data, octave_idx_type len,
+                 octave_idx_type n,
+                 const std::function<void (const octave_idx_type *,
+                                           octave_idx_type)>& body);
+
+  // Like mask_runs for the whole mask of length EXT, but if PAR is true
+  // the mask is split into chunks that are handled by different
+  // threads.
+  template <typename Functor>
+  static void
+  mask_loop (const bool *data, octave_idx_type ext, bool par, Functor body)
+  {
+    if (par)
+      mask_chunks (data, ext,
+                   [=, &body] (octave_idx_type beg, octave_idx_type end,
+                               octave_idx_type k)
+                   { mask_runs (data, beg, end, k, body); });
+    else
+      mask_runs (data, 0, ext, 0, body);
+  }
+
   // Slice with specializations.  No checking of bounds!
   //
   // This is equivalent to the following loop (but much faster):
@@ -624,8 +705,18 @@ public:
         {
           idx_vector_rep *r = dynamic_cast<idx_vector_rep *> (m_rep);
           const octave_idx_type *data = r->get_data ();
-          for (octave_idx_type i = 0; i < len; i++)
-            dest[i] = src[data[i]];
+          if (parallel_copy_ok<T> (len))
+            parallel_blocks (len, [=] (octave_idx_type beg,
+                                       octave_idx_type end)
+                             {
+                               for (octave_idx_type i = beg; i < end; i++)
+                                 dest[i] = src[data[i]];
+                             });
+          else
+            {
+              for (octave_idx_type i = 0; i < len; i++)
+                dest[i] = src[data[i]];
+            }
         }
         break;
 
@@ -634,8 +725,10 @@ public:
           idx_mask_rep *r = dynamic_cast<idx_mask_rep *> (m_rep);
           const bool *data = r->get_data ();
           octave_idx_type ext = r->extent (0);
-          for (octave_idx_type i = 0; i < ext; i++)
-            if (data[i]) *dest++ = src[i];
+          mask_loop (data, ext, parallel_copy_ok<T> (ext),
+                     [=] (octave_idx_type lo, octave_idx_type hi,
+                          octave_idx_type k)
+                     { std::copy (src + lo, src + hi, dest + k); });
         }
         break;
 
@@ -706,8 +799,10 @@ public:
           idx_mask_rep *r = dynamic_cast<idx_mask_rep *> (m_rep);
           const bool *data = r->get_data ();
           octave_idx_type ext = r->extent (0);
-          for (octave_idx_type i = 0; i < ext; i++)
-            if (data[i]) dest[i] = *src++;
+          mask_loop (data, ext, parallel_copy_ok<T> (ext),
+                     [=] (octave_idx_type lo, octave_idx_type hi,
+                          octave_idx_type k)
+                     { std::copy (src + k, src + k + (hi - lo), dest + lo); });
         }
         break;
 
@@ -778,8 +873,10 @@ public:
           idx_mask_rep *r = dynamic_cast<idx_mask_rep *> (m_rep);
           const bool *data = r->get_data ();
           octave_idx_type ext = r->extent (0);
-          for (octave_idx_type i = 0; i < ext; i++)
-            if (data[i]) dest[i] = val;
+          mask_loop (data, ext, parallel_copy_ok<T> (ext),
+                     [=, &val] (octave_idx_type lo, octave_idx_type hi,
+                                octave_idx_type)
+                     { std::fill (dest + lo, dest + hi, val); });
         }
         break;
 
@@ -30,11 +30,51 @@
 // source files that should have included config.h before including this file.
 
 #include <algorithm>
+#include <type_traits>
+#include <vector>
 
+#include "bsxfun-plan.h"
 #include "dim-vector.h"
 #include "lo-error.h"
 #include "mx-inlines.cc"
 #include "oct-locbuf.h"
+#include "quit.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Runs of the innermost dimension shorter than this are combined with
+// the next dimension into blocks of about bsxfun_block_len elements.
+const octave_idx_type bsxfun_short_run = 64;
+const octave_idx_type bsxfun_block_len = 4096;
+
+// Return a pointer to the N0 x K block of an operand with strides S0
+// and S1 starting at P, copying it to BUF unless it is contiguous.
+
+template <typename T>
+inline const T *
+bsxfun_block (const T *p, octave_idx_type s0, octave_idx_type s1,
+              octave_idx_type n0, octave_idx_type k, T *buf)
+{
+  if (s0 == 1 && s1 == n0)
+    return p;
+
+  for (octave_idx_type j = 0; j < k; j++)
+    for (octave_idx_type i = 0; i < n0; i++)
+      buf[i + n0*j] = p[i*s0 + j*s1];
+
+  return buf;
+}
+
+template <typename R, typename X, typename Y>
+inline bool
+bsxfun_parallel_ok ()
+{
+  return (std::is_trivially_copyable<R>::value
+          && std::is_trivially_copyable<X>::value
+          && std::is_trivially_copyable<Y>::value);
+}
+
+OCTAVE_END_NAMESPACE(octave)
 
 template <typename R, typename X, typename Y>
 Array<R>
@@ -66,72 +106,79 @@ do_bsxfun_op (const Array<X>& x, const Array<Y>& y,
 
   Array<R> retval (dvr);
 
+  if (retval.isempty ())
+    return retval;
+
   const X *xvec = x.data ();
   const Y *yvec = y.data ();
   R *rvec = retval.fortran_vec ();
 
-  // Fold the common leading dimensions.
-  octave_idx_type start, ldr = 1;
-  for (start = 0; start < nd; start++)
-    {
-      if (dvx(start) != dvy(start))
-        break;
-      ldr *= dvr(start);
-    }
+  const octave::bsxfun_plan plan (dvr, dvx, dvy);
 
-  if (retval.isempty ())
-    ; // do nothing
-  else if (start == nd)
-    op_vv (retval.numel (), rvec, xvec, yvec);
-  else
+  octave_idx_type nr = retval.numel ();
+  bool par = octave::bsxfun_parallel_ok<R, X, Y> ();
+
+  octave_idx_type n0 = plan.dim (0);
+  octave_idx_type sx0 = plan.x_stride (0);
+  octave_idx_type sy0 = plan.y_stride (0);
+
+  if (plan.ndims () > 1 && n0 < octave::bsxfun_short_run)
     {
-      // Determine the type of the low-level loop.
-      bool xsing = false;
-      bool ysing = false;
-      if (ldr == 1)
+      // Expand the operands over blocks of the two innermost
+      // dimensions so that the operation runs over long vectors.
+      octave_idx_type n1 = plan.dim (1);
+      octave_idx_type sx1 = plan.x_stride (1);
+      octave_idx_type sy1 = plan.y_stride (1);
+      octave_idx_type kb = std::max (octave::bsxfun_block_len / n0,
+                                     static_cast<octave_idx_type> (1));
+      kb = std::min (kb, n1);
+
+      plan.split (2, nr, par,
+                  [=, &plan] (octave_idx_type i0, octave_idx_type i1,
+                              bool interruptible)
+      {
+        OCTAVE_LOCAL_BUFFER (X, xbuf, n0 * kb);
+        OCTAVE_LOCAL_BUFFER (Y, ybuf, n0 * kb);
+
+        plan.loop (2, i0, i1, interruptible,
+                   [=, &xbuf, &ybuf] (octave_idx_type ro, octave_idx_type xo,
+                                      octave_idx_type yo)
         {
-          xsing = dvx(start) == 1;
-          ysing = dvy(start) == 1;
-          if (xsing || ysing)
+          for (octave_idx_type j = 0; j < n1; j += kb)
             {
-              ldr *= dvx(start) * dvy(start);
-              start++;
-            }
-        }
-      dim_vector cdvx = dvx.cumulative ();
-      dim_vector cdvy = dvy.cumulative ();
-      // Nullify singleton dims to achieve a spread effect.
-      for (int i = std::max (start, octave_idx_type (1)); i < nd; i++)
-        {
-          if (dvx(i) == 1)
-            cdvx(i-1) = 0;
-          if (dvy(i) == 1)
-            cdvy(i-1) = 0;
-        }
-
-      octave_idx_type niter = dvr.numel (start);
-      // The index array.
-      OCTAVE_LOCAL_BUFFER_INIT (octave_idx_type, idx, nd, 0);
-      for (octave_idx_type iter = 0; iter < niter; iter++)
-        {
-          octave_quit ();
+              octave_idx_type k = std::min (kb, n1 - j);
 
-          // Compute indices.
-          // FIXME: performance impact noticeable?
-          octave_idx_type xidx = cdvx.cum_compute_index (idx);
-          octave_idx_type yidx = cdvy.cum_compute_index (idx);
-          octave_idx_type ridx = dvr.compute_index (idx);
+              const X *xb
+                = octave::bsxfun_block (xvec + xo + j*sx1, sx0, sx1,
+                                        n0, k, &xbuf[0]);
+              const Y *yb
+                = octave::bsxfun_block (yvec + yo + j*sy1, sy0, sy1,
+                                        n0, k, &ybuf[0]);
 
+              op_vv (n0 * k, rvec + ro + j*n0, xb, yb);
+            }
+        });
+      });
+    }
+  else
+    {
+      plan.split (1, nr, par,
+                  [=, &plan] (octave_idx_type i0, octave_idx_type i1,
+                              bool interruptible)
+      {
+        plan.loop (1, i0, i1, interruptible,
+                   [=] (octave_idx_type ro, octave_idx_type xo,
+                        octave_idx_type yo)
+        {
           // Apply the low-level loop.
-          if (xsing)
-            op_sv (ldr, rvec + ridx, xvec[xidx], yvec + yidx);
-          else if (ysing)
-            op_vs (ldr, rvec + ridx, xvec + xidx, yvec[yidx]);
+          if (sx0 == 0)
+            op_sv (n0, rvec + ro, xvec[xo], yvec + yo);
+          else if (sy0 == 0)
+            op_vs (n0, rvec + ro, xvec + xo, yvec[yo]);
           else
-            op_vv (ldr, rvec + ridx, xvec + xidx, yvec + yidx);
-
-          dvr.increment_index (idx + start, start);
-        }
+            op_vv (n0, rvec + ro, xvec + xo, yvec + yo);
+        });
+      });
     }
 
   return retval;
@@ -148,64 +195,69 @@ do_inplace_bsxfun_op (Array<R>& r, const Array<X>& x,
   octave_idx_type nd = r.ndims ();
   dvx = dvx.redim (nd);
 
+  if (r.isempty ())
+    return;
+
   const X *xvec = x.data ();
   R *rvec = r.fortran_vec ();
 
-  // Fold the common leading dimensions.
-  octave_idx_type start, ldr = 1;
-  for (start = 0; start < nd; start++)
-    {
-      if (dvr(start) != dvx(start))
-        break;
-      ldr *= dvr(start);
-    }
+  // The result is also the first operand.
+  const octave::bsxfun_plan plan (dvr, dvx, dvr);
 
-  if (r.isempty ())
-    ; // do nothing
-  else if (start == nd)
-    op_vv (r.numel (), rvec, xvec);
-  else
+  octave_idx_type nr = r.numel ();
+  bool par = octave::bsxfun_parallel_ok<R, X, R> ();
+
+  octave_idx_type n0 = plan.dim (0);
+  octave_idx_type sx0 = plan.x_stride (0);
+
+  if (plan.ndims () > 1 && n0 < octave::bsxfun_short_run)
     {
-      // Determine the type of the low-level loop.
-      bool xsing = false;
-      if (ldr == 1)
+      octave_idx_type n1 = plan.dim (1);
+      octave_idx_type sx1 = plan.x_stride (1);
+      octave_idx_type kb = std::max (octave::bsxfun_block_len / n0,
+                                     static_cast<octave_idx_type> (1));
+      kb = std::min (kb, n1);
+
+      plan.split (2, nr, par,
+                  [=, &plan] (octave_idx_type i0, octave_idx_type i1,
+                              bool interruptible)
+      {
+        OCTAVE_LOCAL_BUFFER (X, xbuf, n0 * kb);
+
+        plan.loop (2, i0, i1, interruptible,
+                   [=, &xbuf] (octave_idx_type ro, octave_idx_type xo,
+                               octave_idx_type)
         {
-          xsing = dvx(start) == 1;
-          if (xsing)
+          for (octave_idx_type j = 0; j < n1; j += kb)
             {
-              ldr *= dvr(start) * dvx(start);
-              start++;
-            }
-        }
-
-      dim_vector cdvx = dvx.cumulative ();
-      // Nullify singleton dims to achieve a spread effect.
-      for (int i = std::max (start, octave_idx_type (1)); i < nd; i++)
-        {
-          if (dvx(i) == 1)
-            cdvx(i-1) = 0;
-        }
-
-      octave_idx_type niter = dvr.numel (start);
-      // The index array.
-      OCTAVE_LOCAL_BUFFER_INIT (octave_idx_type, idx, nd, 0);
-      for (octave_idx_type iter = 0; iter < niter; iter++)
-        {
-          octave_quit ();
+              octave_idx_type k = std::min (kb, n1 - j);
 
-          // Compute indices.
-          // FIXME: performance impact noticeable?
-          octave_idx_type xidx = cdvx.cum_compute_index (idx);
-          octave_idx_type ridx = dvr.compute_index (idx);
+              const X *xb
+                = octave::bsxfun_block (xvec + xo + j*sx1, sx0, sx1,
+                                        n0, k, &xbuf[0]);
 
+              op_vv (n0 * k, rvec + ro + j*n0, xb);
+            }
+        });
+      });
+    }
+  else
+    {
+      plan.split (1, nr, par,
+                  [=, &plan] (octave_idx_type i0, octave_idx_type i1,
+                              bool interruptible)
+      {
+        plan.loop (1, i0, i1, interruptible,
+                   [=] (octave_idx_type ro, octave_idx_type xo,
+                        octave_idx_type)
+        {
           // Apply the low-level loop.
-          if (xsing)
-            op_vs (ldr, rvec + ridx, xvec[xidx]);
+          if (sx0 == 0)
+            op_vs (n0, rvec + ro, xvec[xo]);
           else
-            op_vv (ldr, rvec + ridx, xvec + xidx);
-
-          dvr.increment_index (idx + start, start);
-        }
+            op_vv (n0, rvec + ro, xvec + xo);
+        });
+      });
     }
 }
 
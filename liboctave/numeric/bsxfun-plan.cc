@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <exception>
+
+#include "bsxfun-plan.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+bsxfun_plan::bsxfun_plan (const dim_vector& dvr, const dim_vector& dvx,
+                          const dim_vector& dvy)
+  : m_n (), m_sx (), m_sy ()
+{
+  octave_idx_type cx = 1;
+  octave_idx_type cy = 1;
+
+  for (int i = 0; i < dvr.ndims (); i++)
+    {
+      octave_idx_type n = dvr(i);
+      octave_idx_type sx = (dvx(i) == 1 ? 0 : cx);
+      octave_idx_type sy = (dvy(i) == 1 ? 0 : cy);
+
+      cx *= dvx(i);
+      cy *= dvy(i);
+
+      if (n == 1)
+        continue;
+
+      std::size_t k = m_n.size ();
+
+      if (k > 0 && mergeable (m_sx[k-1], sx, m_n[k-1])
+          && mergeable (m_sy[k-1], sy, m_n[k-1]))
+        m_n[k-1] *= n;
+      else
+        {
+          m_n.push_back (n);
+          m_sx.push_back (sx);
+          m_sy.push_back (sy);
+        }
+    }
+
+  if (m_n.empty ())
+    {
+      m_n.push_back (1);
+      m_sx.push_back (1);
+      m_sy.push_back (1);
+    }
+}
+
+octave_idx_type
+bsxfun_plan::r_stride (int k) const
+{
+  octave_idx_type s = 1;
+  for (int i = 0; i < k; i++)
+    s *= m_n[i];
+  return s;
+}
+
+octave_idx_type
+bsxfun_plan::count (int k) const
+{
+  octave_idx_type s = 1;
+  for (int i = k; i < ndims (); i++)
+    s *= m_n[i];
+  return s;
+}
+
+void
+bsxfun_plan::split (int k, octave_idx_type nr, bool par,
+                    const std::function<void (octave_idx_type,
+                                              octave_idx_type,
+                                              bool)>& task) const
+{
+  octave_idx_type niter = count (k);
+  octave_idx_type ntasks = 1;
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+  if (par)
+    ntasks = std::min (niter, std::min (nr / 65536,
+                                        static_cast<octave_idx_type> (256)));
+#else
+  octave_unused_parameter (nr);
+  octave_unused_parameter (par);
+#endif
+
+  if (ntasks <= 1)
+    {
+      task (0, niter, true);
+      return;
+    }
+
+  std::exception_ptr err;
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp parallel for schedule (dynamic)
+#endif
+  for (octave_idx_type t = 0; t < ntasks; t++)
+    {
+      try
+        {
+          task ((niter * t) / ntasks, (niter * (t + 1)) / ntasks, false);
+        }
+      catch (...)
+        {
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp critical (bsxfun_plan_split)
+#endif
+          err = std::current_exception ();
+        }
+    }
+
+  if (err)
+    std::rethrow_exception (err);
+}
+
+OCTAVE_END_NAMESPACE(octave)
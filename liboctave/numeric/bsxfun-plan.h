@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_bsxfun_plan_h)
+#define octave_bsxfun_plan_h 1
+
+#include "octave-config.h"
+
+#include <functional>
+#include <vector>
+
+#include "dim-vector.h"
+#include "oct-locbuf.h"
+#include "quit.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Loop structure of a broadcasting operation with result dimensions
+// DVR between operands with dimensions DVX and DVY.  Dimensions of
+// length 1 are dropped, and adjacent dimensions across which each
+// operand is either broadcast in both or contiguous are merged.  Each
+// remaining dimension has the strides of both operands, which are zero
+// where they are broadcast.  The result is always contiguous, and the
+// innermost strides of the operands are 0 or 1.
+
+class OCTAVE_API bsxfun_plan
+{
+public:
+
+  bsxfun_plan (const dim_vector& dvr, const dim_vector& dvx,
+               const dim_vector& dvy);
+
+  int ndims () const { return m_n.size (); }
+
+  octave_idx_type dim (int k) const { return m_n[k]; }
+
+  octave_idx_type x_stride (int k) const { return m_sx[k]; }
+
+  octave_idx_type y_stride (int k) const { return m_sy[k]; }
+
+  // Number of elements of the result in dimensions below K.
+  octave_idx_type r_stride (int k) const;
+
+  // Number of iterations over the dimensions from K upwards.
+  octave_idx_type count (int k) const;
+
+  // Call BODY (RO, XO, YO) with the offsets into the result and the
+  // operands for the iterations I0 to I1-1 over the dimensions from K
+  // upwards.
+  template <typename Body>
+  void
+  loop (int k, octave_idx_type i0, octave_idx_type i1, bool interruptible,
+        Body body) const
+  {
+    int nd = ndims ();
+    OCTAVE_LOCAL_BUFFER_INIT (octave_idx_type, idx, nd, 0);
+
+    octave_idx_type rs = r_stride (k);
+    octave_idx_type ro = i0 * rs;
+    octave_idx_type xo = 0;
+    octave_idx_type yo = 0;
+    octave_idx_type rest = i0;
+
+    for (int i = k; i < nd; i++)
+      {
+        idx[i] = rest % m_n[i];
+        rest /= m_n[i];
+        xo += idx[i] * m_sx[i];
+        yo += idx[i] * m_sy[i];
+      }
+
+    for (octave_idx_type iter = i0; iter < i1; iter++)
+      {
+        if (interruptible)
+          octave_quit ();
+
+        body (ro, xo, yo);
+
+        ro += rs;
+
+        for (int i = k; i < nd; i++)
+          {
+            xo += m_sx[i];
+            yo += m_sy[i];
+
+            if (++idx[i] < m_n[i])
+              break;
+
+            xo -= m_n[i] * m_sx[i];
+            yo -= m_n[i] * m_sy[i];
+            idx[i] = 0;
+          }
+      }
+  }
+
+  // Call TASK (I0, I1, INTERRUPTIBLE) for ranges of the iterations
+  // over the dimensions from K upwards, in parallel if the operation
+  // producing NR elements is large enough and PAR is true.
+  void
+  split (int k, octave_idx_type nr, bool par,
+         const std::function<void (octave_idx_type, octave_idx_type,
+                                   bool)>& task) const;
+
+private:
+
+  static bool
+  mergeable (octave_idx_type s0, octave_idx_type s1, octave_idx_type n0)
+  {
+    return (s0 == 0 ? s1 == 0 : s1 == s0 * n0);
+  }
+
+  std::vector<octave_idx_type> m_n;
+  std::vector<octave_idx_type> m_sx;
+  std::vector<octave_idx_type> m_sy;
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
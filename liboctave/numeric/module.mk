@@ -29,6 +29,7 @@ NUMERIC_INC = \
   %reldir%/base-dae.h \
   %reldir%/base-de.h \
   %reldir%/bsxfun-decl.h \
+  %reldir%/bsxfun-plan.h \
   %reldir%/bsxfun.h \
   %reldir%/chol.h \
   %reldir%/eigs-base.h \
@@ -73,6 +74,7 @@ NUMERIC_SRC = \
   %reldir%/ODES.cc \
   %reldir%/Quad.cc \
   %reldir%/aepbalance.cc \
+  %reldir%/bsxfun-plan.cc \
   %reldir%/chol.cc \
   %reldir%/eigs-base.cc \
   %reldir%/fEIG.cc \
@@ -28,6 +28,11 @@
 #endif
 
 #include <algorithm>
+#include <cmath>
+#include <complex>
+#include <exception>
+#include <limits>
+#include <new>
 
 #include "Array.h"
 #include "CColVector.h"
@@ -48,7 +53,9 @@
 #include "fMatrix.h"
 #include "fNDArray.h"
 #include "fRowVector.h"
+#include "lo-mappers.h"
 #include "oct-convn.h"
+#include "oct-fftw.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
@@ -146,6 +153,479 @@ void convolve_nd (const T *a, const dim_vector& ad, const dim_vector& acd,
     }
 }
 
+// Compute the slices Q0 to Q1-1 along the last dimension of the result
+// of convolve_nd.  The contributions to each element are accumulated
+// in the same order as by convolve_nd, so splitting the result into
+// ranges of slices does not change it.
+template <typename T, typename R>
+static void
+convolve_nd_slices (const T *a, const dim_vector& ad, const dim_vector& acd,
+                    const R *b, const dim_vector& bd, const dim_vector& bcd,
+                    T *c, const dim_vector& ccd, int nd, bool inner,
+                    octave_idx_type q0, octave_idx_type q1)
+{
+  octave_idx_type ma = acd(nd-2);
+  octave_idx_type na = ad(nd-1);
+  octave_idx_type mb = bcd(nd-2);
+  octave_idx_type nb = bd(nd-1);
+  octave_idx_type ldc = ccd(nd-2);
+
+  if (nd == 2)
+    {
+      F77_INT ad0 = to_f77_int (ad(0));
+      F77_INT bd0 = to_f77_int (bd(0));
+
+      if (inner)
+        convolve_2d<T, R> (a + ma*q0, ad0, to_f77_int (q1 - q0 + nb - 1),
+                           b, bd0, to_f77_int (nb), c + ldc*q0, inner);
+      else
+        for (octave_idx_type q = q0; q < q1; q++)
+          for (octave_idx_type ja = std::max (q - nb + 1,
+                                              static_cast<octave_idx_type> (0));
+               ja <= std::min (q, na - 1); ja++)
+            convolve_2d<T, R> (a + ma*ja, ad0, 1, b + mb*(q-ja), bd0, 1,
+                               c + ldc*q, inner);
+    }
+  else if (inner)
+    {
+      for (octave_idx_type ja = q0; ja < q1; ja++)
+        for (octave_idx_type jb = 0; jb < nb; jb++)
+          convolve_nd<T, R> (a + ma*(ja+jb), ad, acd,
+                             b + mb*(nb-jb-1), bd, bcd,
+                             c + ldc*ja, ccd, nd-1, inner);
+    }
+  else
+    {
+      for (octave_idx_type q = q0; q < q1; q++)
+        for (octave_idx_type ja = std::max (q - nb + 1,
+                                            static_cast<octave_idx_type> (0));
+             ja <= std::min (q, na - 1); ja++)
+          convolve_nd<T, R> (a + ma*ja, ad, acd, b + mb*(q-ja), bd, bcd,
+                             c + ldc*q, ccd, nd-1, inner);
+    }
+}
+
+// Direct convolution.  Large problems are split into ranges of slices
+// along the last dimension of the result which are computed in
+// parallel.  The result does not depend on the number of threads.
+template <typename T, typename R>
+static void
+convolve_direct (const T *a, const dim_vector& adims,
+                 const R *b, const dim_vector& bdims,
+                 T *c, const dim_vector& cdims, int nd, bool inner,
+                 double work)
+{
+  const dim_vector acd = adims.cumulative ();
+  const dim_vector bcd = bdims.cumulative ();
+  const dim_vector ccd = cdims.cumulative ();
+
+  octave_idx_type nq = cdims(nd-1);
+  octave_idx_type ntasks = 1;
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+  ntasks = std::min (nq, static_cast<octave_idx_type>
+                           (std::min (work / 1048576, 256.0)));
+#else
+  octave_unused_parameter (work);
+#endif
+
+  if (ntasks <= 1)
+    {
+      convolve_nd<T, R> (a, adims, acd, b, bdims, bcd, c, ccd, nd, inner);
+      return;
+    }
+
+  std::exception_ptr err;
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp parallel for schedule (dynamic)
+#endif
+  for (octave_idx_type t = 0; t < ntasks; t++)
+    {
+      try
+        {
+          convolve_nd_slices<T, R> (a, adims, acd, b, bdims, bcd,
+                                    c, ccd, nd, inner,
+                                    (nq * t) / ntasks, (nq * (t + 1)) / ntasks);
+        }
+      catch (...)
+        {
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp critical (convolve_direct)
+#endif
+          err = std::current_exception ();
+        }
+    }
+
+  if (err)
+    std::rethrow_exception (err);
+}
+
+#if defined (HAVE_FFTW)
+
+template <typename T>
+struct fft_conv_traits
+{
+  typedef std::complex<T> complex_type;
+};
+
+template <typename T>
+struct fft_conv_traits<std::complex<T>>
+{
+  typedef std::complex<T> complex_type;
+};
+
+static inline double
+fft_conv_abs (double x)
+{
+  return std::abs (x);
+}
+
+template <typename T>
+static inline double
+fft_conv_abs (const std::complex<T>& x)
+{
+  return std::abs (std::real (x)) + std::abs (std::imag (x));
+}
+
+static inline bool
+fft_conv_isinteger (double x)
+{
+  return math::x_nint (x) == x;
+}
+
+template <typename T>
+static inline bool
+fft_conv_isinteger (const std::complex<T>& x)
+{
+  return (fft_conv_isinteger (std::real (x))
+          && fft_conv_isinteger (std::imag (x)));
+}
+
+template <typename T>
+static inline void
+fft_conv_store (T& x, const std::complex<T>& z, bool add)
+{
+  x = (add ? x + std::real (z) : std::real (z));
+}
+
+template <typename T>
+static inline void
+fft_conv_store (std::complex<T>& x, const std::complex<T>& z, bool add)
+{
+  x = (add ? x + z : z);
+}
+
+template <typename T>
+static inline T
+fft_conv_round (T x)
+{
+  return math::x_nint (x);
+}
+
+template <typename T>
+static inline std::complex<T>
+fft_conv_round (const std::complex<T>& x)
+{
+  return std::complex<T> (math::x_nint (std::real (x)),
+                          math::x_nint (std::imag (x)));
+}
+
+static inline double
+fft_conv_abs2 (double x)
+{
+  return x * x;
+}
+
+template <typename T>
+static inline double
+fft_conv_abs2 (const std::complex<T>& x)
+{
+  return std::norm (std::complex<double> (x));
+}
+
+// Summary of the elements of an operand: whether they are all integers,
+// and their 1-norm and 2-norm.  Returns false if any of them is not
+// finite.
+
+template <typename T>
+static bool
+fft_conv_scan (const T *p, octave_idx_type n, bool& integer,
+               double& norm1, double& norm2)
+{
+  integer = true;
+  norm1 = norm2 = 0;
+
+  for (octave_idx_type i = 0; i < n; i++)
+    {
+      if (! math::isfinite (p[i]))
+        return false;
+
+      norm1 += fft_conv_abs (p[i]);
+      norm2 += fft_conv_abs2 (p[i]);
+      integer = integer && fft_conv_isinteger (p[i]);
+    }
+
+  norm2 = std::sqrt (norm2);
+
+  return true;
+}
+
+static bool
+fft_conv_smooth (octave_idx_type m)
+{
+  for (octave_idx_type p : {2, 3, 5, 7})
+    while (m % p == 0)
+      m /= p;
+
+  return m == 1;
+}
+
+// Smallest integer not less than N whose only prime factors are 2, 3,
+// 5 and 7, for which FFTW is fastest.
+
+static octave_idx_type
+fft_conv_size (octave_idx_type n)
+{
+  octave_idx_type m = n;
+
+  while (! fft_conv_smooth (m))
+    m++;
+
+  return m;
+}
+
+// Largest such integer not greater than N, or 0 if N < 1.
+
+static octave_idx_type
+fft_conv_size_below (octave_idx_type n)
+{
+  octave_idx_type m = n;
+
+  while (m > 0 && ! fft_conv_smooth (m))
+    m--;
+
+  return m;
+}
+
+// Ratio of the cost of one multiply-add of the direct method to that
+// of one butterfly of an FFT, and the amount of work below which the
+// direct method is always used.
+static const double FFT_CONV_COST = 6;
+static const double FFT_CONV_MIN_WORK = 4194304;
+
+// Largest number of elements of a single transform.  Each block needs
+// three complex arrays of this size, so larger problems are split into
+// blocks along their last non-singleton dimension instead of being
+// transformed at once.
+static const double FFT_CONV_MAX_SIZE = 4194304;
+
+// Convolution through the FFT of the operands, zero-padded so that the
+// circular convolution contains the requested part of the linear one.
+// Returns false, leaving C zero, if the direct method should be used
+// instead, because it is cheaper, because the FFT can not reproduce
+// its result closely enough, or because there is not enough memory.
+//
+// If the padded transform would be too large, the slices of the result
+// along the last non-singleton dimension K are computed in blocks: by
+// overlap-save for "valid" convolutions, where each block of the
+// result only needs the corresponding slices of A, and by overlap-add
+// otherwise, where the results of consecutive blocks of A overlap in
+// NB-1 slices and are added.  The transform of B is computed once.
+//
+// Differences from the direct method are at most of the order of eps
+// times log2 of the size of the transform times the 2-norm of one
+// operand times the 1-norm of the other, and typically of the order
+// of eps times the product of the 2-norms.  If both operands are
+// integer-valued and the first bound is small enough, the result is
+// rounded and is exact.
+
+template <typename T, typename R>
+static bool
+convolve_fft (const MArray<T>& a, const dim_vector& adims,
+              const MArray<R>& b, const dim_vector& bdims,
+              MArray<T>& c, const dim_vector& cdims, int nd, bool inner,
+              double work)
+{
+  typedef typename fft_conv_traits<T>::complex_type C;
+  typedef typename C::value_type real_type;
+
+  if (work < FFT_CONV_MIN_WORK)
+    return false;
+
+  // The dimension along which blocks are formed.  The slices of the
+  // result along it are contiguous because all later dimensions are
+  // singletons.
+
+  int k = nd - 1;
+  while (k > 0 && (inner ? adims(k) : cdims(k)) == 1)
+    k--;
+
+  dim_vector pdims = dim_vector::alloc (nd);
+  double nlead = 1;
+
+  for (int i = 0; i < nd; i++)
+    {
+      pdims(i) = fft_conv_size (inner ? adims(i) : cdims(i));
+      if (i != k)
+        nlead *= pdims(i);
+    }
+
+  // Number of slices of the result (for "valid") or of A (otherwise)
+  // along dimension K, and how many of them are handled per block.
+
+  octave_idx_type nb = bdims(k);
+  octave_idx_type nq = (inner ? cdims(k) : adims(k));
+  octave_idx_type blk = nq;
+
+  if (nlead * pdims(k) > FFT_CONV_MAX_SIZE)
+    {
+      octave_idx_type plen
+        = fft_conv_size_below (static_cast<octave_idx_type>
+                                 (FFT_CONV_MAX_SIZE / nlead));
+
+      // Blocks shorter than the kernel would mostly compute overlap.
+      if (plen < 2 * nb)
+        return false;
+
+      pdims(k) = plen;
+      blk = plen - nb + 1;
+    }
+
+  octave_idx_type nblocks = (nq + blk - 1) / blk;
+
+  double np = nlead * pdims(k);
+  double lognp = std::log2 (np);
+
+  // Each block needs two transforms, and B needs one.
+  if (work < FFT_CONV_COST * np * lognp * (2 * nblocks + 1) / 3)
+    return false;
+
+  bool a_int, b_int;
+  double a_norm1, a_norm2, b_norm1, b_norm2;
+
+  if (! fft_conv_scan (a.data (), a.numel (), a_int, a_norm1, a_norm2)
+      || ! fft_conv_scan (b.data (), b.numel (), b_int, b_norm1, b_norm2))
+    return false;
+
+  bool round = a_int && b_int;
+
+  if (round)
+    {
+      double bound = std::min (a_norm2 * b_norm1, a_norm1 * b_norm2);
+      double eps = std::numeric_limits<real_type>::epsilon ();
+
+      // With overlap-add, elements of the result receive contributions
+      // from two blocks.
+      if (nblocks > 1 && ! inner)
+        bound *= 2;
+
+      // Keep the exact result of the direct method if the rounding
+      // errors of the FFT could exceed half a unit.
+      if (bound * eps * 8 * (lognp + 1) >= 0.25)
+        return false;
+    }
+
+  // Number of elements of a slice of the result along dimension K.
+  octave_idx_type cstride = 1;
+  for (int i = 0; i < k; i++)
+    cstride *= cdims(i);
+
+  Array<octave_idx_type> origin (dim_vector (nd, 1), 0);
+
+  try
+    {
+      Array<C> bf (pdims);
+
+      {
+        Array<R> bp (pdims, R ());
+        bp.insert (b.reshape (bdims), origin);
+        fftw::fftNd (bp.data (), bf.fortran_vec (), nd, pdims);
+      }
+
+      const Array<T> ar = a.reshape (adims);
+
+      Array<idx_vector> aidx (dim_vector (nd, 1), idx_vector::colon);
+      Array<idx_vector> cidx (dim_vector (nd, 1));
+
+      for (int i = 0; i < nd; i++)
+        cidx(i) = idx_vector::make_range (inner ? bdims(i) - 1 : 0, 1,
+                                          cdims(i));
+
+      const C *pb = bf.data ();
+      T *pr = c.fortran_vec ();
+
+      for (octave_idx_type j = 0; j < nblocks; j++)
+        {
+          octave_idx_type q0 = j * blk;
+          octave_idx_type nqj = std::min (blk, nq - q0);
+
+          // Slices of A used by this block, and slices of the result
+          // computed from it.
+
+          octave_idx_type na = (inner ? nqj + nb - 1 : nqj);
+          octave_idx_type nc = (inner ? nqj : nqj + nb - 1);
+
+          Array<C> af (pdims);
+
+          {
+            Array<T> ap (pdims, T ());
+
+            if (nblocks == 1)
+              ap.insert (ar, origin);
+            else
+              {
+                aidx(k) = idx_vector::make_range (q0, 1, na);
+                ap.insert (ar.index (aidx), origin);
+              }
+
+            fftw::fftNd (ap.data (), af.fortran_vec (), nd, pdims);
+          }
+
+          C *pa = af.fortran_vec ();
+          octave_idx_type n = af.numel ();
+
+          for (octave_idx_type i = 0; i < n; i++)
+            pa[i] *= pb[i];
+
+          Array<C> cf (pdims);
+          fftw::ifftNd (af.data (), cf.fortran_vec (), nd, pdims);
+
+          af.clear ();
+
+          cidx(k) = idx_vector::make_range (inner ? nb - 1 : 0, 1, nc);
+
+          cf = cf.index (cidx);
+
+          const C *pc = cf.data ();
+          T *pcj = pr + q0 * cstride;
+          n = cf.numel ();
+
+          for (octave_idx_type i = 0; i < n; i++)
+            fft_conv_store (pcj[i], pc[i], ! inner && j > 0);
+        }
+    }
+  catch (const std::bad_alloc&)
+    {
+      std::fill_n (c.fortran_vec (), c.numel (), T ());
+
+      return false;
+    }
+
+  if (round)
+    {
+      T *pr = c.fortran_vec ();
+      octave_idx_type n = c.numel ();
+
+      for (octave_idx_type i = 0; i < n; i++)
+        pr[i] = fft_conv_round (pr[i]);
+    }
+
+  return true;
+}
+
+#endif
+
 // Arbitrary convolutor.
 // The 2nd array is assumed to be the smaller one.
 template <typename T, typename R>
@@ -178,10 +658,17 @@ convolve (const MArray<T>& a, const MArray<R>& b,
   if (c.isempty ())
     return c;
 
-  convolve_nd<T, R> (a.data (), adims, adims.cumulative (),
-                     b.data (), bdims, bdims.cumulative (),
-                     c.fortran_vec (), cdims.cumulative (),
-                     nd, ct == convn_valid);
+  bool inner = (ct == convn_valid);
+
+  // Number of multiply-adds needed by the direct method.
+  double work = static_cast<double> (inner ? c.numel () : a.numel ())
+                * b.numel ();
+
+#if defined (HAVE_FFTW)
+  if (! convolve_fft (a, adims, b, bdims, c, cdims, nd, inner, work))
+#endif
+    convolve_direct<T, R> (a.data (), adims, b.data (), bdims,
+                           c.fortran_vec (), cdims, nd, inner, work);
 
   if (ct == convn_same)
     {
@@ -27,6 +27,9 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
+#include <type_traits>
+
 #include "CSparse.h"
 #include "PermMatrix.h"
 #include "dSparse.h"
@@ -404,9 +407,123 @@ umfpack_report_symbolic <Complex> (void *Symbolic, const double *Control)
 
 #endif
 
+void *
+sparse_lu_symbolic::take (octave_idx_type nr, octave_idx_type nc,
+                          const octave_idx_type *cidx,
+                          const octave_idx_type *ridx,
+                          const double *control)
+{
+  if (! m_symbolic || ! matches (nr, nc, cidx, ridx, control))
+    return nullptr;
+
+  void *retval = m_symbolic;
+
+  m_symbolic = nullptr;
+
+  return retval;
+}
+
+void
+sparse_lu_symbolic::put (octave_idx_type nr, octave_idx_type nc,
+                         const octave_idx_type *cidx,
+                         const octave_idx_type *ridx,
+                         const double *control, void *symbolic)
+{
+  if (m_symbolic)
+    free_symbolic (&m_symbolic);
+
+  // The pattern is usually unchanged from the previous call.
+
+  if (! matches (nr, nc, cidx, ridx, control))
+    {
+      m_nr = nr;
+      m_nc = nc;
+      m_cidx.assign (cidx, cidx + nc + 1);
+      m_ridx.assign (ridx, ridx + cidx[nc]);
+#if defined (HAVE_UMFPACK)
+      m_control.assign (control, control + UMFPACK_CONTROL);
+#endif
+    }
+
+  m_symbolic = symbolic;
+}
+
+void
+sparse_lu_symbolic::clear ()
+{
+  if (m_symbolic)
+    free_symbolic (&m_symbolic);
+
+  m_symbolic = nullptr;
+
+  m_nr = 0;
+  m_nc = 0;
+  m_cidx.clear ();
+  m_ridx.clear ();
+  m_control.clear ();
+}
+
+bool
+sparse_lu_symbolic::same_pattern (octave_idx_type nr, octave_idx_type nc,
+                                  const octave_idx_type *cidx,
+                                  const octave_idx_type *ridx) const
+{
+  if (nr != m_nr || nc != m_nc
+      || m_cidx.size () != static_cast<std::size_t> (nc + 1))
+    return false;
+
+  if (! std::equal (m_cidx.begin (), m_cidx.end (), cidx))
+    return false;
+
+  return (m_ridx.size () == static_cast<std::size_t> (cidx[nc])
+          && std::equal (m_ridx.begin (), m_ridx.end (), ridx));
+}
+
+bool
+sparse_lu_symbolic::matches (octave_idx_type nr, octave_idx_type nc,
+                             const octave_idx_type *cidx,
+                             const octave_idx_type *ridx,
+                             const double *control) const
+{
+#if defined (HAVE_UMFPACK)
+  if (m_control.size () != static_cast<std::size_t> (UMFPACK_CONTROL)
+      || ! same_pattern (nr, nc, cidx, ridx))
+    return false;
+
+  // Unset (NaN) control values compare equal.
+
+  return std::equal (m_control.begin (), m_control.end (), control,
+                     [] (double a, double b)
+                     {
+                       return a == b || (a != a && b != b);
+                     });
+#else
+  octave_unused_parameter (nr);
+  octave_unused_parameter (nc);
+  octave_unused_parameter (cidx);
+  octave_unused_parameter (ridx);
+  octave_unused_parameter (control);
+
+  return false;
+#endif
+}
+
+void
+sparse_lu_symbolic::free_symbolic (void **symbolic) const
+{
+#if defined (HAVE_UMFPACK)
+  if (m_is_complex)
+    umfpack_free_symbolic<Complex> (symbolic);
+  else
+    umfpack_free_symbolic<double> (symbolic);
+#else
+  octave_unused_parameter (symbolic);
+#endif
+}
+
 template <typename lu_type>
 sparse_lu<lu_type>::sparse_lu (const lu_type& a, const Matrix& piv_thres,
-                               bool scale)
+                               bool scale, sparse_lu_symbolic *symbolic)
   : m_L (), m_U (), m_R (), m_cond (0), m_P (), m_Q ()
 {
 #if defined (HAVE_UMFPACK)
@@ -464,11 +581,24 @@ sparse_lu<lu_type>::sparse_lu (const lu_type& a, const Matrix& piv_thres,
                                       static_cast<octave_idx_type> (1),
                                       control);
 
-  void *Symbolic;
   Matrix Info (1, UMFPACK_INFO);
   double *info = Info.fortran_vec ();
-  int status = umfpack_qsymbolic<lu_elt_type> (nr, nc, Ap, Ai, Ax, nullptr,
-               &Symbolic, control, info);
+
+  // Reuse the symbolic analysis of a previously factorized matrix with
+  // the same sparsity pattern if one was given.
+
+  if (symbolic && (symbolic->is_complex ()
+                   != std::is_same<lu_elt_type, Complex>::value))
+    (*current_liboctave_error_handler)
+      ("sparse_lu: symbolic analysis is for a different type of matrix");
+
+  void *Symbolic = (symbolic ? symbolic->take (nr, nc, Ap, Ai, control)
+                    : nullptr);
+  int status = 0;
+
+  if (! Symbolic)
+    status = umfpack_qsymbolic<lu_elt_type> (nr, nc, Ap, Ai, Ax, nullptr,
+                                             &Symbolic, control, info);
 
   if (status < 0)
     {
@@ -487,7 +617,11 @@ sparse_lu<lu_type>::sparse_lu (const lu_type& a, const Matrix& piv_thres,
       void *Numeric;
       status = umfpack_numeric<lu_elt_type> (Ap, Ai, Ax, Symbolic,
                                              &Numeric, control, info);
-      umfpack_free_symbolic<lu_elt_type> (&Symbolic);
+
+      if (symbolic)
+        symbolic->put (nr, nc, Ap, Ai, control, Symbolic);
+      else
+        umfpack_free_symbolic<lu_elt_type> (&Symbolic);
 
       m_cond = Info (UMFPACK_RCOND);
 
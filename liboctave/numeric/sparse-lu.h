@@ -34,10 +34,87 @@
 #include "dMatrix.h"
 #include "dSparse.h"
 
+#include <vector>
+
 OCTAVE_BEGIN_NAMESPACE(octave)
 
 OCTAVE_BEGIN_NAMESPACE(math)
 
+// The symbolic part of a sparse LU factorization computed by UMFPACK,
+// i.e., the column ordering and elimination tree, which only depend on
+// the sparsity pattern of a matrix.  Solvers and sparse_lu that are
+// given an object of this class store the analysis they compute in it
+// and reuse it for later matrices with the same pattern and control
+// parameters, so that only the numeric factorization is repeated.
+// Checking the pattern takes time proportional to the number of
+// nonzero elements, which is much less than a new analysis.
+
+class
+OCTAVE_API
+sparse_lu_symbolic
+{
+public:
+
+  sparse_lu_symbolic (bool is_complex = false)
+    : m_is_complex (is_complex), m_nr (0), m_nc (0), m_cidx (), m_ridx (),
+      m_control (), m_symbolic (nullptr)
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (sparse_lu_symbolic)
+
+  ~sparse_lu_symbolic () { clear (); }
+
+  bool is_complex () const { return m_is_complex; }
+
+  // TRUE if no analysis has been stored yet.
+  bool is_empty () const { return m_cidx.empty (); }
+
+  // TRUE if the stored analysis was computed for a matrix with the
+  // given size and sparsity pattern.
+
+  bool same_pattern (octave_idx_type nr, octave_idx_type nc,
+                     const octave_idx_type *cidx,
+                     const octave_idx_type *ridx) const;
+
+  // Return the stored analysis if it was computed for a matrix with
+  // the given pattern and control parameters, or nullptr otherwise.
+  // The caller takes ownership of the returned object and should hand
+  // it back with put.
+
+  void * take (octave_idx_type nr, octave_idx_type nc,
+               const octave_idx_type *cidx, const octave_idx_type *ridx,
+               const double *control);
+
+  // Store SYMBOLIC, the analysis of the given matrix, replacing the
+  // stored one.  This object takes ownership of SYMBOLIC.
+
+  void put (octave_idx_type nr, octave_idx_type nc,
+            const octave_idx_type *cidx, const octave_idx_type *ridx,
+            const double *control, void *symbolic);
+
+  // Free the stored analysis.
+  void clear ();
+
+private:
+
+  bool matches (octave_idx_type nr, octave_idx_type nc,
+                const octave_idx_type *cidx, const octave_idx_type *ridx,
+                const double *control) const;
+
+  void free_symbolic (void **symbolic) const;
+
+  bool m_is_complex;
+
+  octave_idx_type m_nr;
+  octave_idx_type m_nc;
+
+  std::vector<octave_idx_type> m_cidx;
+  std::vector<octave_idx_type> m_ridx;
+  std::vector<double> m_control;
+
+  void *m_symbolic;
+};
+
 // If the sparse matrix classes become templated on the element type
 // (i.e., sparse_matrix<double>), then it might be best to make the
 // template parameter of this class also be the element type instead
@@ -55,9 +132,12 @@ public:
   sparse_lu ()
     : m_L (), m_U (), m_R (), m_cond (0), m_P (), m_Q () { }
 
+  // If SYMBOLIC is not null, its analysis is used if it matches A, and
+  // the analysis of A is stored in it otherwise.
+
   OCTAVE_API
   sparse_lu (const lu_type& a, const Matrix& piv_thres = Matrix (),
-             bool scale = false);
+             bool scale = false, sparse_lu_symbolic *symbolic = nullptr);
 
   OCTAVE_API
   sparse_lu (const lu_type& a, const ColumnVector& Qinit,
@@ -28,11 +28,17 @@
 
 #include "octave-config.h"
 
+#include <vector>
+
 #include "Array-util.h"
 #include "lo-array-errwarn.h"
 #include "mx-inlines.cc"
 #include "oct-locbuf.h"
 
+// The sparse matrix product macros below call octave::sparse_mul_ntasks
+// and octave::sparse_mul_ranges, which are declared in the private
+// header sparse-mul-tasks.h and are only available inside liboctave.
+
 // sparse matrix by scalar operations.
 
 #define SPARSE_SMS_BIN_OP_1(R, F, OP, M, S)                             \
@@ -1813,41 +1819,56 @@
     octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);               \
   else                                                                  \
     {                                                                   \
-      OCTAVE_LOCAL_BUFFER (octave_idx_type, w, nr);                     \
       RET_TYPE retval (nr, a_nc, static_cast<octave_idx_type> (0));     \
-      for (octave_idx_type i = 0; i < nr; i++)                          \
-        w[i] = 0;                                                       \
       retval.xcidx (0) = 0;                                             \
                                                                         \
-      octave_idx_type nel = 0;                                          \
+      /* Columns of the product are independent, so they are computed */ \
+      /* in ranges, each with its own workspace.  The first pass counts */ \
+      /* the entries of each column so that the second one can fill */  \
+      /* the columns of every range in place. */                        \
+      double work = 0;                                                  \
+      for (octave_idx_type j = 0; j < a.cidx (a_nc); j++)               \
+        work += m.cidx (a.ridx (j) + 1) - m.cidx (a.ridx (j));          \
+      octave_idx_type ntasks                                            \
+        = octave::sparse_mul_ntasks (work, a_nc, nr);                   \
+                                                                        \
+      auto count_range = [&] (octave_idx_type i0, octave_idx_type i1)   \
+      {                                                                 \
+        OCTAVE_LOCAL_BUFFER_INIT (octave_idx_type, w, nr, 0);           \
+                                                                        \
+        for (octave_idx_type i = i0; i < i1; i++)                       \
+          {                                                             \
+            if (ntasks == 1)                                            \
+              octave_quit ();                                           \
+                                                                        \
+            octave_idx_type nel = 0;                                    \
+            for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
+              {                                                         \
+                octave_idx_type col = a.ridx (j);                       \
+                for (octave_idx_type k = m.cidx (col) ; k < m.cidx (col+1); k++) \
+                  {                                                     \
+                    if (w[m.ridx (k)] != i + 1)                         \
+                      {                                                 \
+                        w[m.ridx (k)] = i + 1;                          \
+                        nel++;                                          \
+                      }                                                 \
+                  }                                                     \
+              }                                                         \
+            retval.xcidx (i+1) = nel;                                   \
+          }                                                             \
+      };                                                                \
+                                                                        \
+      octave::sparse_mul_ranges (a_nc, ntasks, count_range);            \
                                                                         \
       for (octave_idx_type i = 0; i < a_nc; i++)                        \
-        {                                                               \
-          for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++)   \
-            {                                                           \
-              octave_idx_type col = a.ridx (j);                         \
-              for (octave_idx_type k = m.cidx (col) ; k < m.cidx (col+1); k++) \
-                {                                                       \
-                  if (w[m.ridx (k)] < i + 1)                            \
-                    {                                                   \
-                      w[m.ridx (k)] = i + 1;                            \
-                      nel++;                                            \
-                    }                                                   \
-                  octave_quit ();                                       \
-                }                                                       \
-            }                                                           \
-          retval.xcidx (i+1) = nel;                                     \
-        }                                                               \
+        retval.xcidx (i+1) += retval.xcidx (i);                         \
+                                                                        \
+      octave_idx_type nel = retval.xcidx (a_nc);                        \
                                                                         \
       if (nel == 0)                                                     \
         return RET_TYPE (nr, a_nc);                                     \
       else                                                              \
         {                                                               \
-          for (octave_idx_type i = 0; i < nr; i++)                      \
-            w[i] = 0;                                                   \
-                                                                        \
-          OCTAVE_LOCAL_BUFFER (RET_EL_TYPE, Xcol, nr);                  \
-                                                                        \
           retval.change_capacity (nel);                                 \
           /* The optimal break-point as estimated from simulations */   \
           /* Note that Mergesort is O(nz log(nz)) while searching all */ \
@@ -1862,65 +1883,76 @@
           /* to these breakpoints */                                    \
           octave_idx_type n_per_col = (a_nc > 43000 ? 43000 :           \
                                        (a_nc * a_nc) / 43000);          \
-          octave_idx_type ii = 0;                                       \
           octave_idx_type *ri = retval.xridx ();                        \
-          octave_sort<octave_idx_type> sort;                            \
                                                                         \
-          for (octave_idx_type i = 0; i < a_nc ; i++)                   \
-            {                                                           \
-              if (retval.xcidx (i+1) - retval.xcidx (i) > n_per_col)    \
-                {                                                       \
-                  for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
-                    {                                                   \
-                      octave_idx_type col = a.ridx (j);                 \
-                      EL_TYPE tmpval = a.data (j);                      \
-                      for (octave_idx_type k = m.cidx (col) ;           \
-                           k < m.cidx (col+1); k++)                     \
-                        {                                               \
-                          octave_quit ();                               \
-                          octave_idx_type row = m.ridx (k);             \
-                          if (w[row] < i + 1)                           \
-                            {                                           \
-                              w[row] = i + 1;                           \
-                              Xcol[row] = tmpval * m.data (k);          \
-                            }                                           \
-                          else                                          \
-                            Xcol[row] += tmpval * m.data (k);           \
-                        }                                               \
-                    }                                                   \
-                  for (octave_idx_type k = 0; k < nr; k++)              \
-                    if (w[k] == i + 1)                                  \
+          auto mul_range = [&] (octave_idx_type i0, octave_idx_type i1) \
+          {                                                             \
+            OCTAVE_LOCAL_BUFFER_INIT (octave_idx_type, w, nr, 0);       \
+            OCTAVE_LOCAL_BUFFER (RET_EL_TYPE, Xcol, nr);                \
+            octave_sort<octave_idx_type> sort;                          \
+                                                                        \
+            for (octave_idx_type i = i0; i < i1; i++)                   \
+              {                                                         \
+                octave_idx_type ii = retval.xcidx (i);                  \
+                if (retval.xcidx (i+1) - retval.xcidx (i) > n_per_col)  \
+                  {                                                     \
+                    for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
                       {                                                 \
-                        retval.xdata (ii) = Xcol[k];                    \
-                        retval.xridx (ii++) = k;                        \
+                        octave_idx_type col = a.ridx (j);               \
+                        EL_TYPE tmpval = a.data (j);                    \
+                        for (octave_idx_type k = m.cidx (col) ;         \
+                             k < m.cidx (col+1); k++)                   \
+                          {                                             \
+                            if (ntasks == 1)                            \
+                              octave_quit ();                           \
+                            octave_idx_type row = m.ridx (k);           \
+                            if (w[row] != i + 1)                        \
+                              {                                         \
+                                w[row] = i + 1;                         \
+                                Xcol[row] = tmpval * m.data (k);        \
+                              }                                         \
+                            else                                        \
+                              Xcol[row] += tmpval * m.data (k);         \
+                          }                                             \
                       }                                                 \
-                }                                                       \
-              else                                                      \
-                {                                                       \
-                  for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
-                    {                                                   \
-                      octave_idx_type col = a.ridx (j);                 \
-                      EL_TYPE tmpval = a.data (j);                      \
-                      for (octave_idx_type k = m.cidx (col) ;           \
-                           k < m.cidx (col+1); k++)                     \
+                    for (octave_idx_type k = 0; k < nr; k++)            \
+                      if (w[k] == i + 1)                                \
                         {                                               \
-                          octave_quit ();                               \
-                          octave_idx_type row = m.ridx (k);             \
-                          if (w[row] < i + 1)                           \
-                            {                                           \
-                              w[row] = i + 1;                           \
-                              retval.xridx (ii++) = row;                \
-                              Xcol[row] = tmpval * m.data (k);          \
-                            }                                           \
-                          else                                          \
-                            Xcol[row] += tmpval * m.data (k);           \
+                          retval.xdata (ii) = Xcol[k];                  \
+                          retval.xridx (ii++) = k;                      \
                         }                                               \
-                    }                                                   \
-                  sort.sort (ri + retval.xcidx (i), ii - retval.xcidx (i)); \
-                  for (octave_idx_type k = retval.xcidx (i); k < ii; k++) \
-                    retval.xdata (k) = Xcol[retval.xridx (k)];          \
-                }                                                       \
-            }                                                           \
+                  }                                                     \
+                else                                                    \
+                  {                                                     \
+                    for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
+                      {                                                 \
+                        octave_idx_type col = a.ridx (j);               \
+                        EL_TYPE tmpval = a.data (j);                    \
+                        for (octave_idx_type k = m.cidx (col) ;         \
+                             k < m.cidx (col+1); k++)                   \
+                          {                                             \
+                            if (ntasks == 1)                            \
+                              octave_quit ();                           \
+                            octave_idx_type row = m.ridx (k);           \
+                            if (w[row] != i + 1)                        \
+                              {                                         \
+                                w[row] = i + 1;                         \
+                                retval.xridx (ii++) = row;              \
+                                Xcol[row] = tmpval * m.data (k);        \
+                              }                                         \
+                            else                                        \
+                              Xcol[row] += tmpval * m.data (k);         \
+                          }                                             \
+                      }                                                 \
+                    sort.sort (ri + retval.xcidx (i), ii - retval.xcidx (i)); \
+                    for (octave_idx_type k = retval.xcidx (i); k < ii; k++) \
+                      retval.xdata (k) = Xcol[retval.xridx (k)];        \
+                  }                                                     \
+              }                                                         \
+          };                                                            \
+                                                                        \
+          octave::sparse_mul_ranges (a_nc, ntasks, mul_range);          \
+                                                                        \
           retval.maybe_compress (true);                                 \
           return retval;                                                \
         }                                                               \
@@ -1939,24 +1971,85 @@
       return retval;                                                    \
     }                                                                   \
   else if (nc != a_nr)                                                  \
-    octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);               \
+    octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);       \
   else                                                                  \
     {                                                                   \
-      RET_TYPE::element_type zero = RET_TYPE::element_type ();          \
+      typedef RET_TYPE::element_type ret_el_type;                       \
+                                                                        \
+      ret_el_type zero = ret_el_type ();                                \
                                                                         \
       RET_TYPE retval (nr, a_nc, zero);                                 \
+      ret_el_type *pr = retval.fortran_vec ();                          \
+                                                                        \
+      /* Split the columns of the result if there are enough of them. */ \
+      /* Otherwise (e.g., A*x), split the columns of the sparse matrix */ \
+      /* and sum the partial products of each range in a fixed order. */ \
+      double work = static_cast<double> (m.nnz ()) * a_nc;              \
+      octave_idx_type ntasks = octave::sparse_mul_ntasks (work, a_nc);  \
+      octave_idx_type nblocks                                           \
+        = octave::sparse_mul_ntasks (work, nc,                          \
+                                     static_cast<double> (nr) * a_nc);  \
+                                                                        \
+      if (ntasks >= nblocks)                                            \
+        {                                                               \
+          auto mul_range = [&] (octave_idx_type i0, octave_idx_type i1) \
+          {                                                             \
+            for (octave_idx_type i = i0; i < i1 ; i++)                  \
+              {                                                         \
+                for (octave_idx_type j = 0; j < a_nr; j++)              \
+                  {                                                     \
+                    if (ntasks == 1)                                    \
+                      octave_quit ();                                   \
+                                                                        \
+                    EL_TYPE tmpval = a.elem (j,i);                      \
+                    ret_el_type *pri = pr + nr*i;                       \
+                    for (octave_idx_type k = m.cidx (j) ; k < m.cidx (j+1); k++) \
+                      pri[m.ridx (k)] += tmpval * m.data (k);           \
+                  }                                                     \
+              }                                                         \
+          };                                                            \
                                                                         \
-      for (octave_idx_type i = 0; i < a_nc ; i++)                       \
+          octave::sparse_mul_ranges (a_nc, ntasks, mul_range);          \
+        }                                                               \
+      else                                                              \
         {                                                               \
-          for (octave_idx_type j = 0; j < a_nr; j++)                    \
-            {                                                           \
-              octave_quit ();                                           \
+          octave_idx_type len = nr * a_nc;                              \
+          std::vector<ret_el_type> part ((nblocks - 1) * len, zero);    \
                                                                         \
-              EL_TYPE tmpval = a.elem (j,i);                            \
-              for (octave_idx_type k = m.cidx (j) ; k < m.cidx (j+1); k++) \
-                retval.elem (m.ridx (k),i) += tmpval * m.data (k);      \
-            }                                                           \
+          auto mul_block = [&] (octave_idx_type t0, octave_idx_type t1) \
+          {                                                             \
+            for (octave_idx_type t = t0; t < t1; t++)                   \
+              {                                                         \
+                ret_el_type *acc = (t == 0 ? pr : part.data () + (t-1)*len); \
+                octave_idx_type j0 = (nc * t) / nblocks;                \
+                octave_idx_type j1 = (nc * (t + 1)) / nblocks;          \
+                                                                        \
+                for (octave_idx_type i = 0; i < a_nc ; i++)             \
+                  for (octave_idx_type j = j0; j < j1; j++)             \
+                    {                                                   \
+                      EL_TYPE tmpval = a.elem (j,i);                    \
+                      ret_el_type *acci = acc + nr*i;                   \
+                      for (octave_idx_type k = m.cidx (j) ; k < m.cidx (j+1); k++) \
+                        acci[m.ridx (k)] += tmpval * m.data (k);        \
+                    }                                                   \
+              }                                                         \
+          };                                                            \
+                                                                        \
+          octave::sparse_mul_ranges (nblocks, nblocks, mul_block);      \
+                                                                        \
+          auto sum_range = [&] (octave_idx_type k0, octave_idx_type k1) \
+          {                                                             \
+            for (octave_idx_type k = k0; k < k1; k++)                   \
+              for (octave_idx_type t = 1; t < nblocks; t++)             \
+                pr[k] += part[(t-1)*len + k];                           \
+          };                                                            \
+                                                                        \
+          octave::sparse_mul_ranges                                     \
+            (len, octave::sparse_mul_ntasks (static_cast<double> (len)  \
+                                             * nblocks, len),           \
+             sum_range);                                                \
         }                                                               \
+                                                                        \
       return retval;                                                    \
     }
 
@@ -1973,23 +2066,36 @@
       return retval;                                                    \
     }                                                                   \
   else if (nr != a_nr)                                                  \
-    octave::err_nonconformant ("operator *", nc, nr, a_nr, a_nc);               \
+    octave::err_nonconformant ("operator *", nc, nr, a_nr, a_nc);       \
   else                                                                  \
     {                                                                   \
       RET_TYPE retval (nc, a_nc);                                       \
                                                                         \
-      for (octave_idx_type i = 0; i < a_nc ; i++)                       \
-        {                                                               \
-          for (octave_idx_type j = 0; j < nc; j++)                      \
-            {                                                           \
-              octave_quit ();                                           \
+      /* Each element of the result is a dot product with a column of */ \
+      /* the sparse matrix, so ranges of those columns are independent. */ \
+      octave_idx_type ntasks                                            \
+        = octave::sparse_mul_ntasks (static_cast<double> (m.nnz ()) * a_nc, \
+                                     nc);                               \
+                                                                        \
+      auto mul_range = [&] (octave_idx_type j0, octave_idx_type j1)     \
+      {                                                                 \
+        for (octave_idx_type i = 0; i < a_nc ; i++)                     \
+          {                                                             \
+            for (octave_idx_type j = j0; j < j1; j++)                   \
+              {                                                         \
+                if (ntasks == 1)                                        \
+                  octave_quit ();                                       \
+                                                                        \
+                EL_TYPE acc = EL_TYPE ();                               \
+                for (octave_idx_type k = m.cidx (j) ; k < m.cidx (j+1); k++) \
+                  acc += a.elem (m.ridx (k),i) * CONJ_OP (m.data (k));  \
+                retval.xelem (j,i) = acc;                               \
+              }                                                         \
+          }                                                             \
+      };                                                                \
+                                                                        \
+      octave::sparse_mul_ranges (nc, ntasks, mul_range);                \
                                                                         \
-              EL_TYPE acc = EL_TYPE ();                                 \
-              for (octave_idx_type k = m.cidx (j) ; k < m.cidx (j+1); k++) \
-                acc += a.elem (m.ridx (k),i) * CONJ_OP (m.data (k));    \
-              retval.xelem (j,i) = acc;                                 \
-            }                                                           \
-        }                                                               \
       return retval;                                                    \
     }
 
@@ -2006,25 +2112,36 @@
       return retval;                                                    \
     }                                                                   \
   else if (nc != a_nr)                                                  \
-    octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);               \
+    octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);       \
   else                                                                  \
     {                                                                   \
       RET_TYPE::element_type zero = RET_TYPE::element_type ();          \
                                                                         \
       RET_TYPE retval (nr, a_nc, zero);                                 \
                                                                         \
-      for (octave_idx_type i = 0; i < a_nc ; i++)                       \
-        {                                                               \
-          octave_quit ();                                               \
-          for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++)   \
-            {                                                           \
-              octave_idx_type col = a.ridx (j);                         \
-              EL_TYPE tmpval = a.data (j);                              \
+      octave_idx_type ntasks                                            \
+        = octave::sparse_mul_ntasks (static_cast<double> (a.nnz ()) * nr, \
+                                     a_nc);                             \
+                                                                        \
+      auto mul_range = [&] (octave_idx_type i0, octave_idx_type i1)     \
+      {                                                                 \
+        for (octave_idx_type i = i0; i < i1 ; i++)                      \
+          {                                                             \
+            if (ntasks == 1)                                            \
+              octave_quit ();                                           \
+            for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
+              {                                                         \
+                octave_idx_type col = a.ridx (j);                       \
+                EL_TYPE tmpval = a.data (j);                            \
+                                                                        \
+                for (octave_idx_type k = 0 ; k < nr; k++)               \
+                  retval.xelem (k,i) += tmpval * m.elem (k,col);        \
+              }                                                         \
+          }                                                             \
+      };                                                                \
+                                                                        \
+      octave::sparse_mul_ranges (a_nc, ntasks, mul_range);              \
                                                                         \
-              for (octave_idx_type k = 0 ; k < nr; k++)                 \
-                retval.xelem (k,i) += tmpval * m.elem (k,col);          \
-            }                                                           \
-        }                                                               \
       return retval;                                                    \
     }
 
@@ -2041,25 +2158,36 @@
       return retval;                                                    \
     }                                                                   \
   else if (nc != a_nc)                                                  \
-    octave::err_nonconformant ("operator *", nr, nc, a_nc, a_nr);               \
+    octave::err_nonconformant ("operator *", nr, nc, a_nc, a_nr);       \
   else                                                                  \
     {                                                                   \
       RET_TYPE::element_type zero = RET_TYPE::element_type ();          \
                                                                         \
       RET_TYPE retval (nr, a_nr, zero);                                 \
                                                                         \
-      for (octave_idx_type i = 0; i < a_nc ; i++)                       \
-        {                                                               \
-          octave_quit ();                                               \
-          for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++)   \
-            {                                                           \
-              octave_idx_type col = a.ridx (j);                         \
-              EL_TYPE tmpval = CONJ_OP (a.data (j));                    \
-              for (octave_idx_type k = 0 ; k < nr; k++)                 \
-                retval.xelem (k,col) += tmpval * m.elem (k,i);          \
-            }                                                           \
-        }                                                               \
+      /* Columns of the result are scattered to, so split the rows. */  \
+      double work = static_cast<double> (a.nnz ()) * nr;                \
+      octave_idx_type ntasks                                            \
+        = octave::sparse_mul_ntasks (work, nr, a.nnz ());               \
+                                                                        \
+      auto mul_range = [&] (octave_idx_type k0, octave_idx_type k1)     \
+      {                                                                 \
+        for (octave_idx_type i = 0; i < a_nc ; i++)                     \
+          {                                                             \
+            if (ntasks == 1)                                            \
+              octave_quit ();                                           \
+            for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
+              {                                                         \
+                octave_idx_type col = a.ridx (j);                       \
+                EL_TYPE tmpval = CONJ_OP (a.data (j));                  \
+                for (octave_idx_type k = k0 ; k < k1; k++)              \
+                  retval.xelem (k,col) += tmpval * m.elem (k,i);        \
+              }                                                         \
+          }                                                             \
+      };                                                                \
+                                                                        \
+      octave::sparse_mul_ranges (nr, ntasks, mul_range);                \
+                                                                        \
       return retval;                                                    \
     }
-
 #endif
@@ -28,6 +28,8 @@
 #endif
 
 #include <list>
+#include <map>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -106,22 +108,154 @@ OCTAVE_BEGIN_NAMESPACE(octave)
 // FIXME: should this be configurable?
 #define MAXLOOKBEHIND 10
 
+// Maximum number of compiled patterns kept for reuse.
+#define REGEXP_CACHE_SIZE 64
+
+// Number of times a pattern is executed before it is compiled to
+// machine code with the PCRE2 JIT compiler.
+#define PCRE_JIT_MIN_EXEC 16
+
 static bool lookbehind_warned = false;
 
 // FIXME: don't bother collecting and composing return values
 //        the user doesn't want.
 
+// A compiled pattern along with the named token information gathered
+// while rewriting the pattern for PCRE.  Patterns are often compiled
+// repeatedly with the same options (e.g., by regexp for each element of
+// a cell array), so the most recently used ones are kept in a cache.
+
+class regexp::compiled_pattern
+{
+public:
+
+  compiled_pattern (octave_pcre_code *code, const string_vector& named_pats,
+                    int names, const Array<int>& named_idx)
+    : m_code (code), m_named_pats (named_pats), m_names (names),
+      m_named_idx (named_idx), m_nexec (0)
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (compiled_pattern)
+
+  ~compiled_pattern () { octave_pcre_code_free (m_code); }
+
+  octave_pcre_code * code () const { return m_code; }
+
+  string_vector named_patterns () const { return m_named_pats; }
+
+  int names () const { return m_names; }
+
+  Array<int> named_index () const { return m_named_idx; }
+
+  // Called before each execution of the pattern.  Patterns that are
+  // executed often are compiled to machine code.  If the JIT compiler is
+  // not available, PCRE2 silently keeps using the interpreter.
+
+  void executing ()
+  {
+#if defined (HAVE_PCRE2)
+    if (m_nexec++ == PCRE_JIT_MIN_EXEC)
+      pcre2_jit_compile (m_code, PCRE2_JIT_COMPLETE);
+#endif
+  }
+
+  static std::shared_ptr<compiled_pattern>
+  find (const std::string& pattern, int options);
+
+  static void
+  insert (const std::string& pattern, int options,
+          const std::shared_ptr<compiled_pattern>& cp);
+
+private:
+
+  typedef std::pair<std::string, int> key_type;
+
+  typedef std::list<std::pair<key_type, std::shared_ptr<compiled_pattern>>>
+    lru_list;
+
+  octave_pcre_code *m_code;
+
+  string_vector m_named_pats;
+  int m_names;
+  Array<int> m_named_idx;
+
+  std::size_t m_nexec;
+
+  // Cached patterns, most recently used first, and an index into the
+  // list by key.
+  static lru_list s_lru;
+  static std::map<key_type, lru_list::iterator> s_index;
+};
+
+regexp::compiled_pattern::lru_list regexp::compiled_pattern::s_lru;
+
+std::map<regexp::compiled_pattern::key_type,
+         regexp::compiled_pattern::lru_list::iterator>
+  regexp::compiled_pattern::s_index;
+
+std::shared_ptr<regexp::compiled_pattern>
+regexp::compiled_pattern::find (const std::string& pattern, int options)
+{
+  auto p = s_index.find (key_type (pattern, options));
+
+  if (p == s_index.end ())
+    return std::shared_ptr<compiled_pattern> ();
+
+  s_lru.splice (s_lru.begin (), s_lru, p->second);
+
+  return p->second->second;
+}
+
 void
-regexp::free ()
+regexp::compiled_pattern::insert (const std::string& pattern, int options,
+                                  const std::shared_ptr<compiled_pattern>& cp)
 {
-  octave_pcre_code_free (static_cast<octave_pcre_code *> (m_code));
+  key_type key (pattern, options);
+
+  auto p = s_index.find (key);
+
+  if (p != s_index.end ())
+    {
+      s_lru.erase (p->second);
+      s_index.erase (p);
+    }
+
+  s_lru.emplace_front (key, cp);
+  s_index[key] = s_lru.begin ();
+
+  if (s_lru.size () > REGEXP_CACHE_SIZE)
+    {
+      s_index.erase (s_lru.back ().first);
+      s_lru.pop_back ();
+    }
 }
 
 void
 regexp::compile_internal ()
 {
   // If we had a previously compiled pattern, release it.
-  free ();
+  m_code.reset ();
+  m_named_pats = string_vector ();
+  m_names = 0;
+  m_named_idx = Array<int> ();
+
+  int pcre_options
+    = (  (m_options.case_insensitive () ? OCTAVE_PCRE_CASELESS : 0)
+         | (m_options.dotexceptnewline () ? 0 : OCTAVE_PCRE_DOTALL)
+         | (m_options.lineanchors () ? OCTAVE_PCRE_MULTILINE : 0)
+         | (m_options.freespacing () ? OCTAVE_PCRE_EXTENDED : 0)
+         | OCTAVE_PCRE_UTF);
+
+  m_code = compiled_pattern::find (m_pattern, pcre_options);
+
+  if (m_code)
+    {
+      m_named_pats = m_code->named_patterns ();
+      m_names = m_code->names ();
+      m_named_idx = m_code->named_index ();
+
+      return;
+    }
 
   std::size_t max_length = MAXLOOKBEHIND;
 
@@ -278,22 +412,16 @@ regexp::compile_internal ()
   while ((pos = buf_str.find ('\0')) != std::string::npos)
     buf_str.replace (pos, 1, "\\000");
 
-  int pcre_options
-    = (  (m_options.case_insensitive () ? OCTAVE_PCRE_CASELESS : 0)
-         | (m_options.dotexceptnewline () ? 0 : OCTAVE_PCRE_DOTALL)
-         | (m_options.lineanchors () ? OCTAVE_PCRE_MULTILINE : 0)
-         | (m_options.freespacing () ? OCTAVE_PCRE_EXTENDED : 0)
-         | OCTAVE_PCRE_UTF);
-
 #if defined (HAVE_PCRE2)
   PCRE2_SIZE erroffset;
   int errnumber;
 
-  m_code = pcre2_compile (reinterpret_cast<PCRE2_SPTR> (buf_str.c_str ()),
-                          PCRE2_ZERO_TERMINATED, pcre_options,
-                          &errnumber, &erroffset, nullptr);
+  octave_pcre_code *code
+    = pcre2_compile (reinterpret_cast<PCRE2_SPTR> (buf_str.c_str ()),
+                     PCRE2_ZERO_TERMINATED, pcre_options,
+                     &errnumber, &erroffset, nullptr);
 
-  if (! m_code)
+  if (! code)
     {
       // PCRE docs say:
       //
@@ -315,13 +443,18 @@ regexp::compile_internal ()
   const char *err;
   int erroffset;
 
-  m_code = pcre_compile (buf_str.c_str (), pcre_options,
-                         &err, &erroffset, nullptr);
+  octave_pcre_code *code = pcre_compile (buf_str.c_str (), pcre_options,
+                                         &err, &erroffset, nullptr);
 
-  if (! m_code)
+  if (! code)
     (*current_liboctave_error_handler)
       ("%s: %s at position %d of expression", m_who.c_str (), err, erroffset);
 #endif
+
+  m_code = std::make_shared<compiled_pattern> (code, m_named_pats, m_names,
+                                               m_named_idx);
+
+  compiled_pattern::insert (m_pattern, pcre_options, m_code);
 }
 
 regexp::match_data
@@ -343,14 +476,23 @@ regexp::match (const std::string& buffer) const
   char *nametable;
   std::size_t idx = 0;
 
-  octave_pcre_code *re = static_cast<octave_pcre_code *> (m_code);
+  octave_pcre_code *re = m_code->code ();
 
   octave_pcre_pattern_info (re, OCTAVE_PCRE_INFO_CAPTURECOUNT, &subpatterns);
   octave_pcre_pattern_info (re, OCTAVE_PCRE_INFO_NAMECOUNT, &namecount);
   octave_pcre_pattern_info (re, OCTAVE_PCRE_INFO_NAMEENTRYSIZE, &nameentrysize);
   octave_pcre_pattern_info (re, OCTAVE_PCRE_INFO_NAMETABLE, &nametable);
 
-#if defined (HAVE_PCRE)
+#if defined (HAVE_PCRE2)
+  // The match data block is private to this call and reused for all
+  // matches in BUFFER.  The cached pattern is shared by other regexp
+  // objects, so it only holds the compiled code.
+  pcre2_match_data *m_data
+    = pcre2_match_data_create_from_pattern (re, nullptr);
+
+  unwind_action cleanup_match_data
+    ([=] () { pcre2_match_data_free (m_data); });
+#else
   OCTAVE_LOCAL_BUFFER (OCTAVE_PCRE_SIZE, ovector, (subpatterns+1)*3);
 #endif
 
@@ -368,18 +510,24 @@ regexp::match (const std::string& buffer) const
     {
       octave_quit ();
 
-#if defined (HAVE_PCRE2)
-      pcre2_match_data *m_data
-        = pcre2_match_data_create_from_pattern (re, nullptr);
+      m_code->executing ();
 
-      unwind_action cleanup_match_data
-      ([=] () { pcre2_match_data_free (m_data); });
+#if defined (HAVE_PCRE2)
+      uint32_t match_options = PCRE2_NO_UTF_CHECK | (idx ? PCRE2_NOTBOL : 0);
 
       int matches = pcre2_match (re, reinterpret_cast<PCRE2_SPTR> (buffer.c_str ()),
-                                 buffer.length (), idx,
-                                 PCRE2_NO_UTF_CHECK | (idx ? PCRE2_NOTBOL : 0),
+                                 buffer.length (), idx, match_options,
                                  m_data, nullptr);
 
+#  if defined (PCRE2_NO_JIT)
+      // The JIT stack is much smaller than the one used by the
+      // interpreter.  Retry deeply nested matches without JIT.
+      if (matches == PCRE2_ERROR_JIT_STACKLIMIT)
+        matches = pcre2_match (re, reinterpret_cast<PCRE2_SPTR> (buffer.c_str ()),
+                               buffer.length (), idx,
+                               match_options | PCRE2_NO_JIT, m_data, nullptr);
+#  endif
+
       if (matches < 0 && matches != PCRE2_ERROR_NOMATCH)
         (*current_liboctave_error_handler)
           ("%s: internal error calling pcre2_match; "
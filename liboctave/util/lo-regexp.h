@@ -29,6 +29,7 @@
 #include "octave-config.h"
 
 #include <list>
+#include <memory>
 #include <sstream>
 #include <string>
 
@@ -51,7 +52,7 @@ public:
   regexp (const std::string& pat = "",
           const regexp::opts& opt = regexp::opts (),
           const std::string& w = "regexp")
-    : m_pattern (pat), m_options (opt), m_code (nullptr), m_named_pats (),
+    : m_pattern (pat), m_options (opt), m_code (), m_named_pats (),
       m_names (0), m_named_idx (), m_who (w)
   {
     compile_internal ();
@@ -61,7 +62,7 @@ public:
 
   regexp& operator = (const regexp& rx) = default;
 
-  ~regexp () { free (); }
+  ~regexp () = default;
 
   void compile (const std::string& pat,
                 const regexp::opts& opt = regexp::opts ())
@@ -224,16 +225,18 @@ private:
 
   opts m_options;
 
-  // Internal data describing the regular expression.
-  void *m_code;
+  class compiled_pattern;
+
+  // Internal data describing the regular expression.  Compiled patterns
+  // are cached and shared by all regexp objects using the same pattern
+  // and options.
+  std::shared_ptr<compiled_pattern> m_code;
 
   string_vector m_named_pats;
   int m_names;
   Array<int> m_named_idx;
   std::string m_who;
 
-  void free ();
-
   void compile_internal ();
 };
 
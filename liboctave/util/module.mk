@@ -42,7 +42,8 @@ UTIL_INC = \
 
 NOINSTALL_UTIL_INC = \
   %reldir%/kpse.h \
-  %reldir%/oct-sparse.h
+  %reldir%/oct-sparse.h \
+  %reldir%/sparse-mul-tasks.h
 
 UTIL_F77_SRC = \
   %reldir%/d1mach.f \
@@ -82,6 +83,7 @@ UTIL_SRC = \
   %reldir%/oct-string.cc \
   %reldir%/pathsearch.cc \
   %reldir%/singleton-cleanup.cc \
+  %reldir%/sparse-mul-tasks.cc \
   %reldir%/sparse-util.cc \
   %reldir%/str-vec.cc \
   %reldir%/unwind-prot.cc \
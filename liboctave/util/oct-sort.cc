@@ -111,10 +111,13 @@
 #include <algorithm>
 #include <cstring>
 #include <stack>
+#include <type_traits>
+#include <vector>
 
 #include "lo-error.h"
 #include "lo-mappers.h"
 #include "quit.h"
+#include "oct-inttypes-fwd.h"
 #include "oct-sort.h"
 #include "oct-locbuf.h"
 
@@ -1511,6 +1514,215 @@ octave_sort<T>::sort (T *data, octave_idx_type *idx, octave_idx_type nel,
     }
 }
 
+// Radix sort on the bit pattern of numeric keys.  The keys are mapped to
+// unsigned integers that compare in the same order as the values, then
+// sorted by an LSD radix sort, which is stable and therefore produces the
+// same result (and index permutation) as the merge sort with std::less or
+// std::greater.
+
+template <typename T, typename Enable = void>
+struct octave_sort_radix_traits
+{
+  static const bool enabled = false;
+};
+
+template <typename T>
+struct octave_sort_radix_traits
+  <T, typename std::enable_if<std::is_integral<T>::value
+                              && ! std::is_same<T, bool>::value>::type>
+{
+  static const bool enabled = true;
+
+  typedef typename std::make_unsigned<T>::type key_type;
+
+  static const key_type sign_bit
+    = (std::is_signed<T>::value
+       ? static_cast<key_type> (key_type (1) << (8 * sizeof (T) - 1))
+       : key_type (0));
+
+  static bool key (T x, key_type& k)
+  {
+    k = static_cast<key_type> (x) ^ sign_bit;
+    return true;
+  }
+
+  static T value (key_type k)
+  {
+    return static_cast<T> (static_cast<key_type> (k ^ sign_bit));
+  }
+};
+
+template <typename T>
+struct octave_sort_radix_traits<octave_int<T>>
+{
+  static const bool enabled = octave_sort_radix_traits<T>::enabled;
+
+  typedef typename octave_sort_radix_traits<T>::key_type key_type;
+
+  static bool key (const octave_int<T>& x, key_type& k)
+  {
+    return octave_sort_radix_traits<T>::key (x.value (), k);
+  }
+
+  static octave_int<T> value (key_type k)
+  {
+    return octave_int<T> (octave_sort_radix_traits<T>::value (k));
+  }
+};
+
+template <typename T>
+struct octave_sort_radix_traits
+  <T, typename std::enable_if<std::is_floating_point<T>::value
+                              && (sizeof (T) == 4 || sizeof (T) == 8)>::type>
+{
+  static const bool enabled = true;
+
+  typedef typename std::conditional<sizeof (T) == 4,
+                                    uint32_t, uint64_t>::type key_type;
+
+  static const key_type sign_bit = key_type (1) << (8 * sizeof (T) - 1);
+
+  // NaN has no place in the order and -0 must stay tied with +0, so both
+  // are left to the comparison sort.
+  static bool key (T x, key_type& k)
+  {
+    std::memcpy (&k, &x, sizeof (T));
+    if (k == sign_bit || x != x)
+      return false;
+    k = (k & sign_bit) ? static_cast<key_type> (~k) : (k | sign_bit);
+    return true;
+  }
+
+  static T value (key_type k)
+  {
+    k = (k & sign_bit) ? (k ^ sign_bit) : static_cast<key_type> (~k);
+    T x;
+    std::memcpy (&x, &k, sizeof (T));
+    return x;
+  }
+};
+
+// Below this size the merge sort is just as fast.
+static const octave_idx_type RADIX_SORT_MIN_NEL = 2048;
+
+// Number of key bits handled by each counting pass.
+static const int RADIX_SORT_BITS = 11;
+
+template <typename T>
+static bool
+radix_sort (T *, octave_idx_type *, octave_idx_type, bool, std::false_type)
+{
+  return false;
+}
+
+template <typename T>
+static bool
+radix_sort (T *data, octave_idx_type *idx, octave_idx_type nel,
+            bool descending, std::true_type)
+{
+  typedef octave_sort_radix_traits<T> traits;
+  typedef typename traits::key_type key_type;
+
+  if (nel < RADIX_SORT_MIN_NEL)
+    return false;
+
+  const int nbits = 8 * sizeof (key_type);
+  const int dbits = std::min (nbits, RADIX_SORT_BITS);
+  const int npass = (nbits + dbits - 1) / dbits;
+  const octave_idx_type nbuckets = octave_idx_type (1) << dbits;
+  const key_type dmask = static_cast<key_type> (nbuckets - 1);
+
+  // Flipping all bits of the key reverses the order but keeps equal
+  // elements in their original order, just like std::greater.
+  const key_type flip = descending ? static_cast<key_type> (~key_type (0))
+                                   : key_type (0);
+
+  OCTAVE_LOCAL_BUFFER (key_type, kbuf, 2 * nel);
+  key_type *src = kbuf;
+  key_type *dst = kbuf + nel;
+
+  bool sorted = true;
+  key_type prev = 0;
+  for (octave_idx_type i = 0; i < nel; i++)
+    {
+      key_type k;
+      if (! traits::key (data[i], k))
+        return false;
+      k ^= flip;
+      sorted = sorted && prev <= k;
+      prev = src[i] = k;
+    }
+
+  if (sorted)
+    return true;
+
+  std::vector<octave_idx_type> count (npass * nbuckets, 0);
+  for (octave_idx_type i = 0; i < nel; i++)
+    {
+      key_type k = src[i];
+      for (int p = 0; p < npass; p++)
+        count[p*nbuckets + ((k >> (p*dbits)) & dmask)]++;
+    }
+
+  OCTAVE_LOCAL_BUFFER (octave_idx_type, ibuf, idx ? nel : 0);
+  octave_idx_type *isrc = idx;
+  octave_idx_type *idst = ibuf;
+
+  for (int p = 0; p < npass; p++)
+    {
+      octave_idx_type *cnt = &count[p*nbuckets];
+      const int shift = p*dbits;
+
+      // Skip digits that are the same for all keys.
+      if (cnt[(src[0] >> shift) & dmask] == nel)
+        continue;
+
+      octave_idx_type sum = 0;
+      for (octave_idx_type d = 0; d < nbuckets; d++)
+        {
+          octave_idx_type c = cnt[d];
+          cnt[d] = sum;
+          sum += c;
+        }
+
+      if (idx)
+        {
+          for (octave_idx_type i = 0; i < nel; i++)
+            {
+              octave_idx_type j = cnt[(src[i] >> shift) & dmask]++;
+              dst[j] = src[i];
+              idst[j] = isrc[i];
+            }
+          std::swap (isrc, idst);
+        }
+      else
+        {
+          for (octave_idx_type i = 0; i < nel; i++)
+            dst[cnt[(src[i] >> shift) & dmask]++] = src[i];
+        }
+
+      std::swap (src, dst);
+    }
+
+  for (octave_idx_type i = 0; i < nel; i++)
+    data[i] = traits::value (src[i] ^ flip);
+
+  if (idx && isrc != idx)
+    std::copy_n (isrc, nel, idx);
+
+  return true;
+}
+
+template <typename T>
+static inline bool
+radix_sort (T *data, octave_idx_type *idx, octave_idx_type nel,
+            bool descending)
+{
+  return radix_sort (data, idx, nel, descending,
+                     std::integral_constant
+                       <bool, octave_sort_radix_traits<T>::enabled> ());
+}
+
 template <typename T>
 using compare_fcn_ptr = bool (*) (typename ref_param<T>::type,
                                   typename ref_param<T>::type);
@@ -1521,12 +1733,18 @@ octave_sort<T>::sort (T *data, octave_idx_type nel)
 {
 #if defined (INLINE_ASCENDING_SORT)
   if (*m_compare.template target<compare_fcn_ptr<T>> () == ascending_compare)
-    sort (data, nel, std::less<T> ());
+    {
+      if (! radix_sort (data, nullptr, nel, false))
+        sort (data, nel, std::less<T> ());
+    }
   else
 #endif
 #if defined (INLINE_DESCENDING_SORT)
     if (*m_compare.template target<compare_fcn_ptr<T>> () == descending_compare)
-      sort (data, nel, std::greater<T> ());
+      {
+        if (! radix_sort (data, nullptr, nel, true))
+          sort (data, nel, std::greater<T> ());
+      }
     else
 #endif
       if (m_compare)
@@ -1539,12 +1757,18 @@ octave_sort<T>::sort (T *data, octave_idx_type *idx, octave_idx_type nel)
 {
 #if defined (INLINE_ASCENDING_SORT)
   if (*m_compare.template target<compare_fcn_ptr<T>> () == ascending_compare)
-    sort (data, idx, nel, std::less<T> ());
+    {
+      if (! radix_sort (data, idx, nel, false))
+        sort (data, idx, nel, std::less<T> ());
+    }
   else
 #endif
 #if defined (INLINE_DESCENDING_SORT)
     if (*m_compare.template target<compare_fcn_ptr<T>> () == descending_compare)
-      sort (data, idx, nel, std::greater<T> ());
+      {
+        if (! radix_sort (data, idx, nel, true))
+          sort (data, idx, nel, std::greater<T> ());
+      }
     else
 #endif
       if (m_compare)
@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <exception>
+
+#include "sparse-mul-tasks.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+octave_idx_type
+sparse_mul_ntasks (double work, octave_idx_type n, double task_cost)
+{
+  octave_idx_type ntasks = 1;
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+  double nt = std::min (work / 65536, work / std::max (task_cost, 1.0));
+  if (nt >= 2)
+    ntasks = static_cast<octave_idx_type> (std::min (nt, 1024.0));
+  ntasks = std::max (std::min (ntasks, n), static_cast<octave_idx_type> (1));
+#else
+  octave_unused_parameter (work);
+  octave_unused_parameter (n);
+  octave_unused_parameter (task_cost);
+#endif
+
+  return ntasks;
+}
+
+void
+sparse_mul_ranges (octave_idx_type n, octave_idx_type ntasks,
+                   const std::function<void (octave_idx_type,
+                                             octave_idx_type)>& fcn)
+{
+  if (ntasks <= 1)
+    {
+      fcn (0, n);
+      return;
+    }
+
+  std::exception_ptr err;
+
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp parallel for schedule (dynamic)
+#endif
+  for (octave_idx_type t = 0; t < ntasks; t++)
+    {
+      try
+        {
+          fcn ((n * t) / ntasks, (n * (t + 1)) / ntasks);
+        }
+      catch (...)
+        {
+#if defined (OCTAVE_ENABLE_OPENMP)
+#  pragma omp critical (sparse_mul_ranges)
+#endif
+          err = std::current_exception ();
+        }
+    }
+
+  if (err)
+    std::rethrow_exception (err);
+}
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+// This file is not installed.  It is only used by the sparse matrix
+// product macros in Sparse-op-defs.h when they are expanded in liboctave.
+
+#if ! defined (octave_sparse_mul_tasks_h)
+#define octave_sparse_mul_tasks_h 1
+
+#include "octave-config.h"
+
+#include <functional>
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Number of ranges to split a product of about WORK operations over N
+// columns (or rows) into, when starting each range costs about
+// TASK_COST operations.  Products that are too small to gain from
+// threads, and all products in builds without OpenMP, are done in a
+// single range.
+
+extern octave_idx_type
+sparse_mul_ntasks (double work, octave_idx_type n, double task_cost = 1);
+
+// Split [0, N) into NTASKS consecutive ranges and call FCN (I0, I1) on
+// each of them, in parallel when Octave is built with OpenMP.  An
+// exception thrown by any range is rethrown once all are done.
+
+extern void
+sparse_mul_ranges (octave_idx_type n, octave_idx_type ntasks,
+                   const std::function<void (octave_idx_type,
+                                             octave_idx_type)>& fcn);
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
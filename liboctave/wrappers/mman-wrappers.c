@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+// These functions may be provided by gnulib.  We don't include gnulib
+// headers directly in Octave's C++ source files to avoid problems that
+// may be caused by the way that gnulib overrides standard library
+// functions.
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#if defined (HAVE_SYS_MMAN_H)
+#  include <sys/mman.h>
+#endif
+
+#include <unistd.h>
+
+#include "mman-wrappers.h"
+
+#if defined (HAVE_SYS_MMAN_H) && defined (HAVE_MMAP) && defined (HAVE_MUNMAP)
+#  define OCTAVE_USE_MMAP 1
+#endif
+
+int
+octave_have_mmap_wrapper (void)
+{
+#if defined (OCTAVE_USE_MMAP)
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+size_t
+octave_page_size_wrapper (void)
+{
+#if defined (_SC_PAGESIZE)
+  long int sz = sysconf (_SC_PAGESIZE);
+
+  if (sz > 0)
+    return sz;
+#endif
+
+  return 4096;
+}
+
+// Map LEN bytes of the file open on FD starting at OFFSET, which must
+// be a multiple of the page size.  The pages are private to this
+// process: they may be written, but changes are never carried through
+// to the file.  Return NULL on failure or if mmap is not available.
+
+void *
+octave_mmap_private_wrapper (int fd, off_t offset, size_t len)
+{
+#if defined (OCTAVE_USE_MMAP)
+  void *addr = mmap (NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                     fd, offset);
+
+  return addr == MAP_FAILED ? NULL : addr;
+#else
+  (void) fd;
+  (void) offset;
+  (void) len;
+
+  return NULL;
+#endif
+}
+
+// Map LEN bytes of zero-filled memory that is shared with the child
+// processes created by fork after this call.  Return NULL on failure or
+// if anonymous shared mappings are not available.
+
+void *
+octave_mmap_shared_anonymous_wrapper (size_t len)
+{
+#if defined (OCTAVE_USE_MMAP) && (defined (MAP_ANONYMOUS) || defined (MAP_ANON))
+#  if ! defined (MAP_ANONYMOUS)
+#    define MAP_ANONYMOUS MAP_ANON
+#  endif
+  void *addr = mmap (NULL, len, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+  return addr == MAP_FAILED ? NULL : addr;
+#else
+  (void) len;
+
+  return NULL;
+#endif
+}
+
+int
+octave_munmap_wrapper (void *addr, size_t len)
+{
+#if defined (OCTAVE_USE_MMAP)
+  return munmap (addr, len);
+#else
+  (void) addr;
+  (void) len;
+
+  return -1;
+#endif
+}
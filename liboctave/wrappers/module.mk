@@ -17,6 +17,7 @@ NOINSTALL_WRAPPERS_INC = \
   %reldir%/math-wrappers.h \
   %reldir%/mkostemp-wrapper.h \
   %reldir%/mkostemps-wrapper.h \
+  %reldir%/mman-wrappers.h \
   %reldir%/nanosleep-wrapper.h \
   %reldir%/nproc-wrapper.h \
   %reldir%/octave-popen2.h \
@@ -62,6 +63,7 @@ WRAPPERS_SRC = \
   %reldir%/math-wrappers.c \
   %reldir%/mkostemp-wrapper.c \
   %reldir%/mkostemps-wrapper.c \
+  %reldir%/mman-wrappers.c \
   %reldir%/nanosleep-wrapper.c \
   %reldir%/nproc-wrapper.c \
   %reldir%/octave-popen2.c \
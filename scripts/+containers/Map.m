@@ -101,7 +101,9 @@ classdef Map < handle
   endproperties
 
   properties (private)
-    map = struct ();
+    ## Hash table that holds the keys and values.  It is created by the
+    ## constructor because a default value would be shared by all maps.
+    map = [];
 
     numeric_keys = false;
   endproperties
@@ -112,6 +114,7 @@ classdef Map < handle
 
       if (nargin == 0)
         ## Empty object with "char" key type and "any" value type.
+        this.map = __hash_map__ (this.KeyType);
       elseif (nargin == 2 || (nargin == 4
                               && strcmpi (varargin{3}, "UniformValues")))
         ## Get Map keys
@@ -203,18 +206,9 @@ classdef Map < handle
         ## Check type of keys and values, and define numeric_keys
         check_types (this);
 
-        ## Sort keys (faster than call to sort_keys once encoded)
-        if (this.numeric_keys)
-          [~, I] = sort (cell2mat (keys));
-        else
-          [~, I] = sort (keys);
-        endif
-        keys = keys(I);
-        vals = vals(I);
-        ## Convert keys to char vectors
-        keys = encode_keys (this, keys);
         ## Fill in the Map
-        this.map = cell2struct (vals, keys);
+        this.map = __hash_map__ (this.KeyType);
+        __hash_map_assign__ (this.map, keys, vals);
       elseif (nargin == 4)
         for i = [1, 3]
           switch (lower (varargin{i}))
@@ -227,6 +221,7 @@ classdef Map < handle
           endswitch
         endfor
         check_types (this);
+        this.map = __hash_map__ (this.KeyType);
       else
         error ("containers.Map: incorrect number of inputs specified");
       endif
@@ -240,8 +235,7 @@ classdef Map < handle
       ## Return the sorted list of all keys of the map as a cell vector.
       ## @end deftypefn
 
-      keySet = fieldnames (this.map).';  # compatibility requires row vector
-      keySet = decode_keys (this, keySet);
+      keySet = __hash_map_keys__ (this.map);  # row vector for compatibility
 
     endfunction
 
@@ -257,21 +251,16 @@ classdef Map < handle
       ## @end deftypefn
 
       if (nargin == 1)
-        valueSet = struct2cell (this.map).';
+        valueSet = __hash_map_values__ (this.map);
       else
         if (! iscell (keySet))
           error ("containers.Map: input argument 'keySet' must be a cell");
         endif
-        enckeySet = encode_keys (this, keySet);
-        valueSet = cell (size (keySet));
-        for i = 1:numel (valueSet)
-          try
-            valueSet{i} = this.map.(enckeySet{i});
-          catch
-            error ("containers.Map: key <%s> does not exist",
-                   strtrim (disp (keySet{i})));
-          end_try_catch
-        endfor
+        [valueSet, found] = __hash_map_values__ (this.map, keySet);
+        if (! all (found(:)))
+          error ("containers.Map: key <%s> does not exist",
+                 strtrim (disp (keySet{find (! found, 1)})));
+        endif
       endif
 
     endfunction
@@ -288,20 +277,7 @@ classdef Map < handle
       ## vector.
       ## @end deftypefn
 
-      if (! iscell (keySet))
-        if (isnumeric (keySet) || islogical (keySet))
-          keySet = num2cell (keySet);
-        else
-          keySet = { keySet };
-        endif
-      endif
-      tf = false (size (keySet));
-      in = cellfun ("isnumeric", keySet) | cellfun ("islogical", keySet);
-      if (! this.numeric_keys)
-        in = ! in;
-      endif
-      keySet = encode_keys (this, keySet(in));
-      tf(in) = isfield (this.map, keySet);
+      tf = __hash_map_iskey__ (this.map, keySet);
 
     endfunction
 
@@ -317,20 +293,7 @@ classdef Map < handle
       ## single key.
       ## @end deftypefn
 
-      if (! iscell (keySet))
-        if (isnumeric (keySet) || islogical (keySet))
-          keySet = num2cell (keySet);
-        else
-          keySet = { keySet };
-        endif
-      endif
-      in = cellfun ("isnumeric", keySet) | cellfun ("islogical", keySet);
-      if (! this.numeric_keys)
-        in = ! in;
-      endif
-      keySet = encode_keys (this, keySet(in));
-      in = isfield (this.map, keySet);
-      this.map = rmfield (this.map, keySet(in));
+      __hash_map_remove__ (this.map, keySet);
 
     endfunction
 
@@ -383,7 +346,7 @@ classdef Map < handle
     endfunction
 
     function count = get.Count (this)
-      count = uint64 (numfields (this.map));
+      count = uint64 (__hash_map_count__ (this.map));
     endfunction
 
     function sref = subsref (this, s)
@@ -435,12 +398,12 @@ classdef Map < handle
                                         || ! isscalar (key))))
             error ("containers.Map: specified key type does not match the type of this container");
           endif
-          enckey = encode_keys (this, key);
-          if (! isfield (this.map, enckey))
+          [val, found] = __hash_map_values__ (this.map, {key});
+          if (! found)
             error ("containers.Map: specified key <%s> does not exist",
                    strtrim (disp (key)));
           endif
-          sref = this.map.(enckey);
+          sref = val{1};
         otherwise
           error ("containers.Map: only '()' indexing is supported");
       endswitch
@@ -474,13 +437,7 @@ classdef Map < handle
             endif
             val = feval (this.ValueType, val);
           endif
-          key = encode_keys (this, key);
-          if (isfield (this.map, key))
-            this.map.(key) = val;
-          else
-            this.map.(key) = val;
-            this = sort_keys (this);
-          endif
+          __hash_map_assign__ (this.map, {key}, {val});
         case "{}"
           error ("containers.Map: only '()' indexing is supported for assigning values");
       endswitch
@@ -529,52 +486,6 @@ classdef Map < handle
 
   methods (Access = private)
 
-    ## All keys are encoded as strings.
-    ## For numeric keys, this requires conversion.
-    function keys = encode_keys (this, keys)
-
-      if (iscellstr (keys) || ischar (keys))
-        return;
-      endif
-      cell_input = iscell (keys);
-      if (cell_input)
-        orig_sz = size (keys);
-        if (! all (cellfun ("isclass", keys, this.KeyType)))
-          ## Convert input set to KeyType.  This is rarely necessary.
-          keys = cellfun (@(x) feval (this.KeyType, x), keys);
-        else
-          keys = cell2mat (keys);
-        endif
-      elseif (! isa (keys, this.KeyType))
-        keys = feval (this.KeyType, keys);
-      endif
-      keys = num2hex (keys);  # Force to char matrix with single logical column
-      if (cell_input)
-        keys = reshape (cellstr (keys), orig_sz);
-      endif
-
-    endfunction
-
-    function keys = decode_keys (this, keys)
-      if (this.numeric_keys)
-        keys = hex2num (keys, this.KeyType);
-        ## This always returns a 1xN list of keys ignoring input shape
-        keys = mat2cell (keys(:).', 1, ones (1, numel (keys)));
-      endif
-    endfunction
-
-    function this = sort_keys (this)
-
-      keySet = keys (this);
-      if (this.numeric_keys)
-        [~, p] = sort (cell2mat (keySet));
-      else
-        [~, p] = sort (keySet);
-      endif
-      this.map = orderfields (this.map, p);
-
-    endfunction
-
     function check_types (this)
 
       switch (this.KeyType)
@@ -837,6 +748,18 @@ endclassdef
 %! assert (keys (m), num2cell (sort ([key, -2])));
 %! assert (values (m), {4, 6, 5, 3, 2, 1});
 
+## Test many keys with removal and re-insertion
+%!test
+%! m = containers.Map (1:1000, num2cell (1:1000));
+%! assert (m.isKey (1:1000), true (1, 1000));
+%! remove (m, num2cell (1:2:1000));
+%! assert (m.Count, uint64 (500));
+%! assert (keys (m), num2cell (2:2:1000));
+%! assert (isKey (m, [1, 2; 3, 4]), [false, true; false, true]);
+%! m(-1) = "new";
+%! assert (keys (m){1}, -1);
+%! assert (values (m, {-1, 1000}), {"new", 1000});
+
 ## Test horizontal concatenation
 %!test
 %! m1 = containers.Map ("b", 2);
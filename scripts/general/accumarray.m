@@ -337,6 +337,83 @@ function A = accumarray (subs, vals, sz = [], fcn = [], fillval = [], issparse =
         mask(subs) = false;
         A(mask) = fillval;
       endif
+    elseif ((fcn == @numel || fcn == @length)
+            && (isnumeric (vals) || islogical (vals)))
+      ## Fast counting.
+      if (isempty (sz))
+        A = __accumarray_sum__ (subs, 1);
+      else
+        A = __accumarray_sum__ (subs, 1, prod (sz));
+        A = reshape (A, sz);
+      endif
+
+      if (fillval != 0)
+        A(A == 0) = fillval;
+      endif
+    elseif (fcn == @mean && (isfloat (vals) || islogical (vals)
+                             || (isinteger (vals)
+                                 && ! isa (vals, {"int64", "uint64"}))))
+      ## Fast mean.  The sums are accumulated in double precision in the
+      ## same order as by mean.
+      if (isempty (sz))
+        A = __accumarray_sum__ (subs, double (vals));
+        n = __accumarray_sum__ (subs, 1, numel (A));
+      else
+        A = __accumarray_sum__ (subs, double (vals), prod (sz));
+        n = __accumarray_sum__ (subs, 1, prod (sz));
+        A = reshape (A, sz);
+        n = reshape (n, sz);
+      endif
+
+      A ./= n;
+      if (isa (vals, "single"))
+        A = single (A);
+      endif
+      A(n == 0) = fillval;
+    elseif (fcn == @prod && (isfloat (vals) || islogical (vals)))
+      ## Fast product.
+      if (isempty (sz))
+        A = __accumarray_prod__ (subs, vals);
+      else
+        A = __accumarray_prod__ (subs, vals, prod (sz));
+        A = reshape (A, sz);
+      endif
+
+      if (fillval != 1)
+        mask = true (size (A));
+        mask(subs) = false;
+        A(mask) = fillval;
+      endif
+    elseif ((fcn == @any || fcn == @all)
+            && (isnumeric (vals) || islogical (vals)))
+      ## Fast logical reductions.
+      if (fcn == @any)
+        reduce = @__accumarray_max__;
+        zero = false;
+      else
+        reduce = @__accumarray_min__;
+        zero = true;
+      endif
+
+      if (isempty (sz))
+        A = logical (reduce (subs, vals != 0, zero));
+      else
+        A = logical (reduce (subs, vals != 0, zero, prod (sz)));
+        A = reshape (A, sz);
+      endif
+
+      ## The result is logical only if it is filled with zeros.
+      if (fillval == 0)
+        fillval = false;
+      else
+        A = cast (A, class (fillval));
+      endif
+
+      if (fillval != zero)
+        mask = true (size (A));
+        mask(subs) = false;
+        A(mask) = fillval;
+      endif
     else
 
       ## The general case.  Reduce values.
@@ -445,6 +522,36 @@ endfunction
 %! assert (accumarray (subsc, vals, [], @max),
 %!         accumarray (subs, vals, [], @max));
 
+## Fast paths give the same results as the general case
+%!test
+%! subs = ceil (rand (2000, 1)*100);
+%! vals = rand (2000, 1);
+%! vals(1:3:end) = 0;
+%! for fcn = {@mean, @prod, @numel, @length, @any, @all}
+%!   f = fcn{1};
+%!   for fillval = {0, -1}
+%!     A = accumarray (subs, vals, [120, 1], f, fillval{1});
+%!     B = accumarray (subs, vals, [120, 1], @(x) f (x), fillval{1});
+%!     assert (A, B);
+%!     A = accumarray (subs, single (vals), [120, 1], f, fillval{1});
+%!     B = accumarray (subs, single (vals), [120, 1], @(x) f (x), fillval{1});
+%!     assert (A, B);
+%!   endfor
+%! endfor
+%!assert (accumarray ([1; 3; 3], [2; 0; 5], [], @all), [true; false; false])
+%!assert (accumarray ([1; 3; 3], [2; 0; 5], [], @any), [true; false; true])
+%!assert (accumarray ([1; 3; 3], int8 ([2; 4; 5]), [], @mean), [2; 0; 4.5])
+
+## Many values in few groups
+%!test
+%! subs = mod ((0:299999)', 7) + 1;
+%! vals = mod ((0:299999)', 11) - 5;
+%! for fcn = {@sum, @max, @min}
+%!   f = fcn{1};
+%!   assert (accumarray (subs, vals, [], f),
+%!           accumarray (subs, vals, [], @(x) f (x)));
+%! endfor
+
 %!error accumarray (1:5)
 %!error accumarray ([1,2,3],1:2)
 
@@ -178,6 +178,13 @@ endfunction
 %!assert (accumdim ([1;3;1;3;3], a, 1, 4)([2 4],:,:), zeros (2,5,5))
 %!assert (accumdim ([1;3;1;3;3], a, 1, 4, [], pi)([2 4],:,:), pi (2,5,5))
 
+## Test large problems with index masks and ranges
+%!test
+%! x = rand (2000, 300);
+%! assert (accumdim (true (1, 300), x, 2), x);
+%! assert (accumdim (1:300, x, 2), x);
+%! assert (accumdim (1:2000, x), x);
+
 ## Test input validation
 %!error <Invalid call> accumdim ()
 %!error <Invalid call> accumdim (1)
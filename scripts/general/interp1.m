@@ -297,30 +297,51 @@ function yi = interp1 (x, y, varargin)
 
     case "linear"
 
-      xx = x;
-      nxx = nx;
-      yy = y;
-      dy = diff (yy);
-      if (have_jumps)
-        ## Omit zero-size intervals.
-        xx(jumps) = [];
-        nxx = rows (xx);
-        yy(jumps, :) = [];
-        dy(jumps, :) = [];
-      endif
+      if (! ispp && ! have_jumps && isnumeric (extrap) && ! isempty (xi)
+          && numel (szy) == 2 && szy(2) <= 64
+          && isfloat (x) && isfloat (y) && isfloat (xi)
+          && isreal (x) && isreal (xi))
+        ## Interpolate each column with the compiled engine of interpn,
+        ## which finds the cell of each point in constant time on uniform
+        ## grids and walks from cell to cell for sorted points.  Points
+        ## outside the grid give NA and are replaced by EXTRAP below.
+        yi = zeros (numel (xi), nc, class (x([]) + y([]) + xi([])));
+        for k = 1:nc
+          yi(:,k) = __lin_interpn__ (x, y(:,k), xi);
+        endfor
+
+        if (nc == 1)
+          yi = reshape (yi, szx);
+        elseif (! isvector (reshape (xi, szx)))
+          yi = reshape (yi, [szx, nc]);
+        endif
 
-      dx = diff (xx);
-      dx = repmat (dx, [1 size(dy)(2:end)]);
+      else
+        xx = x;
+        nxx = nx;
+        yy = y;
+        dy = diff (yy);
+        if (have_jumps)
+          ## Omit zero-size intervals.
+          xx(jumps) = [];
+          nxx = rows (xx);
+          yy(jumps, :) = [];
+          dy(jumps, :) = [];
+        endif
 
-      coefs = [(dy./dx).', yy(1:nxx-1, :).'];
+        dx = diff (xx);
+        dx = repmat (dx, [1 size(dy)(2:end)]);
 
-      pp = mkpp (xx, coefs, szy(2:end));
-      pp.orient = "first";
+        coefs = [(dy./dx).', yy(1:nxx-1, :).'];
 
-      if (ispp)
-        yi = pp;
-      else
-        yi = ppval (pp, reshape (xi, szx));
+        pp = mkpp (xx, coefs, szy(2:end));
+        pp.orient = "first";
+
+        if (ispp)
+          yi = pp;
+        else
+          yi = ppval (pp, reshape (xi, szx));
+        endif
       endif
 
     case "*linear"
@@ -836,6 +857,9 @@ endfunction
 
 %!assert (interp1 ([4,4,3,2,0],[0,1,4,2,1],[1.5,4,4.5], "linear"), [1.75,1,NA])
 %!assert (interp1 (0:4, 2.5), 1.5)
+%!assert (interp1 ([0,1,3,7],[0,2,4,0],[7,0.5,2,6;-1,3,5,1]), ...
+%!        [0,1,3,1;NA,4,2,2], eps)
+%!assert (class (interp1 (single (1:3), single (1:3), 1.5)), "single")
 
 ## Left and Right discontinuities
 %!assert (interp1 ([1,2,2,3,4],[0,1,4,2,1],[-1,1.5,2,2.5,3.5], "linear", "extrap", "right"), [-2,0.5,4,3,1.5])
@@ -213,37 +213,18 @@ function ZI = interp2 (varargin)
       endif
     endif
 
-    xidx = lookup (X, XI, "lr");
-    yidx = lookup (Y, YI, "lr");
+    if (! strcmp (method, "linear"))
+      xidx = lookup (X, XI, "lr");
+      yidx = lookup (Y, YI, "lr");
+    endif
 
     if (strcmp (method, "linear"))
-      ## each quad satisfies the equation z(x,y)=a+b*x+c*y+d*xy
-      ##
-      ## a-b
-      ## | |
-      ## c-d
-      a = Z(1:(zr - 1), 1:(zc - 1));
-      b = Z(1:(zr - 1), 2:zc) - a;
-      c = Z(2:zr, 1:(zc - 1)) - a;
-      d = Z(2:zr, 2:zc) - a - b - c;
-
-      ## scale XI, YI values to a 1-spaced grid
-      Xsc = (XI - X(xidx)) ./ (diff (X)(xidx));
-      Ysc = (YI - Y(yidx)) ./ (diff (Y)(yidx));
-
-      ## Get 2-D index.
-      idx = sub2ind (size (a), yidx, xidx);
-      ## Dispose of the 1-D indices at this point to save memory.
-      clear xidx yidx;
-
-      ## Apply plane equation
-      ## Handle case where idx and coefficients are both vectors and resulting
-      ## coeff(idx) follows orientation of coeff, rather than that of idx.
-      forient = @(x) reshape (x, size (idx));
-      ZI =   forient (a(idx))        ...
-           + forient (b(idx)) .* Xsc ...
-           + forient (c(idx)) .* Ysc ...
-           + forient (d(idx)) .* Xsc.*Ysc;
+      ## The cells are found and interpolated by the compiled engine of
+      ## interpn.  Points outside the grid give NA and are replaced by
+      ## EXTRAP below.  The result has the class that arithmetic on the
+      ## inputs gives.
+      ZI = __lin_interpn__ (Y, X, Z, YI, XI);
+      ZI = cast (ZI, class (Z([]) + X([]) + Y([]) + XI([]) + YI([])));
 
     elseif (strcmp (method, "nearest"))
       ii = (XI - X(xidx) >= X(xidx + 1) - XI);
@@ -762,6 +743,14 @@ endfunction
 %! # FIXME: single column yields single row with spline interpolation (numbers are correct)
 %! assert (interp2 (z, [3; 3; 3], [2; 3; 1], "spline"), [7; 9; 5], tol);
 
+## Linear interpolation on a non-uniform grid
+%!test
+%! x = [0, 1, 3];  y = [0, 2];
+%! z = [0, 1, 3; 2, 3, 5];
+%! xi = [0.5, 2, 3, 4];  yi = [1, 1, 2, 1];
+%! assert (interp2 (x, y, z, xi, yi), [1.5, 3, 5, NA], eps);
+%! assert (class (interp2 (single (x), y, z, xi, yi)), "single");
+
 ## Test input validation
 %!error interp2 (1, 1, 1, 1, 1, 2)    # only 5 numeric inputs
 %!error interp2 (1, 1, 1, 1, 1, 2, 2) # only 5 numeric inputs
@@ -0,0 +1,197 @@
+########################################################################
+##
+## Copyright (C) 2023 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+classdef memmapfile < handle
+
+  ## -*- texinfo -*-
+  ## @deftypefn  {} {@var{m} =} memmapfile (@var{filename})
+  ## @deftypefnx {} {@var{m} =} memmapfile (@var{filename}, @var{name}, @var{value}, @dots{})
+  ## Create a view of the binary file @var{filename} as a numeric array.
+  ##
+  ## The data of the file are available as the column vector
+  ## @code{@var{m}.Data}.  Where the system supports it, the array is a
+  ## private memory mapping of the file: no data are read when the object is
+  ## created or when @code{Data} is accessed, pages of the file are only read
+  ## when the corresponding elements are used, and indexing a small part of a
+  ## large file does not copy the rest of it.  Assigning to elements of a copy
+  ## of @code{Data} never changes the file.
+  ##
+  ## The following options may be specified as @var{name}, @var{value} pairs
+  ## and are also available as properties of the object:
+  ##
+  ## @table @asis
+  ## @item @qcode{"Format"}
+  ## The class of the elements of @code{Data}, one of @qcode{"int8"},
+  ## @qcode{"uint8"} (default), @qcode{"int16"}, @qcode{"uint16"},
+  ## @qcode{"int32"}, @qcode{"uint32"}, @qcode{"int64"}, @qcode{"uint64"},
+  ## @qcode{"single"}, or @qcode{"double"}.  The data are stored in the file in
+  ## the native byte order of the machine.
+  ##
+  ## @item @qcode{"Offset"}
+  ## The number of bytes from the start of the file to the first element.  The
+  ## default is 0.
+  ##
+  ## @item @qcode{"Repeat"}
+  ## The number of elements in @code{Data}.  The default value @code{Inf}
+  ## uses all elements up to the end of the file.
+  ##
+  ## @item @qcode{"Writable"}
+  ## Only the default value @code{false} is supported.
+  ## @end table
+  ##
+  ## Example: read the second half of a file of doubles
+  ##
+  ## @example
+  ## @group
+  ## m = memmapfile ("samples.bin", "Format", "double");
+  ## n = numel (m.Data);
+  ## x = m.Data(n/2+1:end);
+  ## @end group
+  ## @end example
+  ##
+  ## @seealso{fread, fopen}
+  ## @end deftypefn
+
+  properties
+    Filename = "";
+    Format = "uint8";
+    Offset = 0;
+    Repeat = Inf;
+    Writable = false;
+  endproperties
+
+  properties (Dependent)
+    Data;
+  endproperties
+
+  methods
+
+    function this = memmapfile (filename, varargin)
+
+      if (nargin < 1)
+        print_usage ();
+      endif
+
+      if (! ischar (filename) || ! isrow (filename))
+        error ("memmapfile: FILENAME must be a string");
+      endif
+
+      fname = make_absolute_filename (tilde_expand (filename));
+      if (! isfile (fname))
+        error ("memmapfile: unable to find file '%s'", filename);
+      endif
+      this.Filename = fname;
+
+      if (mod (numel (varargin), 2) != 0)
+        error ("memmapfile: options must be NAME, VALUE pairs");
+      endif
+
+      for i = 1:2:numel (varargin)
+        name = varargin{i};
+        if (! ischar (name))
+          error ("memmapfile: option NAME must be a string");
+        endif
+        switch (lower (name))
+          case "format"
+            this.Format = varargin{i+1};
+          case "offset"
+            this.Offset = varargin{i+1};
+          case "repeat"
+            this.Repeat = varargin{i+1};
+          case "writable"
+            this.Writable = varargin{i+1};
+          otherwise
+            error ("memmapfile: unknown option '%s'", name);
+        endswitch
+      endfor
+
+    endfunction
+
+    function this = set.Format (this, value)
+      if (! any (strcmp (value, {"int8", "uint8", "int16", "uint16", ...
+                                 "int32", "uint32", "int64", "uint64", ...
+                                 "single", "double"})))
+        error ("memmapfile: Format must be the name of a numeric class");
+      endif
+      this.Format = value;
+    endfunction
+
+    function this = set.Offset (this, value)
+      if (! isscalar (value) || ! isreal (value) || value < 0
+          || value != fix (value) || isinf (value))
+        error ("memmapfile: Offset must be a nonnegative integer");
+      endif
+      this.Offset = double (value);
+    endfunction
+
+    function this = set.Repeat (this, value)
+      if (! isscalar (value) || ! isreal (value) || value < 0
+          || (value != fix (value) && ! isinf (value)))
+        error ("memmapfile: Repeat must be a nonnegative integer or Inf");
+      endif
+      this.Repeat = double (value);
+    endfunction
+
+    function this = set.Writable (this, value)
+      if (! isscalar (value) || value)
+        error ("memmapfile: writable mappings are not supported");
+      endif
+      this.Writable = false;
+    endfunction
+
+    function data = get.Data (this)
+      data = __memmap__ (this.Filename, this.Format, this.Offset, this.Repeat);
+    endfunction
+
+  endmethods
+
+endclassdef
+
+
+%!test
+%! f = tempname ();
+%! unwind_protect
+%!   fid = fopen (f, "wb");
+%!   fwrite (fid, "head");
+%!   fwrite (fid, int32 (-5:5), "int32");
+%!   fclose (fid);
+%!   m = memmapfile (f, "Format", "int32", "Offset", 4);
+%!   assert (m.Data, int32 (-5:5)');
+%!   assert (m.Data(end-1:end), int32 ([4; 5]));
+%!   m.Repeat = 3;
+%!   assert (m.Data, int32 ([-5; -4; -3]));
+%!   m = memmapfile (f);
+%!   assert (m.Data(1:4)', uint8 ("head"));
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+## Test input validation
+%!error <Invalid call> memmapfile ()
+%!error <unable to find file> memmapfile ("__no_such_file__")
+%!error <Format must be> memmapfile (file_in_loadpath ("memmapfile.m"), "Format", "char")
+%!error <Offset must be> memmapfile (file_in_loadpath ("memmapfile.m"), "Offset", -1)
+%!error <writable mappings> memmapfile (file_in_loadpath ("memmapfile.m"), "Writable", true)
+%!error <unknown option> memmapfile (file_in_loadpath ("memmapfile.m"), "Foo", 1)
@@ -49,6 +49,9 @@
 ## @code{max (size (@var{a}) - size (@var{b}) + 1, 0)}.
 ## @end table
 ##
+## Long convolutions may be computed with Fast Fourier Transforms; see
+## @code{conv2} for the accuracy of the result in that case.
+##
 ## @seealso{deconv, conv2, convn, fftconv}
 ## @end deftypefn
 
@@ -87,6 +87,29 @@ function [c, ia, ib] = intersect (a, b, varargin)
     isrowvec = isrow (a) && isrow (b);
   endif
 
+  if (! by_rows && ! optlegacy && ishashableset (a, b))
+    ## Look up the distinct elements of A in B instead of sorting both.
+    ia = __unique_index__ (a);
+    ib = __ismember_index__ (a(ia), b, "first");
+    tf = (ib != 0);
+    ia = ia(tf);
+    ib = ib(tf);
+    c = a(ia)(:);
+    if (optsorted)
+      [c, idx] = sort (c);
+      ia = ia(idx);
+      ib = ib(idx);
+    endif
+
+    ## Adjust output orientation for Matlab compatibility
+    if (isrowvec)
+      c = c.';
+    endif
+    ia = ia(:);
+    ib = ib(:);
+    return;
+  endif
+
   ## Form A and B into sets
   if (nargout > 1 || ! optsorted)
     [a, ia] = unique (a, varargin{:});
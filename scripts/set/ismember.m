@@ -124,7 +124,13 @@ function [tf, s_idx] = ismember (a, s, varargin)
   ## FIXME: uncomment if bug #56692 is addressed.
   ## optlegacy = any (strcmp ("legacy", varargin));
 
-  if (! by_rows)
+  if (! by_rows && ishashableset (a, s))
+    ## Match the elements with a hash table of S, or by merging A and S if
+    ## both are sorted.
+    s_idx = __ismember_index__ (a, s);
+    tf = logical (s_idx);
+
+  elseif (! by_rows)
     s = s(:);
     ## Check sort status, because we expect the array will often be sorted.
     if (issorted (s))
@@ -261,6 +267,15 @@ endfunction
 %! assert (result, logical ([1 0 0 0 1 0]'));
 %! assert (s_idx, [1 0 0 0 1 0]');
 
+%!test
+%! s = [4, 2, 4, 1, NaN, 2];
+%! [tf, s_idx] = ismember ([2, 4, NaN, 3], s);
+%! assert (tf, logical ([1, 1, 0, 0]));
+%! assert (s_idx, [6, 3, 0, 0]);
+%! [tf, s_idx] = ismember ([2; 4; 4; 5], sort (s));
+%! assert (tf, logical ([1; 1; 1; 0]));
+%! assert (s_idx, [3; 5; 5; 0]);
+
 %!test <*51187>
 %! assert (ismember ('b ', {'a ', 'b '}), true);
 
@@ -3,6 +3,7 @@ FCN_FILE_DIRS += \
   %reldir%/private
 
 %canon_reldir%_PRIVATE_FCN_FILES = \
+  %reldir%/private/ishashableset.m \
   %reldir%/private/validsetargs.m
 
 %canon_reldir%_FCN_FILES = \
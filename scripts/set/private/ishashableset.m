@@ -0,0 +1,53 @@
+########################################################################
+##
+## Copyright (C) 2023 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+## -*- texinfo -*-
+## @deftypefn  {} {@var{tf} =} ishashableset (@var{x})
+## @deftypefnx {} {@var{tf} =} ishashableset (@var{x}, @var{y})
+## Internal function to decide whether the elements of @var{x} and @var{y}
+## can be matched with @code{__unique_index__} and
+## @code{__ismember_index__} instead of sorting them.
+##
+## This is true for cell arrays of strings and for full real arrays of the
+## same class, for which the result of the set functions has the class of
+## @var{x}.
+## @seealso{unique, ismember, intersect, setdiff}
+## @end deftypefn
+
+function tf = ishashableset (x, y)
+
+  if (nargin < 2)
+    y = x;
+  endif
+
+  if (iscellstr (x))
+    tf = iscellstr (y);
+  else
+    tf = ((isnumeric (x) || ischar (x) || islogical (x))
+          && isreal (x) && ! issparse (x)
+          && strcmp (class (x), class (y)) && isreal (y) && ! issparse (y));
+  endif
+
+endfunction
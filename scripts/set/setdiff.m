@@ -87,6 +87,23 @@ function [c, ia] = setdiff (a, b, varargin)
         ia(idx(dups),:) = [];
       endif
     endif
+  elseif (! optlegacy && ! isempty (a) && ! isempty (b)
+          && ishashableset (a, b))
+    ## Look up the distinct elements of A in B instead of sorting both.
+    ia = __unique_index__ (a);
+    ia = ia(__ismember_index__ (a(ia), b) == 0);
+    c = a(ia);
+    if (! any (strcmp ("stable", varargin)))
+      [c, idx] = sort (c);
+      ia = ia(idx);
+    endif
+
+    ## Reshape if necessary for Matlab compatibility.
+    if (isrowvec)
+      c = c(:).';
+    else
+      c = c(:);
+    endif
   else
     if (nargout > 1)
       [c, ia] = unique (a, varargin{:});
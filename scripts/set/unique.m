@@ -84,8 +84,8 @@
 ## outputs @var{i}, @var{j} will follow the shape of the input @var{x} rather
 ## than always being column vectors.
 ##
-## The third output, @var{j}, has not been implemented yet when the sort
-## order is @qcode{"stable"}.
+## The third output, @var{j}, has not been implemented yet for
+## @qcode{"rows"} when the sort order is @qcode{"stable"}.
 ##
 ## @seealso{union, intersect, setdiff, setxor, ismember}
 ## @end deftypefn
@@ -186,6 +186,22 @@ function [y, i, j] = unique (x, varargin)
     return;
   endif
 
+  ## Unsorted and already sorted arrays are reduced without sorting.
+  if (! optrows && ishashableset (x) && (! optsorted || issorted (x(:))))
+    if (optlegacy || ! optfirst)
+      [i, j] = __unique_index__ (x, "last");
+    else
+      [i, j] = __unique_index__ (x);
+    endif
+    y = x(i);
+
+    if (optlegacy && isrowvec)
+      i = i.';
+      j = j.';
+    endif
+    return;
+  endif
+
   ## Calculate y output
   if (optrows)
     if (nargout > 1 || ! optsorted)
@@ -302,11 +318,10 @@ endfunction
 %! assert (j, [1;1;2;3;3;3;4]);
 
 %!test
-%! [y,i,~] = unique ([4,4,2,2,2,3,1], "stable");
+%! [y,i,j] = unique ([4,4,2,2,2,3,1], "stable");
 %! assert (y, [4,2,3,1]);
 %! assert (i, [1;3;6;7]);
-%! ## FIXME: 'j' input not calculated with stable
-%! ##assert (j, []);
+%! assert (j, [1;1;2;2;2;3;4]);
 
 %!test
 %! [y,i,j] = unique ([1,1,2,3,3,3,4]', "last");
@@ -322,9 +337,23 @@ endfunction
 %! assert (j, [1;1;1]);
 
 %!test
-%! [y,i,~] = unique ({"B"; "A"; "B"}, "stable");
+%! [y,i,j] = unique ({"B"; "A"; "B"}, "stable");
 %! assert (y, {"B"; "A"});
 %! assert (i, [1; 2]);
+%! assert (j, [1; 2; 1]);
+
+%!test
+%! x = randi (50, 200, 3);
+%! [y,i,j] = unique (x, "stable");
+%! [ys,is,js] = unique (x);
+%! assert (sort (y), ys);
+%! assert (x(i), y);
+%! assert (y(j), x(:));
+%! assert (unique (int16 (x), "stable"), int16 (y));
+%! [y,i,j] = unique (sort (x(:)), "last");
+%! assert (y, ys);
+%! assert (y(j), sort (x(:)));
+%! assert (all (diff (i) > 0) && i(end) == numel (x));
 
 %!test
 %! A = [1,2,3; 1,2,3];
@@ -377,5 +406,5 @@ endfunction
 %!error <invalid option> unique ({"a", "b", "c"}, "UnknownOption1", "last")
 %!warning <"rows" is ignored for cell arrays> unique ({"1"}, "rows");
 %!warning <third output J is not yet implemented>
-%! [y,i,j] = unique ([2,1], "stable");
+%! [y,i,j] = unique ([2;1], "rows", "stable");
 %! assert (j, []);
@@ -232,6 +232,27 @@ function y = movfun (fcn, x, wlen, varargin)
   ncols = prod (szx(dperm(2:end)));      # rest of dimensions as single column
   x     = reshape (x, N, ncols);         # reshape input
 
+  ## Common statistics of real floating point data are computed by a
+  ## compiled kernel that updates each window from the previous one.
+  kernel = movfun_kernel (fcn);
+  if (! isempty (kernel) && isempty (outdim) && isfloat (x) && isreal (x)
+      && ! issparse (x))
+    if (isnumeric (bc))
+      y = __movstat__ (kernel, x, -win(1), win(end), bc);
+    elseif (strcmpi (bc, "fill"))
+      y = __movstat__ (kernel, x, -win(1), win(end), NaN);
+    else
+      y = __movstat__ (kernel, x, -win(1), win(end), lower (bc));
+    endif
+    szx(dperm(1)) = rows (y);
+
+    ## Restore shape
+    y = reshape (y, szx(dperm));
+    y = permute (y, dperm);
+    y = squeeze (y);
+    return;
+  endif
+
   ## Obtain function for boundary conditions
   if (isnumeric (bc))
     bcfcn = @replaceval_bc;
@@ -299,6 +320,32 @@ function y = movfun (fcn, x, wlen, varargin)
 
 endfunction
 
+## Return the name of the __movstat__ kernel that computes FCN for each
+## window, or "" if there is none.
+function kernel = movfun_kernel (fcn)
+
+  kernel = "";
+
+  if (! is_function_handle (fcn))
+    return;
+  endif
+
+  name = func2str (fcn);
+  switch (name)
+    case {"sum", "mean", "var", "std", "min", "max", "median"}
+      kernel = name;
+
+    ## Functions used by movvar and movstd for normalization with N
+    case "@(x) var (x, 1)"
+      kernel = "var1";
+
+    case "@(x) std (x, 1)"
+      kernel = "std1";
+
+  endswitch
+
+endfunction
+
 function y = movfun_oncol (fcn, yclass, x, wlen, bcfcn, slcidx, C, Cpre, Cpos, win, odim)
 
   N = length (Cpre) + length (C) + length (Cpos);
@@ -594,6 +641,26 @@ endfunction
 %! y = x; y(1:2) = y([end end-1]) = [0.6;0.8];
 %! assert (movfun (@mean, x, 5, "Endpoints", 0), y);
 
+## Compiled kernels agree with applying the function to each window
+%!test
+%! x = [magic(6); NaN, 1:5; -Inf, 5:-1:1; 0.1 * (1:6)];
+%! fcns = {@sum, @mean, @var, @std, @min, @max, @median, ...
+%!         @(x) var (x, 1), @(x) std (x, 1)};
+%! gens = {@(x) sum (x), @(x) mean (x), @(x) var (x), @(x) std (x), ...
+%!         @(x) min (x), @(x) max (x), @(x) median (x), ...
+%!         @(x) var (x, 1) + 0, @(x) std (x, 1) + 0};
+%! for bc = {"shrink", "discard", "fill", "same", "periodic", 2}
+%!   for wlen = {3, 4, [0, 2], [3, 1], 7}
+%!     for i = 1:numel (fcns)
+%!       y = movfun (fcns{i}, x, wlen{1}, "Endpoints", bc{1});
+%!       y_gen = movfun (gens{i}, x, wlen{1}, "Endpoints", bc{1});
+%!       assert (y, y_gen, -10*eps);
+%!     endfor
+%!   endfor
+%! endfor
+%! assert (movfun (@max, single (x), 3, "dim", 2),
+%!         single (movfun (@(x) max (x), x, 3, "dim", 2)));
+
 ## Asymmetric windows
 %!shared x, wlen, wlen02, wlen20, ctrfun, UNO
 %! x = (1:10).' + [-3, 0, 4];
@@ -277,6 +277,17 @@ function m = median (x, varargin)
     return;
   endif
 
+  if (isscalar (dim) && isfloat (x) && isreal (x) && ! issparse (x))
+    ## Select the middle elements along DIM in compiled code instead of
+    ## permuting and sorting X.
+    m = __median__ (x, dim, omitnan);
+
+    if (! strcmp (class (m), outtype))
+      m = feval (outtype, m);
+    endif
+    return;
+  endif
+
   ## Permute dim to simplify all operations along dim1.  At func. end ipermute.
   if (numel (dim) > 1 || (dim != 1 && ! isvector (x)))
     perm = 1 : ndx;
@@ -276,6 +276,22 @@ function [v, m] = var (x, varargin)
     return;
   endif
 
+  if (! weighted && isfloat (x) && isreal (x) && ! x_issparse
+      && (vecempty || vecdim_scalar_vector(1)))
+    ## Compute the mean and variance of each column in compiled code.
+    if (all_flag)
+      x = x(:);
+      dim = 1;
+    elseif (vecempty)
+      ## Find the first non-singleton dimension.
+      (dim = find (szx > 1, 1)) || (dim = 1);
+    else
+      dim = vecdim;
+    endif
+    [v, m] = __var__ (x, w, dim, omitnan);
+    return;
+  endif
+
   if (nvarg == 0)
     ## Only numeric input argument, no dimensions or weights.
     if (all_flag)
@@ -37,6 +37,60 @@
 %! __printf_assert__ ("\n");
 %! assert (__prog_output_assert__ ("1234"));
 
+%!function [x, s, t] = __parfor_sum__ (n, nworkers)
+%!  parfor_max_workers (nworkers, "local");
+%!  x = zeros (2, n);
+%!  s = 1;
+%!  parfor (i = 1:n, nworkers)
+%!    t = i^2;
+%!    x(:,i) = [i; t];
+%!    s += t;
+%!  endparfor
+%!endfunction
+
+%!function s = __parfor_bsxfun__ (x, nworkers)
+%!  parfor_max_workers (nworkers, "local");
+%!  s = zeros (1, 4);
+%!  parfor (i = 1:4, nworkers)
+%!    y = x .* x(:,i);
+%!    s(i) = sum (y(:));
+%!  endparfor
+%!endfunction
+
+%!function r = __parfor_draw__ ()
+%!  r = rand ();
+%!endfunction
+
+%!function r = __parfor_rand__ (n, nworkers)
+%!  parfor_max_workers (nworkers, "local");
+%!  r = zeros (1, n);
+%!  parfor (i = 1:n, nworkers)
+%!    r(i) = __parfor_draw__ ();
+%!  endparfor
+%!endfunction
+
+%!test
+%! [x1, s1, t1] = __parfor_sum__ (10, 1);
+%! [x2, s2, t2] = __parfor_sum__ (10, 3);
+%! assert (x2, x1);
+%! assert (s2, s1);
+%! assert (t2, t1);
+%! assert (s2, 386);
+
+## Workers must not draw the same random numbers, also when rand is
+## called from another function
+%!test
+%! r = __parfor_rand__ (8, 2);
+%! assert (numel (unique (r)), 8);
+%! r = __parfor_rand__ (2, 2);
+%! assert (r(1) != r(2));
+
+## Workers must not wait for threads started by the parent
+%!test
+%! x = reshape (1:90000, 300, 300);
+%! y = x .* x(:,1);
+%! assert (__parfor_bsxfun__ (x, 2), __parfor_bsxfun__ (x, 1));
+
 %!test
 %! for i = [1,2,3,4]
 %!   __printf_assert__ ("%d", i);
@@ -130,6 +184,14 @@
 %! __printf_assert__ ("\n");
 %! assert (__prog_output_assert__ ("1234"));
 
+## The maxproc argument is ignored when parfor runs serially
+%!test
+%! s = 0;
+%! parfor (i = 1:4, -1)
+%!   s += i;
+%! endparfor
+%! assert (s, 10);
+
 %!test <*50893>
 %! cnt = 0;
 %! for k = zeros (0,3)
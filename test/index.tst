@@ -612,3 +612,20 @@
 %! c = cell (1,1,1);
 %! c{1,1,1} = zeros(5, 2);
 %! c{1,1,1}(:, 1) = 1;
+
+## Large gathers and scatters, which may be split across threads
+%!test
+%! x = (1:200000)';
+%! m = mod (x, 7) < 3;
+%! assert (x(m), find (m));
+%! y = zeros (size (x));
+%! y(m) = x(m);
+%! assert (y, x .* m);
+%! y(m) = -1;
+%! assert (nnz (y == -1), nnz (m));
+%! idx = randperm (numel (x));
+%! assert (x(idx), idx');
+%! A = reshape (1:300000, 300, 1000);
+%! r = [5, 1, 300, 17];
+%! assert (A(r,:), A(:,:)(r,:));
+%! assert (A(r,:)(:,999), (r + 299*300)');
@@ -202,6 +202,46 @@
 %! assert (save_status && load_status);
 %! clear -global a1;  # cleanup after test
 
+## Compressed MAT files with variables that are large enough to be
+## compressed in blocks and read back in several buffers.
+%!testif HAVE_ZLIB
+%! x = repmat (1:1000, 1, 1000);
+%! s.a = x;
+%! s.b = {"abc", int16(magic (4))};
+%! y = x;
+%! t = s;
+%! matfile = [tempname() ".mat"];
+%! unwind_protect
+%!   save ("-v7", matfile, "x", "s");
+%!   clear x s;
+%!   load (matfile);
+%!   assert (x, y);
+%!   assert (s, t);
+%! unwind_protect_cleanup
+%!   sts = unlink (matfile);
+%! end_unwind_protect
+
+## Load selected variables from MAT files, skipping the others
+%!testif HAVE_ZLIB
+%! a = magic (3);
+%! bb = {1, "two"};
+%! b = single (pi);
+%! s.x = 1:5;
+%! matfile = [tempname() ".mat"];
+%! unwind_protect
+%!   for opt = {"-v6", "-v7"}
+%!     save (opt{1}, matfile, "a", "bb", "b", "s");
+%!     r = load (matfile, "b*");
+%!     assert (fieldnames (r), {"bb"; "b"});
+%!     assert (r.bb, bb);
+%!     assert (r.b, b);
+%!     r = load (matfile, "s");
+%!     assert (r, struct ("s", s));
+%!   endfor
+%! unwind_protect_cleanup
+%!   sts = unlink (matfile);
+%! end_unwind_protect
+
 %!testif HAVE_HDF5
 %!
 %! s8  =   int8 (fix ((2^8  - 1) * (rand (2, 2) - 0.5)));
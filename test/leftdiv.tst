@@ -42,3 +42,22 @@
 %!warning <matrix singular to machine precision>
 %! warning ('on', 'Octave:singular-matrix', 'local');
 %! assert ([Inf, 0; 0, 0] \ single ([i; 1]), zeros (2,1, "single"));
+
+## Repeated solves with the same sparsity pattern reuse the symbolic
+## factorization; the results must follow the changing values.
+%!testif HAVE_UMFPACK
+%! reuse_sparse_symbolic_analysis (true, "local");
+%! n = 50;
+%! A = sprandn (n, n, 0.1) + speye (n);
+%! A(1,2) = 1;
+%! b = (1:n).';
+%! for k = 1:3
+%!   A = spfun (@(x) x + k, A);
+%!   x = A \ b;
+%!   assert (A*x, b, 1e-8 * norm (b) * condest (A));
+%!   xc = (1i*A) \ b;
+%!   assert ((1i*A)*xc, b, 1e-8 * norm (b) * condest (A));
+%! endfor
+%! B = A + sparse (n, 1, 1, n, n);
+%! x = B \ b;
+%! assert (B*x, b, 1e-8 * norm (b) * condest (B));
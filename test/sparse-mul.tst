@@ -0,0 +1,64 @@
+########################################################################
+##
+## Copyright (C) 2026 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+## Products large enough to be computed in several ranges must agree with
+## the full products.
+
+%!shared A, B, Ac, x, X
+%! A = sprandn (700, 600, 0.05);
+%! B = sprandn (600, 500, 0.05);
+%! Ac = A + 1i * sprandn (700, 600, 0.05);
+%! x = randn (600, 1);
+%! X = randn (600, 40);
+
+%!test
+%! C = A * B;
+%! assert (issparse (C));
+%! assert (full (C), full (A) * full (B), 1e-10);
+%! C = Ac * B;
+%! assert (full (C), full (Ac) * full (B), 1e-10);
+
+%!assert (A * x, full (A) * x, 1e-10)
+%!assert (A * X, full (A) * X, 1e-10)
+%!assert (Ac * X, full (Ac) * X, 1e-10)
+%!assert (A' * full (A(:,1:2)), full (A)' * full (A(:,1:2)), 1e-10)
+%!assert (Ac' * full (A(:,1:2)), full (Ac)' * full (A(:,1:2)), 1e-10)
+%!assert (X' * B, X' * full (B), 1e-10)
+%!test
+%! Y = randn (300, 600);
+%! assert (Y(:,1:500) * B', Y(:,1:500) * full (B)', 1e-10);
+%! assert (Y * Ac(1:500,:)', Y * full (Ac(1:500,:))', 1e-10);
+
+## A sparse matrix with many entries per row times a vector is split into
+## column blocks whose partial products are summed
+%!test
+%! S = sprand (400, 3000, 0.5);
+%! v = rand (3000, 1);
+%! assert (S * v, full (S) * v, 1e-10);
+%! assert (S * v(:,[1 1]), full (S) * v(:,[1 1]), 1e-10);
+
+## Products with no nonzero entries
+%!assert (nnz (sparse (50, 60) * sprand (60, 70, 0.1)), 0)
+%!assert (size (sparse (50, 60) * sprand (60, 70, 0.1)), [50, 70])